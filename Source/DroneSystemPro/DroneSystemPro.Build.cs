@@ -33,7 +33,10 @@ public class DroneSystemPro : ModuleRules
 				"GameplayTasks",
 				"NavigationSystem",
 				"NetCore",
-				"UMG"
+				"UMG",
+				"PhysicsCore",
+				"Chaos",
+				"ReplicationGraph"
 			}
 		);
 
@@ -31,6 +31,8 @@ void ADroneAIController::BeginPlay()
 	{
 		CurrentBehavior = BehaviorProfile->BehaviorType;
 	}
+
+	UpdateAltitudeHold();
 }
 
 void ADroneAIController::Tick(float DeltaTime)
@@ -72,7 +74,15 @@ void ADroneAIController::OnPossess(APawn* InPawn)
 	if (InPawn)
 	{
 		PatrolCenter = InPawn->GetActorLocation();
+
+		// AI steers blind towards its targets; let the obstacle field keep it off walls
+		if (UDroneMovementComponent* Movement = InPawn->FindComponentByClass<UDroneMovementComponent>())
+		{
+			Movement->SetObstacleAvoidanceEnabled(true);
+		}
 	}
+
+	UpdateAltitudeHold();
 }
 
 void ADroneAIController::SetBehaviorProfile(UDroneBehaviorProfile* NewProfile)
@@ -92,6 +102,18 @@ void ADroneAIController::SetBehaviorType(EDroneBehaviorType NewType)
 	// Reset state variables when switching behavior
 	CurrentPatrolIndex = 0;
 	ScanStartTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0f;
+
+	UpdateAltitudeHold();
+}
+
+void ADroneAIController::UpdateAltitudeHold()
+{
+	UDroneMovementComponent* Movement = GetPawn() ? GetPawn()->FindComponentByClass<UDroneMovementComponent>() : nullptr;
+	if (!Movement)
+		return;
+
+	const float PatrolAltitude = BehaviorProfile ? BehaviorProfile->PatrolAltitude : 0.0f;
+	Movement->SetAltitudeHold(CurrentBehavior == EDroneBehaviorType::Patrol && PatrolAltitude > 0.0f, PatrolAltitude);
 }
 
 void ADroneAIController::SetFollowTarget(AActor* Target)
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneActorChannel.h"
+#include "DroneReplicationComponent.h"
+#include "Net/DataBunch.h"
+
+FPacketIdRange UDroneActorChannel::SendBunch(FOutBunch* Bunch, bool Merge)
+{
+	if (ResolvedActor.Get() != Actor)
+	{
+		ResolvedActor = Actor;
+		Replication = Actor ? Actor->FindComponentByClass<UDroneReplicationComponent>() : nullptr;
+	}
+
+	// Payload only; packet and bunch headers are shared with other channels
+	if (Bunch && Connection)
+	{
+		if (UDroneReplicationComponent* ReplicationComponent = Replication.Get())
+		{
+			ReplicationComponent->RecordBytesSent(Connection, static_cast<int32>((Bunch->GetNumBits() + 7) >> 3));
+		}
+	}
+
+	return Super::SendBunch(Bunch, Merge);
+}
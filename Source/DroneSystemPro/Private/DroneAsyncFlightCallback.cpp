@@ -0,0 +1,44 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneAsyncFlightCallback.h"
+
+void FDroneAsyncFlightCallback::OnPreSimulate_Internal()
+{
+	if (const FDroneAsyncFlightInput* Input = GetConsumerInput_Internal())
+	{
+		for (const uint32 DroneID : Input->RemovedDrones)
+		{
+			Drones.Remove(DroneID);
+		}
+
+		for (const FDroneAsyncDroneInput& DroneInput : Input->Drones)
+		{
+			FSimulatedDrone& Drone = Drones.FindOrAdd(DroneInput.DroneID);
+			Drone.Input = DroneInput.Input;
+			Drone.Config = DroneInput.Config;
+
+			if (DroneInput.StateSequence != Drone.StateSequence)
+			{
+				Drone.State = DroneInput.State;
+				Drone.StateSequence = DroneInput.StateSequence;
+			}
+		}
+	}
+
+	// Fixed solver step: the same inputs always produce the same states
+	const float DeltaTime = static_cast<float>(GetDeltaTime_Internal());
+
+	FDroneAsyncFlightOutput& Output = GetProducerOutputData_Internal();
+	Output.Drones.Reserve(Drones.Num());
+
+	for (TPair<uint32, FSimulatedDrone>& Pair : Drones)
+	{
+		FSimulatedDrone& Drone = Pair.Value;
+		FDroneFlightModel::Simulate(Drone.State, Drone.Input, Drone.Config, DeltaTime);
+
+		FDroneAsyncDroneOutput& DroneOutput = Output.Drones.AddDefaulted_GetRef();
+		DroneOutput.DroneID = Pair.Key;
+		DroneOutput.State = Drone.State;
+		DroneOutput.StateSequence = Drone.StateSequence;
+	}
+}
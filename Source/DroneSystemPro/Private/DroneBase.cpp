@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DroneBase.h"
+#include "DronePushModel.h"
 #include "DroneMovementComponent.h"
 #include "DroneBatteryComponent.h"
 #include "DroneVisionComponent.h"
@@ -11,6 +12,7 @@
 #include "Camera/CameraComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Components/StaticMeshComponent.h"
+#include "Components/SphereComponent.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/World.h"
 
@@ -25,15 +27,22 @@ ADroneBase::ADroneBase()
 	LastMovementInput = FVector::ZeroVector;
 	ControlRotationInput = FVector::ZeroVector;
 
-	// Create mesh component
+	// Create collision root
+	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComponent"));
+	CollisionComponent->InitSphereRadius(40.0f);
+	CollisionComponent->SetCollisionProfileName(TEXT("Pawn"));
+	CollisionComponent->SetSimulatePhysics(false);
+	RootComponent = CollisionComponent;
+
+	// Create mesh component (visual only, offset by movement smoothing)
 	DroneMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("DroneMesh"));
-	RootComponent = DroneMesh;
-	DroneMesh->SetCollisionProfileName(TEXT("Pawn"));
+	DroneMesh->SetupAttachment(RootComponent);
+	DroneMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	DroneMesh->SetSimulatePhysics(false);
 
-	// Create camera arm
+	// Create camera arm (follows the smoothed mesh)
 	CameraArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraArm"));
-	CameraArm->SetupAttachment(RootComponent);
+	CameraArm->SetupAttachment(DroneMesh);
 	CameraArm->TargetArmLength = 300.0f;
 	CameraArm->bUsePawnControlRotation = false;
 	CameraArm->bInheritPitch = true;
@@ -46,6 +55,7 @@ ADroneBase::ADroneBase()
 
 	// Create drone components
 	DroneMovement = CreateDefaultSubobject<UDroneMovementComponent>(TEXT("DroneMovement"));
+	DroneMovement->SetVisualComponent(DroneMesh);
 	DroneBattery = CreateDefaultSubobject<UDroneBatteryComponent>(TEXT("DroneBattery"));
 	DroneVision = CreateDefaultSubobject<UDroneVisionComponent>(TEXT("DroneVision"));
 	DroneMarking = CreateDefaultSubobject<UDroneMarkingComponent>(TEXT("DroneMarking"));
@@ -81,7 +91,10 @@ void ADroneBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifeti
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ADroneBase, bIsActive);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ADroneBase, bIsActive, Params);
 }
 
 void ADroneBase::PossessedBy(AController* NewController)
@@ -95,6 +108,29 @@ void ADroneBase::PossessedBy(AController* NewController)
 	}
 }
 
+bool ADroneBase::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	if (!DroneReplication)
+		return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+
+	if (bAlwaysRelevant || RealViewer == Controller || IsOwnedBy(ViewTarget) || IsOwnedBy(RealViewer) || this == ViewTarget || ViewTarget == GetInstigator())
+		return true;
+
+	if ((IsHidden() || bOnlyRelevantToOwner) && (!RootComponent || !RootComponent->IsCollisionEnabled()))
+		return false;
+
+	return DroneReplication->IsRelevantAtDistance(FVector::DistSquared(SrcLocation, GetActorLocation()), RealViewer);
+}
+
+float ADroneBase::GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth)
+{
+	if (!DroneReplication || this == ViewTarget || (ViewTarget && GetInstigator() == ViewTarget))
+		return Super::GetNetPriority(ViewPos, ViewDir, Viewer, ViewTarget, InChannel, Time, bLowBandwidth);
+
+	// Time since the last update still grows, so drones weighted down are delayed, not starved
+	return NetPriority * Time * DroneReplication->GetViewerPriorityScale(ViewPos, ViewDir, Viewer);
+}
+
 void ADroneBase::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -166,12 +202,13 @@ void ADroneBase::SetDroneConfig(UDroneConfig* NewConfig)
 void ADroneBase::SetActive(bool bNewActive)
 {
 	bIsActive = bNewActive;
+	DRONE_MARK_PROPERTY_DIRTY(ADroneBase, bIsActive, this);
 
 	if (HasAuthority())
 	{
 		// Disable components when inactive
 		if (DroneMovement)
-			DroneMovement->SetComponentTickEnabled(bNewActive);
+			DroneMovement->SetSimulationEnabled(bNewActive);
 		if (DroneBattery && !bNewActive)
 			DroneBattery->StopDrain();
 	}
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DroneBatteryComponent.h"
+#include "DronePushModel.h"
 #include "Net/UnrealNetwork.h"
 #include "GameFramework/Actor.h"
 #include "Engine/World.h"
@@ -27,6 +28,7 @@ void UDroneBatteryComponent::BeginPlay()
 	if (DroneConfig)
 	{
 		BatteryLevel = DroneConfig->MaxBattery;
+		DRONE_MARK_PROPERTY_DIRTY(UDroneBatteryComponent, BatteryLevel, this);
 	}
 }
 
@@ -34,8 +36,11 @@ void UDroneBatteryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UDroneBatteryComponent, BatteryLevel);
-	DOREPLIFETIME(UDroneBatteryComponent, bIsRecharging);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDroneBatteryComponent, BatteryLevel, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDroneBatteryComponent, bIsRecharging, Params);
 }
 
 void UDroneBatteryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -54,6 +59,7 @@ void UDroneBatteryComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 
 		if (BatteryLevel != OldLevel)
 		{
+			MarkContinuousLevelChange(OldLevel);
 			OnBatteryChanged.Broadcast(BatteryLevel);
 		}
 
@@ -87,6 +93,7 @@ void UDroneBatteryComponent::SetBatteryLevel(float NewLevel)
 
 	if (BatteryLevel != OldLevel)
 	{
+		DRONE_MARK_PROPERTY_DIRTY(UDroneBatteryComponent, BatteryLevel, this);
 		OnBatteryChanged.Broadcast(BatteryLevel);
 
 		if (BatteryLevel <= 0.0f && !bWasDepleted)
@@ -111,6 +118,7 @@ void UDroneBatteryComponent::StartRecharging()
 		return;
 
 	bIsRecharging = true;
+	DRONE_MARK_PROPERTY_DIRTY(UDroneBatteryComponent, bIsRecharging, this);
 	bIsDraining = false;
 }
 
@@ -121,6 +129,7 @@ void UDroneBatteryComponent::StopRecharging()
 
 	bIsRecharging = false;
 	bIsDraining = true;
+	DRONE_MARK_PROPERTY_DIRTY(UDroneBatteryComponent, bIsRecharging, this);
 }
 
 void UDroneBatteryComponent::StartDrain()
@@ -160,6 +169,7 @@ void UDroneBatteryComponent::SetDroneConfig(UDroneConfig* NewConfig)
 	if (DroneConfig && BatteryLevel > DroneConfig->MaxBattery)
 	{
 		BatteryLevel = DroneConfig->MaxBattery;
+		DRONE_MARK_PROPERTY_DIRTY(UDroneBatteryComponent, BatteryLevel, this);
 	}
 }
 
@@ -197,6 +207,7 @@ void UDroneBatteryComponent::CalculateAndApplyDrain(float DeltaTime)
 
 	if (BatteryLevel != OldLevel)
 	{
+		MarkContinuousLevelChange(OldLevel);
 		OnBatteryChanged.Broadcast(BatteryLevel);
 	}
 
@@ -259,3 +270,14 @@ float UDroneBatteryComponent::GetMaxBattery() const
 {
 	return DroneConfig ? DroneConfig->MaxBattery : 100.0f;
 }
+
+void UDroneBatteryComponent::MarkContinuousLevelChange(float OldLevel)
+{
+	DRONE_MARK_PROPERTY_DIRTY_NO_WAKE(UDroneBatteryComponent, BatteryLevel, this);
+
+	const float MaxBattery = GetMaxBattery();
+	if (MaxBattery > 0.0f && FMath::FloorToInt(OldLevel * 10.0f / MaxBattery) != FMath::FloorToInt(BatteryLevel * 10.0f / MaxBattery))
+	{
+		FDroneNetDormancy::NotifyPropertyDirty(this);
+	}
+}
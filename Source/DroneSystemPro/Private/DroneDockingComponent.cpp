@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DroneDockingComponent.h"
+#include "DronePushModel.h"
 #include "DroneBase.h"
 #include "DroneBatteryComponent.h"
 #include "DroneAIController.h"
@@ -29,7 +30,10 @@ void UDroneDockingComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UDroneDockingComponent, DockedDrone);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDroneDockingComponent, DockedDrone, Params);
 }
 
 void UDroneDockingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -61,6 +65,7 @@ bool UDroneDockingComponent::DockDrone(ADroneBase* Drone)
 	if (GetOwner() && GetOwner()->HasAuthority())
 	{
 		DockedDrone = Drone;
+		DRONE_MARK_PROPERTY_DIRTY(UDroneDockingComponent, DockedDrone, this);
 
 		// Position drone at docking station
 		FVector DockLocation = GetOwner()->GetActorLocation() + DockingOffset;
@@ -106,6 +111,7 @@ void UDroneDockingComponent::UndockDrone()
 		Drone->SetActive(true);
 
 		DockedDrone = nullptr;
+		DRONE_MARK_PROPERTY_DIRTY(UDroneDockingComponent, DockedDrone, this);
 
 		Multicast_DroneUndocked(Drone);
 	}
@@ -0,0 +1,306 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneFlightBatch.h"
+#include "Math/VectorRegister.h"
+
+namespace DroneFlightBatchPrivate
+{
+	template<typename FunctionType>
+	void ForEachLaneArray(FDroneFlightBatch& Batch, FunctionType&& Function)
+	{
+		FDroneFlightBatch::FLaneArray* Lanes[] =
+		{
+			&Batch.DisplacementX, &Batch.DisplacementY, &Batch.DisplacementZ,
+			&Batch.VelocityX, &Batch.VelocityY, &Batch.VelocityZ,
+			&Batch.Yaw, &Batch.Pitch, &Batch.Roll,
+			&Batch.MoveX, &Batch.MoveY, &Batch.MoveZ,
+			&Batch.LookX, &Batch.LookY,
+			&Batch.WindX, &Batch.WindY, &Batch.WindZ,
+			&Batch.MaxSpeed, &Batch.Acceleration, &Batch.Deceleration, &Batch.TurnRate,
+			&Batch.MaxPitchAngle, &Batch.MaxRollAngle, &Batch.RollInterpSpeed
+		};
+
+		for (FDroneFlightBatch::FLaneArray* LaneArray : Lanes)
+		{
+			Function(*LaneArray);
+		}
+	}
+
+	FORCEINLINE VectorRegister4Float Load(const FDroneFlightBatch::FLaneArray& Lanes, int32 Index)
+	{
+		return VectorLoadAligned(Lanes.GetData() + Index);
+	}
+
+	FORCEINLINE void Store(FDroneFlightBatch::FLaneArray& Lanes, int32 Index, const VectorRegister4Float& Value)
+	{
+		VectorStoreAligned(Value, Lanes.GetData() + Index);
+	}
+
+	FORCEINLINE VectorRegister4Float Clamp(const VectorRegister4Float& Value, const VectorRegister4Float& Min, const VectorRegister4Float& Max)
+	{
+		return VectorMin(VectorMax(Value, Min), Max);
+	}
+
+	FORCEINLINE VectorRegister4Float MaxAbs3(const VectorRegister4Float& X, const VectorRegister4Float& Y, const VectorRegister4Float& Z)
+	{
+		return VectorMax(VectorMax(VectorAbs(X), VectorAbs(Y)), VectorAbs(Z));
+	}
+}
+
+void FDroneFlightBatch::SetNum(int32 InNumDrones)
+{
+	NumDrones = FMath::Max(InNumDrones, 0);
+	const int32 Padded = Align(NumDrones, LaneWidth);
+
+	Origins.SetNum(NumDrones);
+
+	DroneFlightBatchPrivate::ForEachLaneArray(*this, [this, Padded](FLaneArray& Lanes)
+	{
+		Lanes.SetNumUninitialized(Padded);
+
+		// Zeroed padding lanes integrate to zero without producing NaNs
+		for (int32 Index = NumDrones; Index < Padded; ++Index)
+		{
+			Lanes[Index] = 0.0f;
+		}
+	});
+}
+
+void FDroneFlightBatch::SetDrone(int32 Index, const FDroneFlightState& State, const FDroneFlightInput& Input, const FDroneFlightConfig& Config)
+{
+	check(Index >= 0 && Index < NumDrones);
+
+	Origins[Index] = State.Location;
+	DisplacementX[Index] = 0.0f;
+	DisplacementY[Index] = 0.0f;
+	DisplacementZ[Index] = 0.0f;
+
+	VelocityX[Index] = State.Velocity.X;
+	VelocityY[Index] = State.Velocity.Y;
+	VelocityZ[Index] = State.Velocity.Z;
+	Yaw[Index] = State.Rotation.Yaw;
+	Pitch[Index] = State.Rotation.Pitch;
+	Roll[Index] = State.Rotation.Roll;
+
+	MoveX[Index] = Input.MovementInput.X;
+	MoveY[Index] = Input.MovementInput.Y;
+	MoveZ[Index] = Input.MovementInput.Z;
+	LookX[Index] = Input.LookInput.X;
+	LookY[Index] = Input.LookInput.Y;
+
+	// Avoidance is evaluated once per frame here rather than per substep
+	const FVector WindAcceleration = Input.WindVelocity * Config.WindResponse + FDroneFlightModel::CalculateAvoidance(State.Velocity, Input, Config);
+	WindX[Index] = WindAcceleration.X;
+	WindY[Index] = WindAcceleration.Y;
+	WindZ[Index] = WindAcceleration.Z;
+
+	MaxSpeed[Index] = Config.GetMaxSpeed(Input.SpeedMode);
+	Acceleration[Index] = Config.Acceleration;
+	Deceleration[Index] = Config.Deceleration;
+	TurnRate[Index] = Config.TurnRate;
+	MaxPitchAngle[Index] = Config.MaxPitchAngle;
+	MaxRollAngle[Index] = Config.MaxRollAngle;
+	RollInterpSpeed[Index] = Config.RollInterpSpeed;
+}
+
+FDroneFlightState FDroneFlightBatch::GetState(int32 Index) const
+{
+	check(Index >= 0 && Index < NumDrones);
+
+	return FDroneFlightState(
+		Origins[Index] + FVector(DisplacementX[Index], DisplacementY[Index], DisplacementZ[Index]),
+		FRotator(Pitch[Index], Yaw[Index], Roll[Index]),
+		FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]));
+}
+
+void FDroneFlightBatchKernel::StepVectorized(FDroneFlightBatch& Batch, int32 StartIndex, int32 EndIndex, float DeltaTime)
+{
+	using namespace DroneFlightBatchPrivate;
+
+	check(StartIndex % FDroneFlightBatch::LaneWidth == 0 && EndIndex % FDroneFlightBatch::LaneWidth == 0);
+	check(EndIndex <= Batch.NumPadded());
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+	const VectorRegister4Float Dt = VectorSetFloat1(DeltaTime);
+	const VectorRegister4Float DegToRad = VectorSetFloat1(PI / 180.0f);
+	const VectorRegister4Float NearlyZero = VectorSetFloat1(KINDA_SMALL_NUMBER);
+	const VectorRegister4Float Tiny = VectorSetFloat1(SMALL_NUMBER);
+
+	for (int32 Index = StartIndex; Index < EndIndex; Index += FDroneFlightBatch::LaneWidth)
+	{
+		const VectorRegister4Float Yaw = Load(Batch.Yaw, Index);
+		const VectorRegister4Float Pitch = Load(Batch.Pitch, Index);
+		const VectorRegister4Float Roll = Load(Batch.Roll, Index);
+		const VectorRegister4Float MoveX = Load(Batch.MoveX, Index);
+		const VectorRegister4Float MoveY = Load(Batch.MoveY, Index);
+		const VectorRegister4Float MoveZ = Load(Batch.MoveZ, Index);
+		const VectorRegister4Float MaxSpeed = Load(Batch.MaxSpeed, Index);
+
+		// Heading basis from yaw/pitch; roll is cosmetic
+		VectorRegister4Float SinPitch, CosPitch, SinYaw, CosYaw;
+		const VectorRegister4Float PitchRadians = VectorMultiply(Pitch, DegToRad);
+		const VectorRegister4Float YawRadians = VectorMultiply(Yaw, DegToRad);
+		VectorSinCos(&SinPitch, &CosPitch, &PitchRadians);
+		VectorSinCos(&SinYaw, &CosYaw, &YawRadians);
+
+		// Forward * X + Right * Y + Up * Z
+		const VectorRegister4Float ForwardX = VectorMultiply(CosPitch, CosYaw);
+		const VectorRegister4Float ForwardY = VectorMultiply(CosPitch, SinYaw);
+		VectorRegister4Float DesiredX = VectorSubtract(VectorMultiply(ForwardX, MoveX), VectorMultiply(SinYaw, MoveY));
+		VectorRegister4Float DesiredY = VectorMultiplyAdd(CosYaw, MoveY, VectorMultiply(ForwardY, MoveX));
+		VectorRegister4Float DesiredZ = VectorMultiplyAdd(SinPitch, MoveX, MoveZ);
+
+		// Clamp input to unit length, then scale to top speed
+		const VectorRegister4Float InputSizeSquared = VectorMultiplyAdd(DesiredX, DesiredX, VectorMultiplyAdd(DesiredY, DesiredY, VectorMultiply(DesiredZ, DesiredZ)));
+		const VectorRegister4Float DesiredScale = VectorMultiply(VectorMin(One, VectorReciprocalSqrt(VectorMax(InputSizeSquared, Tiny))), MaxSpeed);
+		DesiredX = VectorMultiply(DesiredX, DesiredScale);
+		DesiredY = VectorMultiply(DesiredY, DesiredScale);
+		DesiredZ = VectorMultiply(DesiredZ, DesiredScale);
+
+		// Accelerate towards input, decelerate when released
+		const VectorRegister4Float bDesiredIsZero = VectorCompareLE(MaxAbs3(DesiredX, DesiredY, DesiredZ), NearlyZero);
+		const VectorRegister4Float AccelRate = VectorSelect(bDesiredIsZero, Load(Batch.Deceleration, Index), Load(Batch.Acceleration, Index));
+		const VectorRegister4Float bHasMaxSpeed = VectorCompareGT(MaxSpeed, NearlyZero);
+		const VectorRegister4Float Alpha = VectorSelect(bHasMaxSpeed,
+			Clamp(VectorDivide(VectorMultiply(Dt, AccelRate), VectorMax(MaxSpeed, NearlyZero)), Zero, One),
+			One);
+
+		VectorRegister4Float VelocityX = Load(Batch.VelocityX, Index);
+		VectorRegister4Float VelocityY = Load(Batch.VelocityY, Index);
+		VectorRegister4Float VelocityZ = Load(Batch.VelocityZ, Index);
+		VelocityX = VectorMultiplyAdd(VectorSubtract(DesiredX, VelocityX), Alpha, VelocityX);
+		VelocityY = VectorMultiplyAdd(VectorSubtract(DesiredY, VelocityY), Alpha, VelocityY);
+		VelocityZ = VectorMultiplyAdd(VectorSubtract(DesiredZ, VelocityZ), Alpha, VelocityZ);
+
+		// Clamp to top speed; a zero top speed stops the drone
+		const VectorRegister4Float SpeedSquared = VectorMultiplyAdd(VelocityX, VelocityX, VectorMultiplyAdd(VelocityY, VelocityY, VectorMultiply(VelocityZ, VelocityZ)));
+		const VectorRegister4Float SpeedScale = VectorSelect(VectorCompareGE(MaxSpeed, NearlyZero),
+			VectorMin(One, VectorMultiply(MaxSpeed, VectorReciprocalSqrt(VectorMax(SpeedSquared, Tiny)))),
+			Zero);
+		VelocityX = VectorMultiply(VelocityX, SpeedScale);
+		VelocityY = VectorMultiply(VelocityY, SpeedScale);
+		VelocityZ = VectorMultiply(VelocityZ, SpeedScale);
+
+		// Wind force after the clamp
+		VelocityX = VectorMultiplyAdd(Load(Batch.WindX, Index), Dt, VelocityX);
+		VelocityY = VectorMultiplyAdd(Load(Batch.WindY, Index), Dt, VelocityY);
+		VelocityZ = VectorMultiplyAdd(Load(Batch.WindZ, Index), Dt, VelocityZ);
+
+		Store(Batch.VelocityX, Index, VelocityX);
+		Store(Batch.VelocityY, Index, VelocityY);
+		Store(Batch.VelocityZ, Index, VelocityZ);
+		Store(Batch.DisplacementX, Index, VectorMultiplyAdd(VelocityX, Dt, Load(Batch.DisplacementX, Index)));
+		Store(Batch.DisplacementY, Index, VectorMultiplyAdd(VelocityY, Dt, Load(Batch.DisplacementY, Index)));
+		Store(Batch.DisplacementZ, Index, VectorMultiplyAdd(VelocityZ, Dt, Load(Batch.DisplacementZ, Index)));
+
+		// Yaw and pitch from look input
+		const VectorRegister4Float LookX = Load(Batch.LookX, Index);
+		const VectorRegister4Float LookY = Load(Batch.LookY, Index);
+		const VectorRegister4Float bHasLook = VectorCompareGT(VectorMax(VectorAbs(LookX), VectorAbs(LookY)), NearlyZero);
+		const VectorRegister4Float TurnStep = VectorMultiply(Load(Batch.TurnRate, Index), Dt);
+		const VectorRegister4Float MaxPitch = Load(Batch.MaxPitchAngle, Index);
+		const VectorRegister4Float NewYaw = VectorMultiplyAdd(LookX, TurnStep, Yaw);
+		const VectorRegister4Float NewPitch = Clamp(VectorMultiplyAdd(LookY, TurnStep, Pitch), VectorNegate(MaxPitch), MaxPitch);
+		Store(Batch.Yaw, Index, VectorSelect(bHasLook, NewYaw, Yaw));
+		Store(Batch.Pitch, Index, VectorSelect(bHasLook, NewPitch, Pitch));
+
+		// Roll eases towards the banking angle (FInterpTo)
+		const VectorRegister4Float bHasMove = VectorCompareGT(MaxAbs3(MoveX, MoveY, MoveZ), NearlyZero);
+		const VectorRegister4Float TargetRoll = VectorSelect(bHasMove, VectorMultiply(MoveY, Load(Batch.MaxRollAngle, Index)), Zero);
+		const VectorRegister4Float RollSpeed = Load(Batch.RollInterpSpeed, Index);
+		const VectorRegister4Float RollDistance = VectorSubtract(TargetRoll, Roll);
+		const VectorRegister4Float NewRoll = VectorMultiplyAdd(RollDistance, Clamp(VectorMultiply(Dt, RollSpeed), Zero, One), Roll);
+		const VectorRegister4Float bSnapRoll = VectorBitwiseOr(
+			VectorCompareLE(RollSpeed, Zero),
+			VectorCompareLT(VectorMultiply(RollDistance, RollDistance), Tiny));
+		Store(Batch.Roll, Index, VectorSelect(bSnapRoll, TargetRoll, NewRoll));
+	}
+}
+
+void FDroneFlightBatchKernel::StepScalar(FDroneFlightBatch& Batch, int32 StartIndex, int32 EndIndex, float DeltaTime)
+{
+	check(EndIndex <= Batch.NumPadded());
+
+	for (int32 Index = StartIndex; Index < EndIndex; ++Index)
+	{
+		const float Yaw = Batch.Yaw[Index];
+		const float Pitch = Batch.Pitch[Index];
+		const float Roll = Batch.Roll[Index];
+		const float MoveX = Batch.MoveX[Index];
+		const float MoveY = Batch.MoveY[Index];
+		const float MoveZ = Batch.MoveZ[Index];
+		const float MaxSpeed = Batch.MaxSpeed[Index];
+
+		float SinPitch, CosPitch, SinYaw, CosYaw;
+		FMath::SinCos(&SinPitch, &CosPitch, FMath::DegreesToRadians(Pitch));
+		FMath::SinCos(&SinYaw, &CosYaw, FMath::DegreesToRadians(Yaw));
+
+		float DesiredX = CosPitch * CosYaw * MoveX - SinYaw * MoveY;
+		float DesiredY = CosPitch * SinYaw * MoveX + CosYaw * MoveY;
+		float DesiredZ = SinPitch * MoveX + MoveZ;
+
+		const float InputSizeSquared = DesiredX * DesiredX + DesiredY * DesiredY + DesiredZ * DesiredZ;
+		const float DesiredScale = FMath::Min(1.0f, FMath::InvSqrt(FMath::Max(InputSizeSquared, SMALL_NUMBER))) * MaxSpeed;
+		DesiredX *= DesiredScale;
+		DesiredY *= DesiredScale;
+		DesiredZ *= DesiredScale;
+
+		const bool bDesiredIsZero = FMath::Max3(FMath::Abs(DesiredX), FMath::Abs(DesiredY), FMath::Abs(DesiredZ)) <= KINDA_SMALL_NUMBER;
+		const float AccelRate = bDesiredIsZero ? Batch.Deceleration[Index] : Batch.Acceleration[Index];
+		const float Alpha = (MaxSpeed > KINDA_SMALL_NUMBER) ? FMath::Clamp(DeltaTime * AccelRate / MaxSpeed, 0.0f, 1.0f) : 1.0f;
+
+		float VelocityX = Batch.VelocityX[Index] + (DesiredX - Batch.VelocityX[Index]) * Alpha;
+		float VelocityY = Batch.VelocityY[Index] + (DesiredY - Batch.VelocityY[Index]) * Alpha;
+		float VelocityZ = Batch.VelocityZ[Index] + (DesiredZ - Batch.VelocityZ[Index]) * Alpha;
+
+		const float SpeedSquared = VelocityX * VelocityX + VelocityY * VelocityY + VelocityZ * VelocityZ;
+		const float SpeedScale = (MaxSpeed >= KINDA_SMALL_NUMBER) ? FMath::Min(1.0f, MaxSpeed * FMath::InvSqrt(FMath::Max(SpeedSquared, SMALL_NUMBER))) : 0.0f;
+		VelocityX = VelocityX * SpeedScale + Batch.WindX[Index] * DeltaTime;
+		VelocityY = VelocityY * SpeedScale + Batch.WindY[Index] * DeltaTime;
+		VelocityZ = VelocityZ * SpeedScale + Batch.WindZ[Index] * DeltaTime;
+
+		Batch.VelocityX[Index] = VelocityX;
+		Batch.VelocityY[Index] = VelocityY;
+		Batch.VelocityZ[Index] = VelocityZ;
+		Batch.DisplacementX[Index] += VelocityX * DeltaTime;
+		Batch.DisplacementY[Index] += VelocityY * DeltaTime;
+		Batch.DisplacementZ[Index] += VelocityZ * DeltaTime;
+
+		const float LookX = Batch.LookX[Index];
+		const float LookY = Batch.LookY[Index];
+		if (FMath::Max(FMath::Abs(LookX), FMath::Abs(LookY)) > KINDA_SMALL_NUMBER)
+		{
+			const float TurnStep = Batch.TurnRate[Index] * DeltaTime;
+			Batch.Yaw[Index] = Yaw + LookX * TurnStep;
+			Batch.Pitch[Index] = FMath::Clamp(Pitch + LookY * TurnStep, -Batch.MaxPitchAngle[Index], Batch.MaxPitchAngle[Index]);
+		}
+
+		const bool bHasMove = FMath::Max3(FMath::Abs(MoveX), FMath::Abs(MoveY), FMath::Abs(MoveZ)) > KINDA_SMALL_NUMBER;
+		const float TargetRoll = bHasMove ? MoveY * Batch.MaxRollAngle[Index] : 0.0f;
+		Batch.Roll[Index] = FMath::FInterpTo(Roll, TargetRoll, DeltaTime, Batch.RollInterpSpeed[Index]);
+	}
+}
+
+int32 FDroneFlightBatchKernel::Simulate(FDroneFlightBatch& Batch, int32 StartIndex, int32 EndIndex, float DeltaTime, float MaxSubstepDeltaTime, int32 MaxSubsteps, bool bVectorized)
+{
+	if (DeltaTime <= 0.0f || StartIndex >= EndIndex)
+		return 0;
+
+	const int32 NumSteps = FDroneFlightModel::GetNumSubsteps(DeltaTime, MaxSubstepDeltaTime, MaxSubsteps);
+	const float StepDelta = DeltaTime / NumSteps;
+
+	for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+	{
+		if (bVectorized)
+		{
+			StepVectorized(Batch, StartIndex, EndIndex, StepDelta);
+		}
+		else
+		{
+			StepScalar(Batch, StartIndex, EndIndex, StepDelta);
+		}
+	}
+
+	return NumSteps;
+}
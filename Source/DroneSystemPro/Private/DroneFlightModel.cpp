@@ -0,0 +1,159 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneFlightModel.h"
+
+FDroneFlightConfig FDroneFlightConfig::FromDroneConfig(const UDroneConfig* Config)
+{
+	FDroneFlightConfig Result;
+
+	if (!Config)
+		return Result;
+
+	Result.MaxSpeedLow = Config->MaxSpeedLow;
+	Result.MaxSpeedHigh = Config->MaxSpeedHigh;
+	Result.Acceleration = Config->Acceleration;
+	Result.Deceleration = Config->Deceleration;
+	Result.TurnRate = Config->TurnRate;
+	Result.MaxPitchAngle = Config->MaxPitchAngle;
+	Result.MaxRollAngle = Config->MaxRollAngle;
+	Result.WindResponse = Config->WindResponse;
+	Result.AvoidanceDistance = Config->ObstacleAvoidanceDistance;
+	Result.AvoidanceAcceleration = Config->ObstacleAvoidanceAcceleration;
+
+	return Result;
+}
+
+void FDroneFlightModel::Step(FDroneFlightState& State, const FDroneFlightInput& Input, const FDroneFlightConfig& Config, float DeltaTime)
+{
+	const float MaxSpeed = Config.GetMaxSpeed(Input.SpeedMode);
+	const FVector DesiredVelocity = CalculateDesiredVelocity(State.Rotation, Input.MovementInput, MaxSpeed);
+
+	// Accelerate towards input, decelerate when released
+	const float AccelRate = DesiredVelocity.IsNearlyZero() ? Config.Deceleration : Config.Acceleration;
+	const float Alpha = (MaxSpeed > KINDA_SMALL_NUMBER) ? FMath::Clamp(DeltaTime * AccelRate / MaxSpeed, 0.0f, 1.0f) : 1.0f;
+
+	State.Velocity = FMath::Lerp(State.Velocity, DesiredVelocity, Alpha).GetClampedToMaxSize(MaxSpeed);
+
+	// Wind pushes as a force; steering fights it, leaving a steady drift
+	State.Velocity += Input.WindVelocity * (Config.WindResponse * DeltaTime);
+	State.Velocity += CalculateAvoidance(State.Velocity, Input, Config) * DeltaTime;
+	State.Location += State.Velocity * DeltaTime;
+	State.Rotation = CalculateRotation(State.Rotation, Input, Config, DeltaTime);
+}
+
+int32 FDroneFlightModel::Simulate(FDroneFlightState& State, const FDroneFlightInput& Input, const FDroneFlightConfig& Config, float DeltaTime)
+{
+	if (DeltaTime <= 0.0f)
+		return 0;
+
+	const int32 NumSteps = GetNumSubsteps(DeltaTime, Config.MaxSubstepDeltaTime, Config.MaxSubsteps);
+	const float StepDelta = DeltaTime / NumSteps;
+
+	for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+	{
+		Step(State, Input, Config, StepDelta);
+	}
+
+	return NumSteps;
+}
+
+int32 FDroneFlightModel::GetNumSubsteps(float DeltaTime, float MaxSubstepDeltaTime, int32 MaxSubsteps)
+{
+	const float MaxStep = FMath::Max(MaxSubstepDeltaTime, KINDA_SMALL_NUMBER);
+	return FMath::Clamp(FMath::CeilToInt(DeltaTime / MaxStep), 1, FMath::Max(MaxSubsteps, 1));
+}
+
+void FDroneFlightModel::StepRail(FDroneFlightState& State, const FDroneFlightInput& Input, const FDroneFlightConfig& Config, float DeltaTime)
+{
+	State.Velocity = CalculateDesiredVelocity(State.Rotation, Input.MovementInput, Config.GetMaxSpeed(Input.SpeedMode));
+	State.Location += State.Velocity * DeltaTime;
+	State.Rotation = CalculateRotation(State.Rotation, Input, Config, DeltaTime);
+	State.Rotation.Roll = 0.0f;
+}
+
+FVector FDroneFlightModel::CalculateAvoidance(const FVector& Velocity, const FDroneFlightInput& Input, const FDroneFlightConfig& Config)
+{
+	if (Config.AvoidanceDistance <= 0.0f || Input.ObstacleDistance >= Config.AvoidanceDistance)
+		return FVector::ZeroVector;
+
+	const float Distance = FMath::Max(Input.ObstacleDistance, 0.0f);
+	const float Proximity = 1.0f - Distance / Config.AvoidanceDistance;
+
+	// Deceleration that stops the approach within the remaining distance (v^2 / 2d),
+	// capped at the drone's own braking so it never exceeds what the airframe can do
+	const float ApproachSpeed = FMath::Max(-FVector::DotProduct(Velocity, Input.ObstacleNormal), 0.0f);
+	const float Braking = FMath::Min(FMath::Square(ApproachSpeed) / (2.0f * FMath::Max(Distance, 1.0f)), Config.Deceleration);
+
+	return Input.ObstacleNormal * (Braking + Config.AvoidanceAcceleration * FMath::Square(Proximity));
+}
+
+FVector FDroneFlightModel::CalculateDesiredVelocity(const FRotator& Rotation, const FVector& MovementInput, float MaxSpeed)
+{
+	// Roll is cosmetic banking, so steer from yaw/pitch only
+	float SinPitch, CosPitch, SinYaw, CosYaw;
+	FMath::SinCos(&SinPitch, &CosPitch, FMath::DegreesToRadians(Rotation.Pitch));
+	FMath::SinCos(&SinYaw, &CosYaw, FMath::DegreesToRadians(Rotation.Yaw));
+
+	const FVector Forward(CosPitch * CosYaw, CosPitch * SinYaw, SinPitch);
+	const FVector Right(-SinYaw, CosYaw, 0.0f);
+
+	FVector WorldInput = (Forward * MovementInput.X) + (Right * MovementInput.Y) + (FVector::UpVector * MovementInput.Z);
+	WorldInput = WorldInput.GetClampedToMaxSize(1.0f);
+
+	return WorldInput * MaxSpeed;
+}
+
+FRotator FDroneFlightModel::CalculateRotation(const FRotator& Rotation, const FDroneFlightInput& Input, const FDroneFlightConfig& Config, float DeltaTime)
+{
+	FRotator Result = Rotation;
+
+	// Yaw and pitch from look input
+	if (!Input.LookInput.IsNearlyZero())
+	{
+		Result.Yaw += Input.LookInput.X * Config.TurnRate * DeltaTime;
+		Result.Pitch = FMath::Clamp(
+			Result.Pitch + Input.LookInput.Y * Config.TurnRate * DeltaTime,
+			-Config.MaxPitchAngle,
+			Config.MaxPitchAngle
+		);
+	}
+
+	// Roll from lateral movement (banking effect)
+	const float TargetRoll = Input.MovementInput.IsNearlyZero() ? 0.0f : Input.MovementInput.Y * Config.MaxRollAngle;
+	Result.Roll = FMath::FInterpTo(Rotation.Roll, TargetRoll, DeltaTime, Config.RollInterpSpeed);
+
+	return Result;
+}
+
+int32 FDroneFixedStepAccumulator::Advance(float DeltaTime)
+{
+	const float Step = FMath::Max(StepTime, KINDA_SMALL_NUMBER);
+	Accumulator += FMath::Max(DeltaTime, 0.0f);
+
+	int32 NumSteps = FMath::FloorToInt(Accumulator / Step);
+	const int32 MaxSteps = FMath::Max(MaxStepsPerFrame, 1);
+	if (NumSteps > MaxSteps)
+	{
+		// Drop the backlog, keeping the partial step for interpolation
+		NumDroppedSteps += NumSteps - MaxSteps;
+		NumSteps = MaxSteps;
+		Accumulator = FMath::Fmod(Accumulator, Step);
+	}
+	else
+	{
+		Accumulator -= NumSteps * Step;
+	}
+
+	return NumSteps;
+}
+
+float FDroneFixedStepAccumulator::GetAlpha() const
+{
+	return FMath::Clamp(Accumulator / FMath::Max(StepTime, KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+}
+
+void FDroneFixedStepAccumulator::Reset()
+{
+	Accumulator = 0.0f;
+	NumDroppedSteps = 0;
+}
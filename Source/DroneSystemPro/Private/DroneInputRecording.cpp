@@ -0,0 +1,169 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneInputRecording.h"
+#include "DroneSystemPro.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace DroneInputRecordingPrivate
+{
+	/** Longer recordings are refused on load; about 19 hours at 144Hz */
+	constexpr int32 MaxFrames = 10000000;
+}
+
+void FDroneInputRecording::AddFrame(const FDroneInputState& Input, const FDroneNetConditions& Conditions)
+{
+	FDroneInputState& Stored = Inputs.Add_GetRef(Input);
+	Stored.Quantize();
+	Stored.InputID = 0;
+	Stored.Timestamp = 0.0f;
+
+	FConditionSample Sample;
+	Sample.Frame = Inputs.Num() - 1;
+	Sample.RoundTripMs = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Conditions.RoundTripTime * 1000.0f), 0, static_cast<int32>(MAX_uint16)));
+	Sample.OutLossPercent = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Conditions.OutLoss * 100.0f), 0, 100));
+	Sample.InLossPercent = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Conditions.InLoss * 100.0f), 0, 100));
+
+	if (ConditionSamples.Num() > 0)
+	{
+		const FConditionSample& Last = ConditionSamples.Last();
+		if (Last.RoundTripMs == Sample.RoundTripMs && Last.OutLossPercent == Sample.OutLossPercent && Last.InLossPercent == Sample.InLossPercent)
+			return;
+	}
+
+	ConditionSamples.Add(Sample);
+}
+
+void FDroneInputRecording::Reset()
+{
+	Inputs.Reset();
+	ConditionSamples.Reset();
+}
+
+float FDroneInputRecording::GetDuration() const
+{
+	float Duration = 0.0f;
+	for (const FDroneInputState& Input : Inputs)
+	{
+		Duration += Input.DeltaTime;
+	}
+	return Duration;
+}
+
+FDroneNetConditions FDroneInputRecording::GetConditions(int32 Frame) const
+{
+	// Last sample starting at or before Frame
+	const int32 Index = Algo::UpperBoundBy(ConditionSamples, Frame, &FConditionSample::Frame) - 1;
+	if (!ConditionSamples.IsValidIndex(Index))
+		return FDroneNetConditions();
+
+	const FConditionSample& Sample = ConditionSamples[Index];
+	return FDroneNetConditions(Sample.RoundTripMs / 1000.0f, Sample.OutLossPercent / 100.0f, Sample.InLossPercent / 100.0f);
+}
+
+bool FDroneInputRecording::Serialize(FArchive& Ar)
+{
+	uint32 FileMagic = Magic;
+	int32 FileVersion = Version;
+	Ar << FileMagic << FileVersion;
+
+	if (Ar.IsLoading() && (FileMagic != Magic || FileVersion != Version))
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	int32 NumFrames = Inputs.Num();
+	Ar << NumFrames;
+
+	if (Ar.IsLoading() && (NumFrames < 0 || NumFrames > DroneInputRecordingPrivate::MaxFrames))
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	// Inputs as one bit stream in the same form as FDroneInputPacket
+	int64 NumBits = 0;
+	TArray<uint8> Bits;
+
+	if (Ar.IsSaving())
+	{
+		FBitWriter Writer(0, true);
+		for (const FDroneInputState& Input : Inputs)
+		{
+			FDroneInputState Copy = Input;
+			Copy.SerializeQuantized(Writer);
+		}
+
+		NumBits = Writer.GetNumBits();
+		Bits = *Writer.GetBuffer();
+		Bits.SetNum(static_cast<int32>((NumBits + 7) >> 3));
+	}
+
+	Ar << NumBits;
+	Ar << Bits;
+
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || NumBits < 0 || NumBits > static_cast<int64>(Bits.Num()) * 8)
+		{
+			Ar.SetError();
+			return false;
+		}
+
+		FBitReader Reader(Bits.GetData(), NumBits);
+		Inputs.SetNum(NumFrames);
+		for (FDroneInputState& Input : Inputs)
+		{
+			Input = FDroneInputState();
+			Input.SerializeQuantized(Reader);
+		}
+
+		if (Reader.IsError())
+		{
+			Reset();
+			Ar.SetError();
+			return false;
+		}
+	}
+
+	Ar << ConditionSamples;
+
+	return !Ar.IsError();
+}
+
+bool FDroneInputRecording::SaveToFile(const FString& FileName) const
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	const_cast<FDroneInputRecording*>(this)->Serialize(Writer);
+
+	return FFileHelper::SaveArrayToFile(Data, *FileName);
+}
+
+bool FDroneInputRecording::LoadFromFile(const FString& FileName)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FileName))
+		return false;
+
+	FMemoryReader Reader(Data);
+	if (!Serialize(Reader))
+	{
+		UE_LOG(LogDroneSystem, Warning, TEXT("%s is not a valid drone input recording"), *FileName);
+		Reset();
+		return false;
+	}
+
+	return true;
+}
+
+FString FDroneInputRecording::GetRecordingDir()
+{
+	return FPaths::ProjectSavedDir() / TEXT("DroneRecordings");
+}
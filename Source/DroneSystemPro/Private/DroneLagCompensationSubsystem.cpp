@@ -0,0 +1,318 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneLagCompensationSubsystem.h"
+#include "DroneSystemPro.h"
+#include "DroneNetClockSubsystem.h"
+#include "DroneMovementComponent.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Record"), STAT_DroneLagCompRecord, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lag Compensated Actors"), STAT_DroneLagCompActors, STATGROUP_DroneSystem);
+
+FDroneTransformHistory::FDroneTransformHistory(int32 InCapacity)
+{
+	Reset(InCapacity);
+}
+
+void FDroneTransformHistory::Reset(int32 InCapacity)
+{
+	Samples.SetNum(FMath::Max(InCapacity, 2));
+	Head = 0;
+	Count = 0;
+}
+
+const FDroneRewindSample& FDroneTransformHistory::Get(int32 Age) const
+{
+	const int32 Oldest = (Head - Count + Samples.Num()) % Samples.Num();
+	return Samples[(Oldest + Age) % Samples.Num()];
+}
+
+void FDroneTransformHistory::Record(float Time, const FVector& Location, const FQuat& Rotation)
+{
+	if (Count > 0 && Time <= GetNewestTime())
+		return;
+
+	FDroneRewindSample& Sample = Samples[Head];
+	Sample.Time = Time;
+	Sample.Location = Location;
+	Sample.Rotation = Rotation;
+
+	Head = (Head + 1) % Samples.Num();
+	Count = FMath::Min(Count + 1, Samples.Num());
+}
+
+bool FDroneTransformHistory::Sample(float Time, FVector& OutLocation, FQuat& OutRotation) const
+{
+	if (Count == 0)
+		return false;
+
+	if (Time <= GetOldestTime() || Count == 1)
+	{
+		OutLocation = Get(0).Location;
+		OutRotation = Get(0).Rotation;
+		return true;
+	}
+
+	if (Time >= GetNewestTime())
+	{
+		OutLocation = Get(Count - 1).Location;
+		OutRotation = Get(Count - 1).Rotation;
+		return true;
+	}
+
+	// First sample newer than Time; the one before it is at or older
+	int32 Low = 1;
+	int32 High = Count - 1;
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (Get(Mid).Time > Time)
+		{
+			High = Mid;
+		}
+		else
+		{
+			Low = Mid + 1;
+		}
+	}
+
+	const FDroneRewindSample& Before = Get(Low - 1);
+	const FDroneRewindSample& After = Get(Low);
+	const float Alpha = (Time - Before.Time) / (After.Time - Before.Time);
+
+	OutLocation = FMath::Lerp(Before.Location, After.Location, Alpha);
+	OutRotation = FQuat::Slerp(Before.Rotation, After.Rotation, Alpha);
+	return true;
+}
+
+UDroneLagCompensationSubsystem::UDroneLagCompensationSubsystem()
+{
+	MaxRewindTime = 0.5f;
+	RecordInterval = 1.0f / 30.0f;
+	ClientViewDelay = 0.1f;
+	RangeTolerance = 50.0f;
+	NextRecordTime = 0.0f;
+}
+
+TStatId UDroneLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDroneLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+bool UDroneLagCompensationSubsystem::IsTickable() const
+{
+	return Tracks.Num() > 0 && GetWorld()->GetNetMode() != NM_Client;
+}
+
+void UDroneLagCompensationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Only the server validates requests
+	if (InWorld.GetNetMode() == NM_Client)
+		return;
+
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UDroneLagCompensationSubsystem::HandleActorSpawned));
+
+	for (APawn* Pawn : TActorRange<APawn>(&InWorld))
+	{
+		RegisterActor(Pawn);
+	}
+}
+
+void UDroneLagCompensationSubsystem::Deinitialize()
+{
+	if (ActorSpawnedHandle.IsValid())
+	{
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		ActorSpawnedHandle.Reset();
+	}
+
+	Tracks.Reset();
+
+	Super::Deinitialize();
+}
+
+void UDroneLagCompensationSubsystem::HandleActorSpawned(AActor* Actor)
+{
+	if (Cast<APawn>(Actor))
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void UDroneLagCompensationSubsystem::RegisterActor(AActor* Actor)
+{
+	if (!Actor || Tracks.Contains(Actor))
+		return;
+
+	FTrack& Track = Tracks.Add(Actor);
+	Track.Actor = Actor;
+	Track.LocalBounds = Actor->CalculateComponentsBoundingBoxInLocalSpace();
+	Track.History.Reset(GetHistoryCapacity());
+	Track.History.Record(GetWorld()->GetTimeSeconds(), Actor->GetActorLocation(), Actor->GetActorQuat());
+}
+
+void UDroneLagCompensationSubsystem::UnregisterActor(AActor* Actor)
+{
+	Tracks.Remove(Actor);
+}
+
+int32 UDroneLagCompensationSubsystem::GetHistoryCapacity() const
+{
+	// Two spare samples so the oldest rewind still has a bracketing pair
+	return FMath::CeilToInt(MaxRewindTime / FMath::Max(RecordInterval, 0.001f)) + 2;
+}
+
+void UDroneLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextRecordTime)
+		return;
+
+	RecordAll(Now);
+	NextRecordTime = Now + RecordInterval;
+}
+
+void UDroneLagCompensationSubsystem::RecordAll(float Time)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DroneLagCompRecord);
+
+	for (auto It = Tracks.CreateIterator(); It; ++It)
+	{
+		const AActor* Actor = It->Value.Actor.Get();
+		if (!Actor)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		It->Value.History.Record(Time, Actor->GetActorLocation(), Actor->GetActorQuat());
+	}
+
+	SET_DWORD_STAT(STAT_DroneLagCompActors, Tracks.Num());
+}
+
+float UDroneLagCompensationSubsystem::GetClientViewTime(const AActor* Target) const
+{
+	const float ServerTime = UDroneNetClockSubsystem::GetServerTime(GetWorld());
+	if (GetWorld()->GetNetMode() != NM_Client)
+		return ServerTime;
+
+	const UDroneMovementComponent* Movement = Target ? Target->FindComponentByClass<UDroneMovementComponent>() : nullptr;
+	if (Movement)
+	{
+		// The player's own drone is predicted, so it is seen in the present
+		if (Target->GetLocalRole() == ROLE_AutonomousProxy)
+			return ServerTime;
+
+		// Remote drones are drawn where their jitter buffer put them, a delay that adapts to the link
+		const FDroneInterpolationStats Stats = Movement->GetInterpolationStats();
+		if (Target->GetLocalRole() == ROLE_SimulatedProxy && Stats.BufferedSnapshots > 0)
+			return FMath::Min(Stats.RenderTime, ServerTime);
+	}
+
+	return ServerTime - ClientViewDelay;
+}
+
+float UDroneLagCompensationSubsystem::ClampRewindTime(float ClientTime) const
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	return FMath::Clamp(ClientTime, Now - MaxRewindTime, Now);
+}
+
+bool UDroneLagCompensationSubsystem::GetTransformAtTime(const AActor* Actor, float Time, FTransform& OutTransform) const
+{
+	if (!Actor)
+		return false;
+
+	OutTransform = Actor->GetActorTransform();
+
+	// Anything newer than the last sample is closer to the present than to history
+	const FTrack* Track = Tracks.Find(Actor);
+	const float RewindTime = ClampRewindTime(Time);
+	FVector Location;
+	FQuat Rotation;
+	if (!Track || RewindTime >= Track->History.GetNewestTime() || !Track->History.Sample(RewindTime, Location, Rotation))
+		return false;
+
+	OutTransform.SetLocation(Location);
+	OutTransform.SetRotation(Rotation);
+	return true;
+}
+
+FVector UDroneLagCompensationSubsystem::GetActorLocationAtTime(AActor* Actor, float Time) const
+{
+	FTransform Transform;
+	GetTransformAtTime(Actor, Time, Transform);
+	return Transform.GetLocation();
+}
+
+bool UDroneLagCompensationSubsystem::WereInRange(const AActor* A, const AActor* B, float Range, float Time) const
+{
+	if (!A || !B)
+		return false;
+
+	FTransform TransformA;
+	FTransform TransformB;
+	GetTransformAtTime(A, Time, TransformA);
+	GetTransformAtTime(B, Time, TransformB);
+
+	return FVector::DistSquared(TransformA.GetLocation(), TransformB.GetLocation()) <= FMath::Square(Range + RangeTolerance);
+}
+
+AActor* UDroneLagCompensationSubsystem::RewoundLineTrace(const FVector& Start, const FVector& End, float Time, const AActor* IgnoreActor, FVector* OutHitLocation) const
+{
+	const float RewindTime = ClampRewindTime(Time);
+
+	AActor* BestActor = nullptr;
+	float BestHitTime = 1.0f;
+
+	for (const TPair<TObjectKey<AActor>, FTrack>& Pair : Tracks)
+	{
+		const FTrack& Track = Pair.Value;
+		AActor* Actor = Track.Actor.Get();
+		if (!Actor || Actor == IgnoreActor || !Track.LocalBounds.IsValid)
+			continue;
+
+		FVector Location;
+		FQuat Rotation;
+		if (!Track.History.Sample(RewindTime, Location, Rotation))
+			continue;
+
+		// Test the ray in the actor's rewound local space against its local bounds
+		const FTransform Pose(Rotation, Location, Actor->GetActorScale3D());
+		FVector HitLocation;
+		FVector HitNormal;
+		float HitTime;
+		if (FMath::LineExtentBoxIntersection(Track.LocalBounds, Pose.InverseTransformPosition(Start), Pose.InverseTransformPosition(End), FVector::ZeroVector, HitLocation, HitNormal, HitTime)
+			&& HitTime < BestHitTime)
+		{
+			BestActor = Actor;
+			BestHitTime = HitTime;
+		}
+	}
+
+	if (!BestActor)
+		return nullptr;
+
+	// Level geometry does not move, so occlusion is checked in the present
+	const FVector HitLocation = FMath::Lerp(Start, End, BestHitTime);
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(DroneRewoundTrace), false, IgnoreActor);
+	Params.AddIgnoredActor(BestActor);
+
+	FHitResult Hit;
+	if (GetWorld()->LineTraceSingleByObjectType(Hit, Start, HitLocation, FCollisionObjectQueryParams(ECC_WorldStatic), Params))
+		return nullptr;
+
+	if (OutHitLocation)
+	{
+		*OutHitLocation = HitLocation;
+	}
+
+	return BestActor;
+}
@@ -1,6 +1,9 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DroneMarkingComponent.h"
+#include "DronePushModel.h"
+#include "DroneLagCompensationSubsystem.h"
+#include "DroneNetClockSubsystem.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/Character.h"
@@ -16,6 +19,7 @@ UDroneMarkingComponent::UDroneMarkingComponent()
 	SetIsReplicatedByDefault(true);
 
 	MarkTag = FName("DroneMarked");
+	MaxViewOriginError = 100.0f;
 }
 
 void UDroneMarkingComponent::BeginPlay()
@@ -27,7 +31,10 @@ void UDroneMarkingComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UDroneMarkingComponent, MarkedTargets);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDroneMarkingComponent, MarkedTargets, Params);
 }
 
 void UDroneMarkingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -51,36 +58,44 @@ void UDroneMarkingComponent::MarkTarget(AActor* Target)
 
 	if (GetOwner()->HasAuthority())
 	{
-		// Check if already marked
-		bool bAlreadyMarked = false;
-		for (FMarkedTarget& Marked : MarkedTargets)
-		{
-			if (Marked.Target == Target)
-			{
-				// Refresh mark time
-				Marked.MarkTime = GetWorld()->GetTimeSeconds();
-				bAlreadyMarked = true;
-				break;
-			}
-		}
+		AddMark(Target);
+	}
+	else
+	{
+		const UDroneLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UDroneLagCompensationSubsystem>();
+		Server_MarkTarget(Target, LagCompensation ? LagCompensation->GetClientViewTime(Target) : UDroneNetClockSubsystem::GetServerTime(GetWorld()));
+	}
+}
 
-		if (!bAlreadyMarked)
+void UDroneMarkingComponent::AddMark(AActor* Target)
+{
+	// Check if already marked
+	bool bAlreadyMarked = false;
+	for (FMarkedTarget& Marked : MarkedTargets)
+	{
+		if (Marked.Target == Target)
 		{
-			float Duration = DroneConfig ? DroneConfig->MarkDuration : 10.0f;
-			FMarkedTarget NewMark(Target, Duration);
-			NewMark.MarkTime = GetWorld()->GetTimeSeconds();
-			MarkedTargets.Add(NewMark);
-
-			// Apply visuals
-			ApplyMarkVisuals(Target, true);
-
-			// Broadcast event
-			Multicast_MarkTarget(Target);
+			// Refresh mark time
+			Marked.MarkTime = UDroneNetClockSubsystem::GetServerTime(GetWorld());
+			DRONE_MARK_PROPERTY_DIRTY(UDroneMarkingComponent, MarkedTargets, this);
+			bAlreadyMarked = true;
+			break;
 		}
 	}
-	else
+
+	if (!bAlreadyMarked)
 	{
-		Server_MarkTarget(Target);
+		float Duration = DroneConfig ? DroneConfig->MarkDuration : 10.0f;
+		FMarkedTarget NewMark(Target, Duration);
+		NewMark.MarkTime = UDroneNetClockSubsystem::GetServerTime(GetWorld());
+		MarkedTargets.Add(NewMark);
+		DRONE_MARK_PROPERTY_DIRTY(UDroneMarkingComponent, MarkedTargets, this);
+
+		// Apply visuals
+		ApplyMarkVisuals(Target, true);
+
+		// Broadcast event
+		Multicast_MarkTarget(Target);
 	}
 }
 
@@ -98,6 +113,7 @@ void UDroneMarkingComponent::UnmarkTarget(AActor* Target)
 		if (Index != INDEX_NONE)
 		{
 			MarkedTargets.RemoveAt(Index);
+			DRONE_MARK_PROPERTY_DIRTY(UDroneMarkingComponent, MarkedTargets, this);
 			ApplyMarkVisuals(Target, false);
 			Multicast_UnmarkTarget(Target);
 		}
@@ -110,6 +126,23 @@ void UDroneMarkingComponent::UnmarkTarget(AActor* Target)
 
 void UDroneMarkingComponent::MarkTargetInCrosshair()
 {
+	if (!GetOwner())
+		return;
+
+	if (!GetOwner()->HasAuthority())
+	{
+		// Send what the player aimed along; the server decides what it hit
+		FVector Start;
+		FVector Direction;
+		if (GetViewPoint(Start, Direction))
+		{
+			// Stamped with the view time of whatever the player saw under the crosshair
+			const UDroneLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UDroneLagCompensationSubsystem>();
+			Server_MarkTargetInCrosshair(Start, Direction, LagCompensation ? LagCompensation->GetClientViewTime(GetTargetInCrosshair()) : UDroneNetClockSubsystem::GetServerTime(GetWorld()));
+		}
+		return;
+	}
+
 	AActor* Target = GetTargetInCrosshair();
 	if (Target)
 	{
@@ -154,21 +187,48 @@ float UDroneMarkingComponent::GetMarkingRange() const
 	return DroneConfig ? DroneConfig->MarkingRange : 2500.0f;
 }
 
-void UDroneMarkingComponent::Server_MarkTarget_Implementation(AActor* Target)
+void UDroneMarkingComponent::Server_MarkTarget_Implementation(AActor* Target, float ClientTime)
 {
-	MarkTarget(Target);
+	// Out of range at the client's view time is a miss, not a cheat
+	if (WasTargetInRange(Target, ClientTime))
+	{
+		AddMark(Target);
+	}
 }
 
-bool UDroneMarkingComponent::Server_MarkTarget_Validate(AActor* Target)
+bool UDroneMarkingComponent::Server_MarkTarget_Validate(AActor* Target, float ClientTime)
 {
-	// Validate target is in range
-	if (!Target || !GetOwner())
-		return false;
+	return Target != nullptr && FMath::IsFinite(ClientTime);
+}
 
-	float DistSq = FVector::DistSquared(GetOwner()->GetActorLocation(), Target->GetActorLocation());
-	float MaxRangeSq = GetMarkingRange() * GetMarkingRange();
+void UDroneMarkingComponent::Server_MarkTargetInCrosshair_Implementation(FVector_NetQuantize Start, FVector_NetQuantizeNormal Direction, float ClientTime)
+{
+	const UDroneLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UDroneLagCompensationSubsystem>();
+	if (!GetOwner() || !LagCompensation)
+		return;
+
+	// The view origin must match our own camera as it was at ClientTime
+	FVector CameraStart;
+	FVector CameraDirection;
+	if (!GetViewPoint(CameraStart, CameraDirection))
+		return;
+
+	FTransform OwnerTransform;
+	LagCompensation->GetTransformAtTime(GetOwner(), ClientTime, OwnerTransform);
+	const FVector RewoundCamera = OwnerTransform.GetLocation() + (CameraStart - GetOwner()->GetActorLocation());
+	if (FVector::DistSquared(Start, RewoundCamera) > FMath::Square(MaxViewOriginError))
+		return;
 
-	return DistSq <= (MaxRangeSq * 1.2f); // Allow some tolerance
+	AActor* Target = LagCompensation->RewoundLineTrace(Start, Start + Direction * GetMarkingRange(), ClientTime, GetOwner());
+	if (IsMarkableActor(Target))
+	{
+		AddMark(Target);
+	}
+}
+
+bool UDroneMarkingComponent::Server_MarkTargetInCrosshair_Validate(FVector_NetQuantize Start, FVector_NetQuantizeNormal Direction, float ClientTime)
+{
+	return FMath::IsFinite(ClientTime) && !Start.ContainsNaN() && !Direction.ContainsNaN();
 }
 
 void UDroneMarkingComponent::Server_UnmarkTarget_Implementation(AActor* Target)
@@ -204,7 +264,7 @@ void UDroneMarkingComponent::UpdateMarkedTargets(float DeltaTime)
 	if (!GetWorld())
 		return;
 
-	float CurrentTime = GetWorld()->GetTimeSeconds();
+	float CurrentTime = UDroneNetClockSubsystem::GetServerTime(GetWorld());
 	TArray<AActor*> ToUnmark;
 
 	// Check for expired marks
@@ -223,19 +283,34 @@ void UDroneMarkingComponent::UpdateMarkedTargets(float DeltaTime)
 	}
 }
 
-AActor* UDroneMarkingComponent::GetTargetInCrosshair() const
+bool UDroneMarkingComponent::GetViewPoint(FVector& OutStart, FVector& OutDirection) const
 {
 	if (!GetOwner())
-		return nullptr;
+		return false;
 
 	// Get camera component
 	UCameraComponent* Camera = GetOwner()->FindComponentByClass<UCameraComponent>();
 	if (!Camera)
-		return nullptr;
+		return false;
+
+	OutStart = Camera->GetComponentLocation();
+	OutDirection = Camera->GetForwardVector();
+	return true;
+}
 
+bool UDroneMarkingComponent::IsMarkableActor(const AActor* Actor) const
+{
+	return Actor && (Actor->IsA(APawn::StaticClass()) || Actor->IsA(ACharacter::StaticClass()));
+}
+
+AActor* UDroneMarkingComponent::GetTargetInCrosshair() const
+{
 	// Perform line trace from camera
-	FVector Start = Camera->GetComponentLocation();
-	FVector Forward = Camera->GetForwardVector();
+	FVector Start;
+	FVector Forward;
+	if (!GetViewPoint(Start, Forward))
+		return nullptr;
+
 	FVector End = Start + (Forward * GetMarkingRange());
 
 	FHitResult Hit;
@@ -245,7 +320,7 @@ AActor* UDroneMarkingComponent::GetTargetInCrosshair() const
 	if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params))
 	{
 		AActor* HitActor = Hit.GetActor();
-		if (HitActor && (HitActor->IsA(APawn::StaticClass()) || HitActor->IsA(ACharacter::StaticClass())))
+		if (IsMarkableActor(HitActor))
 		{
 			return HitActor;
 		}
@@ -265,6 +340,15 @@ bool UDroneMarkingComponent::IsTargetInRange(AActor* Target) const
 	return DistSq <= MaxRangeSq;
 }
 
+bool UDroneMarkingComponent::WasTargetInRange(AActor* Target, float ClientTime) const
+{
+	const UDroneLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UDroneLagCompensationSubsystem>();
+	if (!LagCompensation)
+		return IsTargetInRange(Target);
+
+	return LagCompensation->WereInRange(GetOwner(), Target, GetMarkingRange(), ClientTime);
+}
+
 void UDroneMarkingComponent::ApplyMarkVisuals(AActor* Target, bool bMarked)
 {
 	if (!Target)
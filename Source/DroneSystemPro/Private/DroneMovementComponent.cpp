@@ -1,9 +1,25 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DroneMovementComponent.h"
+#include "DroneMovementWorldSubsystem.h"
+#include "DroneNetClockSubsystem.h"
+#include "DroneVisionComponent.h"
+#include "DroneObstacleFieldSubsystem.h"
+#include "DroneTerrainSubsystem.h"
+#include "DroneSystemPro.h"
 #include "GameFramework/Actor.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/World.h"
+#include "Components/SceneComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/NetConnection.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<int32> CVarDroneRecordInput(
+	TEXT("Drone.RecordInput"),
+	0,
+	TEXT("1: owning clients record their drone inputs to Saved/DroneRecordings for FDroneNetReplay"));
 
 UDroneMovementComponent::UDroneMovementComponent()
 {
@@ -11,26 +27,120 @@ UDroneMovementComponent::UDroneMovementComponent()
 	SetIsReplicatedByDefault(true);
 
 	SpeedMode = EDroneSpeedMode::Low;
-	Velocity = FVector::ZeroVector;
+	VisionComponent = nullptr;
+	LastClientSpeedMode = EDroneSpeedMode::Low;
+	LastClientVisionMode = EDroneVisionMode::Normal;
 	MovementInput = FVector::ZeroVector;
 	LookInput = FVector2D::ZeroVector;
 	NextInputID = 0;
 	LastSendTime = 0.0f;
 	SendInterval = 1.0f / 30.0f; // 30Hz send rate
-	WindMultiplier = 1.0f;
+	RedundantInputCount = 16;
+	LastConsumedInputID = 0;
+	bHasConsumedInput = false;
+	SnapshotInterval = 0.0f;
+	LastSnapshotTime = 0.0f;
+	MaxMoveDeltaTime = 0.1f;
+	MaxMoveTimeBudget = 0.5f;
+	MoveTimeTolerance = 0.05f;
+	MoveTimeBudget = 0.0f;
+	RejectedMoveCount = 0;
+	CorrectionErrorThreshold = 50.0f;
+	CorrectionVelocityTolerance = 0.02f;
+	CorrectionSmoothingTime = 0.15f;
+	MaxSmoothedCorrection = 500.0f;
+	bUseFixedTimestep = true;
+	FixedTimestep = 1.0f / 60.0f;
+	MaxStepsPerFrame = 4;
+	bInterpolateSteps = false;
+	CorrectionCount = 0;
+	LastCorrectionError = 0.0f;
+	VisualComponent = nullptr;
+	VisualLocationOffset = FVector::ZeroVector;
+	VisualRotationOffset = FQuat::Identity;
+	InterpolationMinDelay = 0.05f;
+	InterpolationMaxDelay = 0.3f;
+	MaxExtrapolationTime = 0.25f;
+	MaxSlideIterations = 4;
+	CollisionSkinWidth = 0.5f;
+	ContactRetestInterval = 0.2f;
+	bUseObstacleAvoidance = false;
+	bAltitudeHold = false;
+	HoldHeight = 500.0f;
+	AltitudeHoldGain = 2.0f;
+	AltitudeHoldLookahead = 1.0f;
+	bUseAsyncCollisionQueries = false;
+	AsyncSweepLookahead = 0.15f;
+	ContactNormal = FVector::UpVector;
+	ContactPoint = FVector::ZeroVector;
+	ContactTime = 0.0f;
+	bHasContact = false;
+	bUseBatchedSimulation = true;
+	bUseAsyncPhysicsSimulation = false;
+	bSimulationEnabled = true;
+	BatchIndex = INDEX_NONE;
+	MovementLOD = EDroneMovementLOD::Full;
 	JammingMultiplier = 1.0f;
+	WindSubsystem = nullptr;
+	ObstacleField = nullptr;
+	TerrainSubsystem = nullptr;
+	CurrentWind = FVector::ZeroVector;
+	NetClock = nullptr;
+	bHasPendingClockPing = false;
+	PendingClockPingTicks = 0;
+	PendingClockPingTime = 0.0f;
 }
 
 void UDroneMovementComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Load default config if not set
-	if (!DroneConfig)
+	WindSubsystem = GetWorld()->GetSubsystem<UDroneWindSubsystem>();
+	ObstacleField = GetWorld()->GetSubsystem<UDroneObstacleFieldSubsystem>();
+	TerrainSubsystem = GetWorld()->GetSubsystem<UDroneTerrainSubsystem>();
+	NetClock = GetWorld()->GetSubsystem<UDroneNetClockSubsystem>();
+	VisionComponent = GetOwner()->FindComponentByClass<UDroneVisionComponent>();
+	LastClientSpeedMode = SpeedMode;
+	LastClientVisionMode = GetVisionMode();
+
+	RefreshFlightConfig();
+	SyncFlightStateFromOwner();
+	PreviousFlightState = FlightState;
+
+	// Steps are rounded like input delta times so the server simulates exactly what the client did
+	FDroneInputState StepInput;
+	StepInput.DeltaTime = FixedTimestep;
+	StepInput.Quantize();
+	StepAccumulator.StepTime = FMath::Max(StepInput.DeltaTime, 0.001f);
+	StepAccumulator.MaxStepsPerFrame = MaxStepsPerFrame;
+	StepAccumulator.Reset();
+
+	ProxyInterpolator.Settings.MinDelay = InterpolationMinDelay;
+	ProxyInterpolator.Settings.MaxDelay = FMath::Max(InterpolationMinDelay, InterpolationMaxDelay);
+	ProxyInterpolator.Settings.MaxExtrapolationTime = MaxExtrapolationTime;
+	ProxyInterpolator.Reset();
+
+	if (VisualComponent)
+	{
+		VisualBaseTransform = VisualComponent->GetRelativeTransform();
+	}
+
+	UpdateBatchRegistration();
+}
+
+void UDroneMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (InputRecording)
+	{
+		StopInputRecording();
+	}
+
+	if (UDroneMovementWorldSubsystem* Subsystem = GetWorld() ? GetWorld()->GetSubsystem<UDroneMovementWorldSubsystem>() : nullptr)
 	{
-		// Try to load a default config asset
-		// In production, this would be set in editor or loaded from content
+		Subsystem->UnregisterComponent(this);
 	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UDroneMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -38,7 +148,37 @@ void UDroneMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimePropert
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(UDroneMovementComponent, ServerSnapshot);
-	DOREPLIFETIME(UDroneMovementComponent, SpeedMode);
+	DOREPLIFETIME_CONDITION(UDroneMovementComponent, SpeedMode, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(UDroneMovementComponent, ClockPong, COND_OwnerOnly);
+}
+
+void UDroneMovementComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// Stamp the echo as late as possible so hold time excludes replication scheduling
+	if (bHasPendingClockPing)
+	{
+		const float Now = GetServerTime();
+		ClockPong.ClientTicks = PendingClockPingTicks;
+		ClockPong.ServerSendTime = Now;
+		ClockPong.ServerHoldTicks = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt((Now - PendingClockPingTime) * FDroneNetTime::TicksPerSecond), 0, static_cast<int32>(MAX_uint16)));
+		bHasPendingClockPing = false;
+	}
+}
+
+float UDroneMovementComponent::GetServerTime() const
+{
+	return NetClock ? NetClock->GetServerTime() : GetWorld()->GetTimeSeconds();
+}
+
+void UDroneMovementComponent::OnRep_ClockPong()
+{
+	if (!NetClock)
+		return;
+
+	const float ClientSendTime = FDroneNetTime::Expand(ClockPong.ClientTicks, NetClock->GetLocalTime());
+	NetClock->AddPingSample(ClientSendTime, ClockPong.ServerSendTime, static_cast<float>(ClockPong.ServerHoldTicks / FDroneNetTime::TicksPerSecond));
 }
 
 void UDroneMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -48,6 +188,11 @@ void UDroneMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType
 	if (!GetOwner())
 		return;
 
+	// Hand over to the batch subsystem once we are locally driven (e.g. unpossessed)
+	UpdateBatchRegistration();
+	if (IsBatched())
+		return;
+
 	// Different logic for server vs client
 	if (GetOwner()->HasAuthority())
 	{
@@ -59,24 +204,20 @@ void UDroneMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType
 	}
 	else
 	{
-		// Simulated proxy - interpolate to server snapshot
-		if (ServerSnapshot.Timestamp > 0.0f)
-		{
-			FVector TargetLocation = ServerSnapshot.Location;
-			FRotator TargetRotation = ServerSnapshot.Rotation;
-			Velocity = ServerSnapshot.Velocity;
+		SimulatedProxyTick(DeltaTime);
+	}
 
-			FVector CurrentLocation = GetOwner()->GetActorLocation();
-			FRotator CurrentRotation = GetOwner()->GetActorRotation();
+	UpdateVisualOffset(DeltaTime);
+}
 
-			// Smooth interpolation
-			float Alpha = FMath::Clamp(DeltaTime * 10.0f, 0.0f, 1.0f);
-			FVector NewLocation = FMath::Lerp(CurrentLocation, TargetLocation, Alpha);
-			FRotator NewRotation = FMath::Lerp(CurrentRotation, TargetRotation, Alpha);
+void UDroneMovementComponent::SimulatedProxyTick(float DeltaTime)
+{
+	bInterpolateSteps = false;
 
-			GetOwner()->SetActorLocation(NewLocation);
-			GetOwner()->SetActorRotation(NewRotation);
-		}
+	// Render the buffered server snapshots slightly in the past
+	if (ProxyInterpolator.Sample(GetServerTime(), DeltaTime, FlightState))
+	{
+		GetOwner()->SetActorLocationAndRotation(FlightState.Location, FlightState.Rotation);
 	}
 }
 
@@ -92,188 +233,698 @@ void UDroneMovementComponent::SetLookInput(FVector2D InInput)
 
 void UDroneMovementComponent::SetSpeedMode(EDroneSpeedMode NewMode)
 {
+	// The next input carries it to the server
 	SpeedMode = NewMode;
 }
 
+EDroneVisionMode UDroneMovementComponent::GetVisionMode() const
+{
+	return VisionComponent ? VisionComponent->GetVisionMode() : EDroneVisionMode::Normal;
+}
+
+void UDroneMovementComponent::SetVisualComponent(USceneComponent* NewVisualComponent)
+{
+	VisualComponent = NewVisualComponent;
+	VisualLocationOffset = FVector::ZeroVector;
+	VisualRotationOffset = FQuat::Identity;
+
+	if (VisualComponent && HasBegunPlay())
+	{
+		VisualBaseTransform = VisualComponent->GetRelativeTransform();
+	}
+}
+
+void UDroneMovementComponent::SetSimulationEnabled(bool bEnabled)
+{
+	bSimulationEnabled = bEnabled;
+
+	// Batched drones are skipped by the subsystem instead
+	if (!IsBatched())
+	{
+		SetComponentTickEnabled(bEnabled);
+	}
+}
+
+bool UDroneMovementComponent::CanUseBatchedSimulation() const
+{
+	// Remote clients need per-move simulation and acknowledgement
+	return bUseBatchedSimulation && GetOwner() && GetOwner()->HasAuthority() && GetOwner()->GetRemoteRole() != ROLE_AutonomousProxy;
+}
+
+void UDroneMovementComponent::UpdateBatchRegistration()
+{
+	if (IsBatched() || !CanUseBatchedSimulation() || !GetWorld())
+		return;
+
+	if (UDroneMovementWorldSubsystem* Subsystem = GetWorld()->GetSubsystem<UDroneMovementWorldSubsystem>())
+	{
+		Subsystem->RegisterComponent(this);
+	}
+}
+
+void UDroneMovementComponent::FinishBatchedStep(const FDroneFlightState& NewState, float Timestamp)
+{
+	FlightState = NewState;
+	ApplyMovement();
+	UpdateServerSnapshot(Timestamp);
+}
+
+void UDroneMovementComponent::UpdateServerSnapshot(float Timestamp)
+{
+	// A held snapshot leaves the property unchanged, so nothing is resent until the interval passes
+	if (SnapshotInterval > 0.0f && Timestamp >= LastSnapshotTime && Timestamp - LastSnapshotTime < SnapshotInterval)
+		return;
+
+	LastSnapshotTime = Timestamp;
+
+	ServerSnapshot.Location = FlightState.Location;
+	ServerSnapshot.Rotation = FlightState.Rotation;
+	ServerSnapshot.Velocity = FlightState.Velocity;
+	ServerSnapshot.Timestamp = Timestamp;
+	ServerSnapshot.SpeedMode = SpeedMode;
+	ServerSnapshot.VisionMode = GetVisionMode();
+
+	// Corrections carry the exact last move the server state includes
+	if (bHasConsumedInput)
+	{
+		ServerSnapshot.InputID = LastConsumedInputID;
+	}
+}
+
+void UDroneMovementComponent::SetSnapshotInterval(float Interval)
+{
+	SnapshotInterval = FMath::Max(Interval, 0.0f);
+}
+
 void UDroneMovementComponent::SetDroneConfig(UDroneConfig* NewConfig)
 {
 	DroneConfig = NewConfig;
+	RefreshFlightConfig();
+}
+
+void UDroneMovementComponent::RefreshFlightConfig()
+{
+	FlightConfig = FDroneFlightConfig::FromDroneConfig(DroneConfig);
+	FlightConfig.SpeedScale = JammingMultiplier;
+
+	if (IsBatched())
+	{
+		GetWorld()->GetSubsystem<UDroneMovementWorldSubsystem>()->UpdateFlightConfig(this, FlightConfig);
+	}
+}
+
+void UDroneMovementComponent::SyncFlightStateFromOwner()
+{
+	if (!GetOwner())
+		return;
+
+	// Pick up external teleports (docking, spawning) before integrating
+	const FVector Location = GetOwner()->GetActorLocation();
+	const FRotator Rotation = GetOwner()->GetActorRotation();
+	const bool bTeleported = !Location.Equals(FlightState.Location);
+
+	FlightState.Location = Location;
+	FlightState.Rotation = Rotation;
+
+	// Rendering does not interpolate across a teleport
+	if (bTeleported)
+	{
+		PreviousFlightState = FlightState;
+	}
+}
+
+FDroneFlightInput UDroneMovementComponent::MakeFlightInput(const FDroneInputState& Input) const
+{
+	return FDroneFlightInput(Input.MovementInput, Input.LookInput, Input.SpeedMode);
+}
+
+FVector UDroneMovementComponent::SampleWind(const FVector& Location)
+{
+	CurrentWind = WindSubsystem ? WindSubsystem->SampleWind(Location, WindCache) : FVector::ZeroVector;
+	return CurrentWind;
+}
+
+void UDroneMovementComponent::SampleObstacles(const FVector& Location, FDroneFlightInput& Input) const
+{
+	if (!bUseObstacleAvoidance || !ObstacleField || !ObstacleField->HasVolumes())
+		return;
+
+	Input.ObstacleDistance = ObstacleField->SampleDistance(Location, Input.ObstacleNormal);
+}
+
+void UDroneMovementComponent::SetAltitudeHold(bool bEnabled, float HeightAboveGround)
+{
+	bAltitudeHold = bEnabled;
+	if (bEnabled)
+	{
+		HoldHeight = FMath::Max(HeightAboveGround, 0.0f);
+	}
+}
+
+void UDroneMovementComponent::ApplyAltitudeHold(const FDroneFlightState& State, FDroneFlightInput& Input)
+{
+	if (!bAltitudeHold || !TerrainSubsystem)
+		return;
+
+	// Highest ground under the drone or where it will be shortly
+	float GroundHeight = 0.0f;
+	float AheadHeight = 0.0f;
+	const bool bHasGround = TerrainSubsystem->GetGroundHeight(State.Location, GroundHeight);
+	const FVector Ahead = State.Location + FVector(State.Velocity.X, State.Velocity.Y, 0.0f) * AltitudeHoldLookahead;
+	if (TerrainSubsystem->GetGroundHeight(Ahead, AheadHeight))
+	{
+		GroundHeight = bHasGround ? FMath::Max(GroundHeight, AheadHeight) : AheadHeight;
+	}
+	else if (!bHasGround)
+	{
+		return;
+	}
+
+	// Proportional climb rate, as a fraction of top speed
+	const float MaxSpeed = FlightConfig.GetMaxSpeed(Input.SpeedMode);
+	const float ClimbRate = (GroundHeight + HoldHeight - State.Location.Z) * AltitudeHoldGain;
+	Input.MovementInput.Z = (MaxSpeed > KINDA_SMALL_NUMBER) ? FMath::Clamp(ClimbRate / MaxSpeed, -1.0f, 1.0f) : 0.0f;
 }
 
 void UDroneMovementComponent::ClientTick(float DeltaTime)
+{
+	if (!InputRecording && CVarDroneRecordInput.GetValueOnGameThread() != 0 && GetNetMode() == NM_Client)
+	{
+		StartInputRecording();
+	}
+
+	if (InputRecording)
+	{
+		// Whole frames, so a replay runs the same step accumulation
+		FDroneInputState Frame;
+		Frame.MovementInput = MovementInput;
+		Frame.LookInput = LookInput;
+		Frame.DeltaTime = DeltaTime;
+		Frame.SpeedMode = SpeedMode;
+		Frame.VisionMode = GetVisionMode();
+		InputRecording->AddFrame(Frame, GetNetConditions());
+	}
+
+	SyncFlightStateFromOwner();
+
+	// One input per simulated step, so InputID is the step index
+	bInterpolateSteps = bUseFixedTimestep;
+	const int32 NumSteps = bUseFixedTimestep ? StepAccumulator.Advance(DeltaTime) : 1;
+	const float StepTime = bUseFixedTimestep ? StepAccumulator.StepTime : DeltaTime;
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		ClientStep(StepTime);
+	}
+
+	float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// Send input to server at fixed intervals
+	if ((CurrentTime - LastSendTime) >= SendInterval)
+	{
+		SendInputPacket();
+		LastSendTime = CurrentTime;
+	}
+}
+
+void UDroneMovementComponent::ClientStep(float StepTime)
 {
 	// Create input state
 	FDroneInputState InputState;
 	InputState.MovementInput = MovementInput;
 	InputState.LookInput = LookInput;
-	InputState.DeltaTime = DeltaTime;
+	InputState.DeltaTime = StepTime;
 	InputState.InputID = NextInputID++;
-	InputState.Timestamp = GetWorld()->GetTimeSeconds();
-
-	// Simulate movement locally
-	SimulateMovement(DeltaTime, InputState);
-	ApplyMovement(DeltaTime);
+	InputState.Timestamp = GetServerTime();
+	InputState.SpeedMode = SpeedMode;
+	InputState.VisionMode = GetVisionMode();
 
-	// Store input and snapshot for reconciliation
-	PendingInputs.Add(InputState);
+	// Predict with exactly what the server will receive
+	InputState.Quantize();
 
-	FDroneMovementSnapshot Snapshot(
-		GetOwner()->GetActorLocation(),
-		GetOwner()->GetActorRotation(),
-		Velocity,
+	// Simulate movement locally
+	PreviousFlightState = FlightState;
+	SimulateMovement(InputState.DeltaTime, InputState);
+	ApplyMovement();
+
+	// Store input and predicted result for reconciliation; the buffer evicts
+	// its oldest entry when full and is trimmed as the server acknowledges
+	FDroneMoveRecord Record;
+	Record.Input = InputState;
+	Record.PredictedSnapshot = FDroneMovementSnapshot(
+		FlightState.Location,
+		FlightState.Rotation,
+		FlightState.Velocity,
 		InputState.Timestamp,
 		InputState.InputID
 	);
-	ClientSnapshots.Add(Snapshot);
+	MoveHistory.Add(InputState.InputID, Record);
+}
 
-	// Clean old data (keep last 1 second)
-	float CurrentTime = GetWorld()->GetTimeSeconds();
-	PendingInputs.RemoveAll([CurrentTime](const FDroneInputState& Input) {
-		return (CurrentTime - Input.Timestamp) > 1.0f;
-	});
-	ClientSnapshots.RemoveAll([CurrentTime](const FDroneMovementSnapshot& Snap) {
-		return (CurrentTime - Snap.Timestamp) > 1.0f;
-	});
+void UDroneMovementComponent::SendInputPacket()
+{
+	if (MoveHistory.IsEmpty())
+		return;
 
-	// Send input to server at fixed intervals
-	if ((CurrentTime - LastSendTime) >= SendInterval)
+	// Repeat the newest unacknowledged inputs so single packet loss is absorbed
+	const uint32 Count = FMath::Min<uint32>(MoveHistory.Num(), FMath::Clamp(RedundantInputCount, 1, FDroneInputPacket::MaxInputs));
+
+	FDroneInputPacket Packet;
+	Packet.Inputs.Reserve(Count);
+
+	for (uint32 InputID = MoveHistory.GetNextID() - Count; InputID != MoveHistory.GetNextID(); ++InputID)
 	{
-		Server_SendInput(InputState);
-		LastSendTime = CurrentTime;
+		const FDroneMoveRecord* Record = MoveHistory.Find(InputID);
+		if (!Record)
+		{
+			// Packets carry consecutive IDs only
+			Packet.Inputs.Reset();
+			continue;
+		}
+
+		Packet.Inputs.Add(Record->Input);
+	}
+
+	if (Packet.Inputs.Num() > 0)
+	{
+		// Clock pings ride along every PingInterval
+		if (NetClock && NetClock->ConsumePingSlot())
+		{
+			Packet.bHasClockPing = true;
+			Packet.ClockPingTicks = FDroneNetTime::ToTicks(NetClock->GetLocalTime());
+		}
+
+		if (InputPacketOverride)
+		{
+			InputPacketOverride(Packet);
+		}
+		else
+		{
+			Server_SendInputs(Packet);
+		}
 	}
 }
 
-void UDroneMovementComponent::ServerTick(float DeltaTime)
+FDroneNetConditions UDroneMovementComponent::GetNetConditions() const
 {
-	// Server simulates with last received input
-	FDroneInputState CurrentInput;
-	CurrentInput.MovementInput = MovementInput;
-	CurrentInput.LookInput = LookInput;
-	CurrentInput.DeltaTime = DeltaTime;
-	CurrentInput.Timestamp = GetWorld()->GetTimeSeconds();
+	FDroneNetConditions Conditions;
+	Conditions.RoundTripTime = NetClock ? NetClock->GetRoundTripTime() : 0.0f;
 
-	SimulateMovement(DeltaTime, CurrentInput);
-	ApplyMovement(DeltaTime);
+	if (const UNetConnection* Connection = GetOwner() ? GetOwner()->GetNetConnection() : nullptr)
+	{
+		Conditions.OutLoss = Connection->GetOutLossPercentage().GetAvgLossPercentage();
+		Conditions.InLoss = Connection->GetInLossPercentage().GetAvgLossPercentage();
+	}
 
-	// Update server snapshot
-	ServerSnapshot.Location = GetOwner()->GetActorLocation();
-	ServerSnapshot.Rotation = GetOwner()->GetActorRotation();
-	ServerSnapshot.Velocity = Velocity;
-	ServerSnapshot.Timestamp = GetWorld()->GetTimeSeconds();
+	return Conditions;
 }
 
-void UDroneMovementComponent::SimulateMovement(float DeltaTime, const FDroneInputState& Input)
+void UDroneMovementComponent::StartInputRecording()
 {
-	if (!DroneConfig)
-		return;
+	InputRecording = MakeUnique<FDroneInputRecording>();
+}
+
+FString UDroneMovementComponent::StopInputRecording()
+{
+	TUniquePtr<FDroneInputRecording> Recording = MoveTemp(InputRecording);
+	if (!Recording || Recording->Num() == 0)
+		return FString();
 
-	// Calculate desired velocity based on input
-	FVector DesiredVelocity = CalculateDesiredVelocity(Input.MovementInput);
+	const FString FileName = FDroneInputRecording::GetRecordingDir() / FString::Printf(TEXT("%s_%s.%s"),
+		GetOwner() ? *GetOwner()->GetName() : TEXT("Drone"), *FDateTime::Now().ToString(), FDroneInputRecording::GetFileExtension());
 
-	// Apply acceleration/deceleration
-	float AccelRate = GetAcceleration();
-	if (DesiredVelocity.IsNearlyZero())
+	if (!Recording->SaveToFile(FileName))
 	{
-		// Decelerate
-		AccelRate = DroneConfig->Deceleration;
+		UE_LOG(LogDroneSystem, Warning, TEXT("Failed to write drone input recording %s"), *FileName);
+		return FString();
 	}
 
-	// Lerp towards desired velocity
-	float Alpha = FMath::Clamp(DeltaTime * AccelRate / GetMaxSpeed(), 0.0f, 1.0f);
-	Velocity = FMath::Lerp(Velocity, DesiredVelocity, Alpha);
+	UE_LOG(LogDroneSystem, Log, TEXT("Wrote %d frames (%.1fs) of drone input to %s"), Recording->Num(), Recording->GetDuration(), *FileName);
+	return FileName;
+}
 
-	// Apply environmental factors
-	Velocity *= WindMultiplier * JammingMultiplier;
+bool UDroneMovementComponent::ConsumeNextServerInput(FDroneInputState& OutInput)
+{
+	if (ServerInputBuffer.IsEmpty())
+		return false;
 
-	ClampVelocity();
+	// Oldest buffered input newer than the last one consumed; gaps beyond
+	// the client's redundancy window are skipped
+	for (uint32 InputID = ServerInputBuffer.GetOldestID(); InputID != ServerInputBuffer.GetNextID(); ++InputID)
+	{
+		const FDroneInputState* Input = ServerInputBuffer.Find(InputID);
+		if (!Input)
+			continue;
+
+		OutInput = *Input;
+		LastConsumedInputID = InputID;
+		bHasConsumedInput = true;
+		ServerInputBuffer.Acknowledge(InputID);
+		return true;
+	}
+
+	ServerInputBuffer.Reset();
+	return false;
 }
 
-void UDroneMovementComponent::ApplyMovement(float DeltaTime)
+void UDroneMovementComponent::ServerTick(float DeltaTime)
 {
-	if (!GetOwner())
+	SyncFlightStateFromOwner();
+
+	if (GetOwner()->GetRemoteRole() == ROLE_AutonomousProxy)
+	{
+		// Remote client: replay each of its moves with the move's own delta
+		bInterpolateSteps = false;
+		SimulateClientMoves(DeltaTime);
+	}
+	else
+	{
+		// Locally driven (AI, listen server host)
+		bInterpolateSteps = bUseFixedTimestep;
+		const int32 NumSteps = bUseFixedTimestep ? StepAccumulator.Advance(DeltaTime) : 1;
+		const float StepTime = bUseFixedTimestep ? StepAccumulator.StepTime : DeltaTime;
+
+		for (int32 Step = 0; Step < NumSteps; ++Step)
+		{
+			FDroneInputState CurrentInput;
+			CurrentInput.MovementInput = MovementInput;
+			CurrentInput.LookInput = LookInput;
+			CurrentInput.DeltaTime = StepTime;
+			CurrentInput.Timestamp = GetServerTime();
+			CurrentInput.SpeedMode = SpeedMode;
+
+			PreviousFlightState = FlightState;
+			SimulateMovement(StepTime, CurrentInput);
+			ApplyMovement();
+		}
+	}
+
+	UpdateServerSnapshot(GetServerTime());
+}
+
+void UDroneMovementComponent::SimulateClientMoves(float DeltaTime)
+{
+	// Bank the real time that passed; moves spend it
+	MoveTimeBudget = FMath::Min(MoveTimeBudget + DeltaTime, MaxMoveTimeBudget);
+
+	FDroneInputState Move;
+	while (ConsumeNextServerInput(Move))
+	{
+		const float MoveDelta = FMath::Clamp(Move.DeltaTime, 0.0f, MaxMoveDeltaTime);
+
+		MovementInput = Move.MovementInput.GetClampedToMaxSize(1.0f);
+		LookInput = Move.LookInput;
+
+		// The server's mode is authoritative for the simulation
+		ApplyClientModes(Move);
+		Move.SpeedMode = SpeedMode;
+
+		// More simulated time than real time: speed hack or abused client clock.
+		// The move is still acknowledged so the client gets corrected.
+		if (MoveDelta > MoveTimeBudget + MoveTimeTolerance)
+		{
+			++RejectedMoveCount;
+			continue;
+		}
+
+		MoveTimeBudget -= MoveDelta;
+
+		// Resolve collision per move, as the client did when predicting it
+		SimulateMovement(MoveDelta, Move);
+		ApplyMovement();
+	}
+}
+
+void UDroneMovementComponent::ApplyClientModes(const FDroneInputState& Move)
+{
+	if (Move.SpeedMode != LastClientSpeedMode)
+	{
+		LastClientSpeedMode = Move.SpeedMode;
+		SpeedMode = Move.SpeedMode;
+	}
+
+	if (Move.VisionMode != LastClientVisionMode)
+	{
+		LastClientVisionMode = Move.VisionMode;
+		if (VisionComponent)
+		{
+			VisionComponent->SetVisionMode(Move.VisionMode);
+		}
+	}
+}
+
+void UDroneMovementComponent::SimulateMovement(float DeltaTime, const FDroneInputState& Input)
+{
+	if (!DroneConfig)
 		return;
 
-	// Move actor
-	FVector NewLocation = GetOwner()->GetActorLocation() + (Velocity * DeltaTime);
-	GetOwner()->SetActorLocation(NewLocation, true);
+	// Wind comes from the shared field, so client replay and server agree
+	FDroneFlightInput FlightInput = MakeFlightInput(Input);
+	FlightInput.WindVelocity = SampleWind(FlightState.Location);
+	SampleObstacles(FlightState.Location, FlightInput);
+	ApplyAltitudeHold(FlightState, FlightInput);
 
-	// Update rotation based on velocity and look input
-	UpdateRotation(DeltaTime);
+	FDroneFlightModel::Simulate(FlightState, FlightInput, FlightConfig, DeltaTime);
 }
 
-void UDroneMovementComponent::UpdateRotation(float DeltaTime)
+void UDroneMovementComponent::ApplyMovement()
 {
-	if (!GetOwner() || !DroneConfig)
+	USceneComponent* Root = GetOwner() ? GetOwner()->GetRootComponent() : nullptr;
+	if (!Root)
 		return;
 
-	FRotator CurrentRotation = GetOwner()->GetActorRotation();
-	FRotator TargetRotation = CurrentRotation;
+	const FQuat Rotation = FlightState.Rotation.Quaternion();
 
-	// Yaw from look input
-	if (!LookInput.IsNearlyZero())
+	// Low significance drones are not worth a scene query
+	if (MovementLOD != EDroneMovementLOD::Full)
 	{
-		TargetRotation.Yaw += LookInput.X * DroneConfig->TurnRate * DeltaTime;
+		Root->SetWorldLocationAndRotation(FlightState.Location, Rotation);
+		return;
 	}
 
-	// Pitch from look input
-	if (!LookInput.IsNearlyZero())
+	const bool bAsync = IsBatched() && bUseAsyncCollisionQueries;
+
+	if (bAsync)
 	{
-		TargetRotation.Pitch = FMath::Clamp(
-			TargetRotation.Pitch + LookInput.Y * DroneConfig->TurnRate * DeltaTime,
-			-DroneConfig->MaxPitchAngle,
-			DroneConfig->MaxPitchAngle
-		);
+		ConsumeAsyncSweep(Root);
 	}
 
-	// Roll from movement (banking effect)
-	if (!MovementInput.IsNearlyZero())
+	// Known blocking surfaces constrain the move before any query is spent
+	const FVector Start = Root->GetComponentLocation();
+	FVector Delta = FlightState.Location - Start;
+	ClipToContactPlane(Start, Delta);
+
+	if (bAsync)
 	{
-		float RollAmount = MovementInput.Y * DroneConfig->MaxRollAngle;
-		TargetRotation.Roll = FMath::FInterpTo(CurrentRotation.Roll, RollAmount, DeltaTime, 5.0f);
+		Root->SetWorldLocationAndRotation(Start + Delta, Rotation);
+		RequestAsyncSweep(Root);
+	}
+	else if (Delta.IsNearlyZero(KINDA_SMALL_NUMBER))
+	{
+		// Pinned against a wall or hovering: no sweep needed to turn in place
+		Root->SetWorldRotation(Rotation);
 	}
 	else
 	{
-		TargetRotation.Roll = FMath::FInterpTo(CurrentRotation.Roll, 0.0f, DeltaTime, 5.0f);
+		SlideAlongSurfaces(Root, Delta, Rotation);
 	}
 
-	GetOwner()->SetActorRotation(TargetRotation);
+	// Collision may have stopped short of the simulated location
+	FlightState.Location = Root->GetComponentLocation();
 }
 
-void UDroneMovementComponent::Server_SendInput_Implementation(FDroneInputState Input)
+void UDroneMovementComponent::SlideAlongSurfaces(USceneComponent* Root, FVector Delta, const FQuat& Rotation)
 {
-	// Server validates and applies input
-	MovementInput = Input.MovementInput.GetClampedToMaxSize(1.0f);
-	LookInput = Input.LookInput;
+	FVector PreviousNormal = FVector::ZeroVector;
 
-	// Security: clamp values
-	if (!DroneConfig)
+	for (int32 Iteration = 0; Iteration < MaxSlideIterations; ++Iteration)
+	{
+		FHitResult Hit;
+		Root->MoveComponent(Delta, Rotation, true, &Hit);
+
+		if (Hit.bStartPenetrating)
+		{
+			// Push out along the penetration normal, then retry the move
+			Root->MoveComponent(Hit.Normal * (Hit.PenetrationDepth + CollisionSkinWidth), Rotation, false, nullptr, MOVECOMP_NoFlags, ETeleportType::TeleportPhysics);
+			continue;
+		}
+
+		if (!Hit.IsValidBlockingHit())
+			break;
+
+		SetContact(Hit);
+
+		// Keep only the motion along the surface
+		FVector Remaining = FVector::VectorPlaneProject(Delta * (1.0f - Hit.Time), Hit.Normal);
+
+		// In a crease, sliding off one surface pushes into the other; follow their intersection
+		if (Iteration > 0 && (Remaining | PreviousNormal) < 0.0f)
+		{
+			const FVector Crease = (PreviousNormal ^ Hit.Normal).GetSafeNormal();
+			Remaining = Crease * (Remaining | Crease);
+			FlightState.Velocity = Crease * (FlightState.Velocity | Crease);
+		}
+
+		PreviousNormal = Hit.Normal;
+		Delta = Remaining;
+
+		if (Delta.IsNearlyZero(KINDA_SMALL_NUMBER))
+			break;
+	}
+}
+
+void UDroneMovementComponent::ClipToContactPlane(const FVector& Start, FVector& Delta)
+{
+	if (!bHasContact)
+		return;
+
+	// Expired contacts are re-checked by a full sweep
+	if (GetWorld()->GetTimeSeconds() - ContactTime > ContactRetestInterval)
+	{
+		bHasContact = false;
+		return;
+	}
+
+	const float Into = -(Delta | ContactNormal);
+	if (Into <= 0.0f)
+		return;
+
+	const float Clearance = FMath::Max(((Start - ContactPoint) | ContactNormal) - CollisionSkinWidth, 0.0f);
+	if (Into <= Clearance)
+		return;
+
+	Delta += ContactNormal * (Into - Clearance);
+
+	// Velocity into the surface would only be clipped again next frame and mispredict
+	if ((FlightState.Velocity | ContactNormal) < 0.0f)
+	{
+		FlightState.Velocity = FVector::VectorPlaneProject(FlightState.Velocity, ContactNormal);
+	}
+}
+
+void UDroneMovementComponent::SetContact(const FHitResult& Hit)
+{
+	ContactNormal = Hit.Normal;
+	ContactPoint = Hit.Location;
+	ContactTime = GetWorld()->GetTimeSeconds();
+	bHasContact = true;
+
+	if ((FlightState.Velocity | Hit.Normal) < 0.0f)
+	{
+		FlightState.Velocity = FVector::VectorPlaneProject(FlightState.Velocity, Hit.Normal);
+	}
+}
+
+void UDroneMovementComponent::ConsumeAsyncSweep(USceneComponent* Root)
+{
+	FTraceDatum Result;
+	if (!PendingSweep.IsValid() || !GetWorld()->QueryTraceData(PendingSweep, Result))
 		return;
 
-	float MaxSpeed = GetMaxSpeed();
-	if (Velocity.Size() > MaxSpeed * 1.5f) // Allow some tolerance
+	PendingSweep.Invalidate();
+
+	for (const FHitResult& Hit : Result.OutHits)
 	{
-		Velocity = Velocity.GetSafeNormal() * MaxSpeed;
+		if (!Hit.bBlockingHit)
+			continue;
+
+		if (Hit.bStartPenetrating)
+		{
+			Root->MoveComponent(Hit.Normal * (Hit.PenetrationDepth + CollisionSkinWidth), Root->GetComponentQuat(), false, nullptr, MOVECOMP_NoFlags, ETeleportType::TeleportPhysics);
+		}
+		else
+		{
+			SetContact(Hit);
+		}
+		break;
 	}
+}
+
+void UDroneMovementComponent::RequestAsyncSweep(USceneComponent* Root)
+{
+	UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Root);
+	const FVector Start = Root->GetComponentLocation();
+	const FVector End = Start + FlightState.Velocity * AsyncSweepLookahead;
+
+	// Hovering drones spend nothing
+	if (!Primitive || Start.Equals(End, KINDA_SMALL_NUMBER))
+		return;
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(DroneAsyncSweep), false, GetOwner());
+	FCollisionResponseParams ResponseParams;
+	Primitive->InitSweepCollisionParams(Params, ResponseParams);
 
-	// Store input ID for correction
-	ServerSnapshot.InputID = Input.InputID;
+	// The engine runs all async traces of a frame together; results are read next frame
+	PendingSweep = GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, Root->GetComponentQuat(),
+		Primitive->GetCollisionObjectType(), Primitive->GetCollisionShape(), Params, ResponseParams);
 }
 
-bool UDroneMovementComponent::Server_SendInput_Validate(FDroneInputState Input)
+void UDroneMovementComponent::Server_SendInputs_Implementation(const FDroneInputPacket& Packet)
 {
-	// Basic validation
-	return Input.MovementInput.Size() <= 1.5f; // Allow some tolerance for floating point
+	if (Packet.bHasClockPing)
+	{
+		bHasPendingClockPing = true;
+		PendingClockPingTicks = Packet.ClockPingTicks;
+		PendingClockPingTime = GetServerTime();
+	}
+
+	const float TimestampCorrection = Packet.GetTimestampCorrection(GetServerTime());
+
+	for (const FDroneInputState& Input : Packet.Inputs)
+	{
+		// Dedupe: redundant copies of consumed or already buffered inputs are dropped
+		if (bHasConsumedInput && !ServerInputBuffer.IsBefore(LastConsumedInputID, Input.InputID))
+			continue;
+
+		// Nothing honest runs a whole buffer ahead of the last consumed move
+		if (bHasConsumedInput && Input.InputID - LastConsumedInputID > ServerInputBuffer.GetCapacity())
+			continue;
+
+		if (ServerInputBuffer.Contains(Input.InputID))
+			continue;
+
+		if (FDroneInputState* Buffered = ServerInputBuffer.Add(Input.InputID, Input))
+		{
+			Buffered->Timestamp += TimestampCorrection;
+		}
+	}
 }
 
-void UDroneMovementComponent::Client_ReceiveCorrection_Implementation(FDroneMovementSnapshot ServerSnapshot)
+bool UDroneMovementComponent::Server_SendInputs_Validate(const FDroneInputPacket& Packet)
 {
-	ReconcileWithServer(ServerSnapshot);
+	if (Packet.Inputs.Num() > FDroneInputPacket::MaxInputs)
+		return false;
+
+	for (const FDroneInputState& Input : Packet.Inputs)
+	{
+		// Clients clamp to unit length before quantizing, so per-axis rounding adds well under 1%.
+		// DeltaTime needs no check here: it is unsigned on the wire and the move time budget bounds it.
+		if (Input.MovementInput.Size() > 1.5f)
+			return false;
+	}
+
+	return true;
+}
+
+void UDroneMovementComponent::Client_ReceiveCorrection_Implementation(FDroneMovementSnapshot InServerSnapshot)
+{
+	InServerSnapshot.InputID = FDroneMovementSnapshot::ExpandInputID(InServerSnapshot.InputID, MoveHistory.GetNextID());
+	InServerSnapshot.Timestamp = FDroneMovementSnapshot::ExpandTimestamp(InServerSnapshot.Timestamp, GetServerTime());
+	ReconcileWithServer(InServerSnapshot);
 }
 
 void UDroneMovementComponent::OnRep_ServerSnapshot()
 {
-	if (GetOwner() && GetOwner()->GetLocalRole() == ROLE_AutonomousProxy)
+	// Widen the wrapped wire timestamp against the shared server clock
+	ServerSnapshot.Timestamp = FDroneMovementSnapshot::ExpandTimestamp(ServerSnapshot.Timestamp, GetServerTime());
+
+	if (GetOwner() && GetOwner()->GetLocalRole() == ROLE_SimulatedProxy)
 	{
+		ProxyInterpolator.AddSnapshot(ServerSnapshot, GetServerTime());
+	}
+	else if (GetOwner() && GetOwner()->GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		// Widen the 16-bit wire sequence against our own input counter
+		ServerSnapshot.InputID = FDroneMovementSnapshot::ExpandInputID(ServerSnapshot.InputID, MoveHistory.GetNextID());
 		ReconcileWithServer(ServerSnapshot);
 	}
 }
@@ -283,83 +934,174 @@ void UDroneMovementComponent::ReconcileWithServer(const FDroneMovementSnapshot&
 	if (!GetOwner())
 		return;
 
-	// Find the client snapshot that corresponds to the server snapshot
-	int32 SnapshotIndex = ClientSnapshots.IndexOfByPredicate([&](const FDroneMovementSnapshot& Snap) {
-		return Snap.InputID == InServerSnapshot.InputID;
-	});
-
-	if (SnapshotIndex == INDEX_NONE)
+	// Find the prediction that corresponds to the server snapshot
+	const FDroneMoveRecord* Record = MoveHistory.Find(InServerSnapshot.InputID);
+	if (!Record)
 		return;
 
 	// Check if there's a significant error
-	FVector PositionError = InServerSnapshot.Location - ClientSnapshots[SnapshotIndex].Location;
+	FVector PositionError = InServerSnapshot.Location - Record->PredictedSnapshot.Location;
 	float ErrorMagnitude = PositionError.Size();
+	const float Tolerance = GetCorrectionTolerance(InServerSnapshot.Velocity);
+	const EDroneSpeedMode PredictedSpeedMode = Record->Input.SpeedMode;
+	const EDroneVisionMode PredictedVisionMode = Record->Input.VisionMode;
+
+	// Everything up to the acknowledged input is settled
+	MoveHistory.Acknowledge(InServerSnapshot.InputID);
 
-	if (ErrorMagnitude > 50.0f) // Threshold for correction
+	// A mode the server overrode changes every later prediction
+	const bool bModesMatch = PredictedSpeedMode == InServerSnapshot.SpeedMode && PredictedVisionMode == InServerSnapshot.VisionMode;
+	if (!bModesMatch)
 	{
-		// Snap to server position
-		GetOwner()->SetActorLocation(InServerSnapshot.Location);
-		GetOwner()->SetActorRotation(InServerSnapshot.Rotation);
-		Velocity = InServerSnapshot.Velocity;
+		RollbackPredictedModes(PredictedSpeedMode, PredictedVisionMode, InServerSnapshot);
+	}
+
+	if (ErrorMagnitude <= Tolerance && bModesMatch)
+		return;
 
-		// Remove old inputs
-		int32 InputIndex = PendingInputs.IndexOfByPredicate([&](const FDroneInputState& Input) {
-			return Input.InputID == InServerSnapshot.InputID;
-		});
+	++CorrectionCount;
+	LastCorrectionError = ErrorMagnitude;
 
-		if (InputIndex != INDEX_NONE)
-		{
-			PendingInputs.RemoveAt(0, InputIndex + 1);
-			ClientSnapshots.RemoveAt(0, SnapshotIndex + 1);
-
-			// Replay remaining inputs
-			for (const FDroneInputState& Input : PendingInputs)
-			{
-				SimulateMovement(Input.DeltaTime, Input);
-				ApplyMovement(Input.DeltaTime);
-			}
-		}
+	// Where the player currently sees the drone
+	FVector StepLocationOffset;
+	FQuat StepRotationOffset;
+	GetStepInterpolationOffset(StepLocationOffset, StepRotationOffset);
+	const FVector OldVisualLocation = FlightState.Location + VisualLocationOffset + StepLocationOffset;
+	const FQuat OldVisualRotation = VisualRotationOffset * StepRotationOffset * FlightState.Rotation.Quaternion();
+
+	// Rewind flight state to the server result
+	FlightState = FDroneFlightState(InServerSnapshot.Location, InServerSnapshot.Rotation, InServerSnapshot.Velocity);
+	PreviousFlightState = FlightState;
+
+	// Replay remaining inputs on the flight state only, refreshing their predictions
+	FDroneMoveRecord* LastPending = nullptr;
+	for (uint32 InputID = MoveHistory.GetOldestID(); InputID != MoveHistory.GetNextID(); ++InputID)
+	{
+		FDroneMoveRecord* Pending = MoveHistory.Find(InputID);
+		if (!Pending)
+			continue;
+
+		PreviousFlightState = FlightState;
+		SimulateMovement(Pending->Input.DeltaTime, Pending->Input);
+		Pending->PredictedSnapshot.Location = FlightState.Location;
+		Pending->PredictedSnapshot.Rotation = FlightState.Rotation;
+		Pending->PredictedSnapshot.Velocity = FlightState.Velocity;
+		LastPending = Pending;
+	}
+
+	// One sweep-and-slide from the server location to the replayed result keeps the
+	// correction out of walls. The cached contact plane belongs to the old prediction.
+	GetOwner()->SetActorLocationAndRotation(InServerSnapshot.Location, FlightState.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	bHasContact = false;
+	ApplyMovement();
+
+	if (LastPending)
+	{
+		LastPending->PredictedSnapshot.Location = FlightState.Location;
+		LastPending->PredictedSnapshot.Velocity = FlightState.Velocity;
+	}
+
+	// Keep the visuals where they were and let the difference decay
+	GetStepInterpolationOffset(StepLocationOffset, StepRotationOffset);
+	VisualLocationOffset = OldVisualLocation - FlightState.Location - StepLocationOffset;
+	VisualRotationOffset = OldVisualRotation * (StepRotationOffset * FlightState.Rotation.Quaternion()).Inverse();
+
+	if (!VisualComponent || VisualLocationOffset.Size() > MaxSmoothedCorrection)
+	{
+		VisualLocationOffset = FVector::ZeroVector;
+		VisualRotationOffset = FQuat::Identity;
 	}
 }
 
-float UDroneMovementComponent::GetMaxSpeed() const
+void UDroneMovementComponent::RollbackPredictedModes(EDroneSpeedMode PredictedSpeedMode, EDroneVisionMode PredictedVisionMode, const FDroneMovementSnapshot& InServerSnapshot)
 {
-	if (!DroneConfig)
-		return 600.0f;
+	// Pending inputs still holding the rejected mode take the server's; the first
+	// later toggle is a new request and is kept along with everything after it
+	bool bSpeedRolledBack = PredictedSpeedMode != InServerSnapshot.SpeedMode;
+	bool bVisionRolledBack = PredictedVisionMode != InServerSnapshot.VisionMode;
 
-	return (SpeedMode == EDroneSpeedMode::High) ? DroneConfig->MaxSpeedHigh : DroneConfig->MaxSpeedLow;
+	for (uint32 InputID = MoveHistory.GetOldestID(); InputID != MoveHistory.GetNextID(); ++InputID)
+	{
+		FDroneMoveRecord* Pending = MoveHistory.Find(InputID);
+		if (!Pending)
+			continue;
+
+		bSpeedRolledBack &= Pending->Input.SpeedMode == PredictedSpeedMode;
+		bVisionRolledBack &= Pending->Input.VisionMode == PredictedVisionMode;
+
+		if (bSpeedRolledBack)
+		{
+			Pending->Input.SpeedMode = InServerSnapshot.SpeedMode;
+		}
+		if (bVisionRolledBack)
+		{
+			Pending->Input.VisionMode = InServerSnapshot.VisionMode;
+		}
+	}
+
+	// No newer toggle: the live state follows the server too
+	if (bSpeedRolledBack)
+	{
+		SpeedMode = InServerSnapshot.SpeedMode;
+	}
+	if (bVisionRolledBack && VisionComponent)
+	{
+		VisionComponent->SetPredictedVisionMode(InServerSnapshot.VisionMode);
+	}
 }
 
-float UDroneMovementComponent::GetAcceleration() const
+float UDroneMovementComponent::GetCorrectionTolerance(const FVector& AtVelocity) const
 {
-	if (!DroneConfig)
-		return 1000.0f;
-
-	return DroneConfig->Acceleration;
+	return CorrectionErrorThreshold + AtVelocity.Size() * CorrectionVelocityTolerance;
 }
 
-FVector UDroneMovementComponent::CalculateDesiredVelocity(const FVector& Input) const
+void UDroneMovementComponent::UpdateVisualOffset(float DeltaTime)
 {
-	if (!GetOwner())
-		return FVector::ZeroVector;
+	if (!VisualComponent || !GetOwner())
+		return;
+
+	FVector StepLocationOffset;
+	FQuat StepRotationOffset;
+	GetStepInterpolationOffset(StepLocationOffset, StepRotationOffset);
+
+	const bool bHasOffset = !VisualLocationOffset.IsNearlyZero(0.01f) || !VisualRotationOffset.Equals(FQuat::Identity, 1.e-4f)
+		|| !StepLocationOffset.IsNearlyZero(0.01f) || !StepRotationOffset.Equals(FQuat::Identity, 1.e-4f);
+	if (!bHasOffset && VisualComponent->GetRelativeTransform().Equals(VisualBaseTransform))
+		return;
 
-	// Convert input to world space
-	FRotator ActorRotation = GetOwner()->GetActorRotation();
-	FVector Forward = FRotationMatrix(ActorRotation).GetScaledAxis(EAxis::X);
-	FVector Right = FRotationMatrix(ActorRotation).GetScaledAxis(EAxis::Y);
-	FVector Up = FVector::UpVector;
+	// Exponential decay, frame rate independent
+	const float Decay = (CorrectionSmoothingTime > KINDA_SMALL_NUMBER) ? FMath::Exp(-3.0f * DeltaTime / CorrectionSmoothingTime) : 0.0f;
+	VisualLocationOffset *= Decay;
+	VisualRotationOffset = FQuat::Slerp(FQuat::Identity, VisualRotationOffset, Decay);
 
-	FVector WorldInput = (Forward * Input.X) + (Right * Input.Y) + (Up * Input.Z);
-	WorldInput = WorldInput.GetClampedToMaxSize(1.0f);
+	const FTransform RootTransform = GetOwner()->GetActorTransform();
+	const FTransform BaseWorld = VisualBaseTransform * RootTransform;
 
-	return WorldInput * GetMaxSpeed();
+	VisualComponent->SetWorldLocationAndRotation(
+		BaseWorld.GetLocation() + VisualLocationOffset + StepLocationOffset,
+		VisualRotationOffset * StepRotationOffset * BaseWorld.GetRotation());
 }
 
-void UDroneMovementComponent::ClampVelocity()
+void UDroneMovementComponent::GetStepInterpolationOffset(FVector& OutLocation, FQuat& OutRotation) const
 {
-	float MaxSpeed = GetMaxSpeed();
-	if (Velocity.Size() > MaxSpeed)
+	if (!bInterpolateSteps)
 	{
-		Velocity = Velocity.GetSafeNormal() * MaxSpeed;
+		OutLocation = FVector::ZeroVector;
+		OutRotation = FQuat::Identity;
+		return;
 	}
+
+	// The root holds the newest step; draw the drone the accumulated fraction of the way there
+	const float Alpha = StepAccumulator.GetAlpha();
+	const FQuat Rotation = FlightState.Rotation.Quaternion();
+	OutLocation = (PreviousFlightState.Location - FlightState.Location) * (1.0f - Alpha);
+	OutRotation = FQuat::Slerp(PreviousFlightState.Rotation.Quaternion(), Rotation, Alpha) * Rotation.Inverse();
+}
+
+float UDroneMovementComponent::GetMaxSpeed() const
+{
+	if (!DroneConfig)
+		return 600.0f;
+
+	return (SpeedMode == EDroneSpeedMode::High) ? DroneConfig->MaxSpeedHigh : DroneConfig->MaxSpeedLow;
 }
@@ -0,0 +1,584 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneMovementWorldSubsystem.h"
+#include "DroneMovementComponent.h"
+#include "DroneAsyncFlightCallback.h"
+#include "DroneNetClockSubsystem.h"
+#include "DroneAIController.h"
+#include "DroneSystemPro.h"
+#include "Async/ParallelFor.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PBDRigidsSolver.h"
+
+DECLARE_CYCLE_STAT(TEXT("Batched Movement Gather"), STAT_DroneBatchGather, STATGROUP_DroneSystem);
+DECLARE_CYCLE_STAT(TEXT("Batched Movement Integrate"), STAT_DroneBatchIntegrate, STATGROUP_DroneSystem);
+DECLARE_CYCLE_STAT(TEXT("Batched Movement Write Back"), STAT_DroneBatchWriteBack, STATGROUP_DroneSystem);
+DECLARE_CYCLE_STAT(TEXT("Movement Significance"), STAT_DroneSignificance, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Drones"), STAT_DroneBatchCount, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement LOD Full"), STAT_DroneLODFull, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement LOD Reduced"), STAT_DroneLODReduced, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement LOD Rail"), STAT_DroneLODRail, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Physics Drones"), STAT_DroneAsyncCount, STATGROUP_DroneSystem);
+
+namespace DroneBatchSettings
+{
+	// Drones per ParallelFor task; below this the scheduling overhead outweighs the work.
+	// Must stay a multiple of FDroneFlightBatch::LaneWidth.
+	constexpr int32 ChunkSize = 64;
+
+	// Longest delta a coarse step may cover, e.g. after a hitch
+	constexpr float MaxCoarseDeltaTime = 1.0f;
+
+	// Screen size estimate assumes a 90 degree field of view
+	constexpr float ViewConeCos = 0.7071f;
+}
+
+UDroneMovementWorldSubsystem::UDroneMovementWorldSubsystem()
+{
+	FullSignificance = 0.01f;		// 40 unit drone at ~40m
+	ReducedSignificance = 0.0008f;	// ~500m
+	SignificanceHysteresis = 0.25f;
+	SignificanceInterval = 0.25f;
+	OffscreenScale = 0.25f;
+	EngagedScale = 2.0f;
+	ReducedUpdateInterval = 0.1f;
+	RailUpdateInterval = 0.5f;
+	AsyncCorrectionTolerance = 1.0f;
+}
+
+TStatId UDroneMovementWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDroneMovementWorldSubsystem, STATGROUP_Tickables);
+}
+
+void UDroneMovementWorldSubsystem::Deinitialize()
+{
+	ReleaseAsyncCallback();
+
+	for (UDroneMovementComponent* Component : Components)
+	{
+		if (Component)
+		{
+			Component->BatchIndex = INDEX_NONE;
+			Component->MovementLOD = EDroneMovementLOD::Full;
+		}
+	}
+
+	Components.Reset();
+	UpdatedComponents.Reset();
+	Configs.Reset();
+	LODs.Reset();
+	Significance.Reset();
+	PendingTime.Reset();
+	AsyncSlots.Reset();
+	AsyncDrones.Reset();
+	Batch.SetNum(0);
+
+	Super::Deinitialize();
+}
+
+void UDroneMovementWorldSubsystem::RegisterComponent(UDroneMovementComponent* Component)
+{
+	if (!Component || Component->BatchIndex != INDEX_NONE || !Component->GetOwner())
+		return;
+
+	Component->BatchIndex = Components.Add(Component);
+	UpdatedComponents.Add(Component->GetOwner()->GetRootComponent());
+	Configs.Add(Component->GetFlightConfig());
+	LODs.Add(EDroneMovementLOD::Full);
+	Significance.Add(0.0f);
+	PendingTime.Add(0.0f);
+	AsyncSlots.AddDefaulted_GetRef().DroneID = Component->GetUniqueID();
+
+	Component->MovementLOD = EDroneMovementLOD::Full;
+	Component->SetComponentTickEnabled(false);
+
+	// Score newcomers on the next tick
+	NextSignificanceTime = 0.0f;
+}
+
+void UDroneMovementWorldSubsystem::UnregisterComponent(UDroneMovementComponent* Component)
+{
+	if (!Component || !Components.IsValidIndex(Component->BatchIndex) || Components[Component->BatchIndex] != Component)
+		return;
+
+	RemoveAtSwap(Component->BatchIndex);
+	Component->BatchIndex = INDEX_NONE;
+	Component->MovementLOD = EDroneMovementLOD::Full;
+	Component->SetComponentTickEnabled(Component->IsSimulationEnabled());
+}
+
+void UDroneMovementWorldSubsystem::UpdateFlightConfig(const UDroneMovementComponent* Component, const FDroneFlightConfig& Config)
+{
+	if (!Component || !Components.IsValidIndex(Component->BatchIndex) || Components[Component->BatchIndex] != Component)
+		return;
+
+	Configs[Component->BatchIndex] = Config;
+}
+
+int32 UDroneMovementWorldSubsystem::GetNumDronesInLOD(EDroneMovementLOD LOD) const
+{
+	return LODCounts[static_cast<int32>(LOD)];
+}
+
+void UDroneMovementWorldSubsystem::RemoveAtSwap(int32 Index)
+{
+	ReleaseAsyncSlot(Index);
+
+	Components.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	UpdatedComponents.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Configs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	LODs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Significance.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PendingTime.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	AsyncSlots.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	// The last drone moved into the hole
+	if (Components.IsValidIndex(Index) && Components[Index])
+	{
+		Components[Index]->BatchIndex = Index;
+	}
+}
+
+void UDroneMovementWorldSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SET_DWORD_STAT(STAT_DroneBatchCount, Components.Num());
+
+	if (GetWorld()->GetTimeSeconds() >= NextSignificanceTime)
+	{
+		UpdateSignificance();
+		NextSignificanceTime = GetWorld()->GetTimeSeconds() + SignificanceInterval;
+	}
+
+	GatherState(DeltaTime);
+	ReceiveAsyncResults(DeltaTime);
+	Integrate(DeltaTime);
+	WriteBack();
+}
+
+void UDroneMovementWorldSubsystem::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DroneSignificance);
+
+	struct FViewer
+	{
+		FVector Location;
+		FVector Direction;
+	};
+
+	TArray<FViewer, TInlineAllocator<16>> Viewers;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			Viewers.Add({ Location, Rotation.Vector() });
+		}
+	}
+
+	LODCounts[0] = LODCounts[1] = LODCounts[2] = 0;
+
+	for (int32 Index = 0; Index < Components.Num(); ++Index)
+	{
+		UDroneMovementComponent* Component = Components[Index];
+		const USceneComponent* Root = UpdatedComponents[Index];
+		if (!Component || !Root)
+			continue;
+
+		const FVector Location = Root->GetComponentLocation();
+		const float Radius = FMath::Max(static_cast<float>(Root->Bounds.SphereRadius), 1.0f);
+
+		// Approximate screen radius fraction for the best placed viewer
+		float Score = 0.0f;
+		for (const FViewer& Viewer : Viewers)
+		{
+			const FVector ToDrone = Location - Viewer.Location;
+			const float Distance = FMath::Max(static_cast<float>(ToDrone.Size()), 1.0f);
+			const bool bInView = (ToDrone | Viewer.Direction) >= Distance * DroneBatchSettings::ViewConeCos;
+			Score = FMath::Max(Score, (Radius / Distance) * (bInView ? 1.0f : OffscreenScale));
+		}
+
+		// Drones engaging a target stay detailed further out
+		if (const APawn* Pawn = Cast<APawn>(Component->GetOwner()))
+		{
+			if (const ADroneAIController* AIController = Cast<ADroneAIController>(Pawn->GetController()))
+			{
+				const EDroneBehaviorType Behavior = AIController->GetCurrentBehavior();
+				if (Behavior == EDroneBehaviorType::Follow || Behavior == EDroneBehaviorType::AttackMark)
+				{
+					Score *= EngagedScale;
+				}
+			}
+		}
+
+		Significance[Index] = Score;
+		LODs[Index] = SelectLOD(LODs[Index], Score);
+		Component->MovementLOD = LODs[Index];
+		++LODCounts[static_cast<int32>(LODs[Index])];
+	}
+
+	SET_DWORD_STAT(STAT_DroneLODFull, LODCounts[0]);
+	SET_DWORD_STAT(STAT_DroneLODReduced, LODCounts[1]);
+	SET_DWORD_STAT(STAT_DroneLODRail, LODCounts[2]);
+}
+
+EDroneMovementLOD UDroneMovementWorldSubsystem::SelectLOD(EDroneMovementLOD Current, float Score) const
+{
+	auto TierForScale = [this, Score](float Scale)
+	{
+		if (Score >= FullSignificance * Scale)
+			return EDroneMovementLOD::Full;
+		if (Score >= ReducedSignificance * Scale)
+			return EDroneMovementLOD::Reduced;
+		return EDroneMovementLOD::Rail;
+	};
+
+	// Promote only past the raised thresholds, demote only past the lowered ones
+	const EDroneMovementLOD Promoted = TierForScale(1.0f + SignificanceHysteresis);
+	const EDroneMovementLOD Demoted = TierForScale(1.0f - SignificanceHysteresis);
+
+	if (Promoted < Current)
+		return Promoted;
+	if (Demoted > Current)
+		return Demoted;
+	return Current;
+}
+
+float UDroneMovementWorldSubsystem::GetUpdateInterval(EDroneMovementLOD LOD) const
+{
+	switch (LOD)
+	{
+	case EDroneMovementLOD::Reduced:
+		return ReducedUpdateInterval;
+	case EDroneMovementLOD::Rail:
+		return RailUpdateInterval;
+	default:
+		return 0.0f;
+	}
+}
+
+void UDroneMovementWorldSubsystem::GatherState(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DroneBatchGather);
+
+	// Hand back drones that were destroyed or became remotely controlled
+	for (int32 Index = Components.Num() - 1; Index >= 0; --Index)
+	{
+		UDroneMovementComponent* Component = Components[Index];
+		if (!Component || !UpdatedComponents[Index])
+		{
+			if (Component)
+			{
+				Component->BatchIndex = INDEX_NONE;
+			}
+			RemoveAtSwap(Index);
+		}
+		else if (!Component->CanUseBatchedSimulation())
+		{
+			UnregisterComponent(Component);
+		}
+	}
+
+	FullDrones.Reset();
+	CoarseDrones.Reset();
+	CoarseStates.Reset();
+	CoarseInputs.Reset();
+	CoarseDeltaTimes.Reset();
+	AsyncDrones.Reset();
+
+	for (int32 Index = 0; Index < Components.Num(); ++Index)
+	{
+		const UDroneMovementComponent* Component = Components[Index];
+
+		// Inactive drones do not bank time
+		if (!Component->IsSimulationEnabled() || !Component->DroneConfig)
+		{
+			PendingTime[Index] = 0.0f;
+			ReleaseAsyncSlot(Index);
+			continue;
+		}
+
+		// The physics thread steps these at its own fixed rate regardless of LOD
+		if (Component->bUseAsyncPhysicsSimulation && EnsureAsyncCallback())
+		{
+			AsyncDrones.Add(Index);
+			PendingTime[Index] = 0.0f;
+			continue;
+		}
+
+		PendingTime[Index] += DeltaTime;
+
+		const EDroneMovementLOD LOD = LODs[Index];
+		const bool bFullRate = (LOD == EDroneMovementLOD::Full) && PendingTime[Index] <= DeltaTime + KINDA_SMALL_NUMBER;
+
+		// Newly promoted drones catch up their banked time in one coarse step first
+		if (!bFullRate && LOD != EDroneMovementLOD::Full && PendingTime[Index] < GetUpdateInterval(LOD))
+			continue;
+
+		if (bFullRate)
+		{
+			FullDrones.Add(Index);
+		}
+		else
+		{
+			CoarseDrones.Add(Index);
+			CoarseDeltaTimes.Add(FMath::Min(PendingTime[Index], DroneBatchSettings::MaxCoarseDeltaTime));
+		}
+
+		PendingTime[Index] = 0.0f;
+	}
+
+	Batch.SetNum(FullDrones.Num());
+	BatchMaxSubstepDeltaTime = 1.0f / 60.0f;
+	BatchMaxSubsteps = 1;
+
+	auto GatherDrone = [this](int32 Index, FDroneFlightState& OutState, FDroneFlightInput& OutInput)
+	{
+		UDroneMovementComponent* Component = Components[Index];
+
+		// Pick up external teleports (docking, spawning) before integrating
+		OutState = FDroneFlightState(
+			UpdatedComponents[Index]->GetComponentLocation(),
+			UpdatedComponents[Index]->GetComponentRotation(),
+			Component->FlightState.Velocity);
+		OutInput = FDroneFlightInput(Component->MovementInput, Component->LookInput, Component->SpeedMode);
+		OutInput.WindVelocity = Component->SampleWind(OutState.Location);
+		Component->SampleObstacles(OutState.Location, OutInput);
+		Component->ApplyAltitudeHold(OutState, OutInput);
+	};
+
+	for (int32 Lane = 0; Lane < FullDrones.Num(); ++Lane)
+	{
+		const int32 Index = FullDrones[Lane];
+		const FDroneFlightConfig& Config = Configs[Index];
+
+		FDroneFlightState State;
+		FDroneFlightInput Input;
+		GatherDrone(Index, State, Input);
+		Batch.SetDrone(Lane, State, Input, Config);
+
+		BatchMaxSubstepDeltaTime = FMath::Min(BatchMaxSubstepDeltaTime, Config.MaxSubstepDeltaTime);
+		BatchMaxSubsteps = FMath::Max(BatchMaxSubsteps, Config.MaxSubsteps);
+	}
+
+	CoarseStates.SetNum(CoarseDrones.Num());
+	CoarseInputs.SetNum(CoarseDrones.Num());
+	for (int32 Slot = 0; Slot < CoarseDrones.Num(); ++Slot)
+	{
+		GatherDrone(CoarseDrones[Slot], CoarseStates[Slot], CoarseInputs[Slot]);
+	}
+
+	PushAsyncInputs();
+}
+
+void UDroneMovementWorldSubsystem::Integrate(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DroneBatchIntegrate);
+
+	// Lanes are independent, so each task runs every substep over its own chunk
+	const int32 NumPadded = Batch.NumPadded();
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumPadded, DroneBatchSettings::ChunkSize);
+
+	ParallelFor(TEXT("DroneBatchedMovement"), NumChunks, 1, [this, DeltaTime, NumPadded](int32 ChunkIndex)
+	{
+		const int32 StartIndex = ChunkIndex * DroneBatchSettings::ChunkSize;
+		const int32 EndIndex = FMath::Min(StartIndex + DroneBatchSettings::ChunkSize, NumPadded);
+
+		FDroneFlightBatchKernel::Simulate(Batch, StartIndex, EndIndex, DeltaTime, BatchMaxSubstepDeltaTime, BatchMaxSubsteps);
+	});
+
+	// Coarse drones are few per frame and each carries its own delta
+	for (int32 Slot = 0; Slot < CoarseDrones.Num(); ++Slot)
+	{
+		const int32 Index = CoarseDrones[Slot];
+		if (LODs[Index] == EDroneMovementLOD::Rail)
+		{
+			FDroneFlightModel::StepRail(CoarseStates[Slot], CoarseInputs[Slot], Configs[Index], CoarseDeltaTimes[Slot]);
+		}
+		else
+		{
+			FDroneFlightModel::Simulate(CoarseStates[Slot], CoarseInputs[Slot], Configs[Index], CoarseDeltaTimes[Slot]);
+		}
+	}
+}
+
+void UDroneMovementWorldSubsystem::WriteBack()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DroneBatchWriteBack);
+
+	const float Timestamp = UDroneNetClockSubsystem::GetServerTime(GetWorld());
+
+	for (int32 Lane = 0; Lane < FullDrones.Num(); ++Lane)
+	{
+		Components[FullDrones[Lane]]->FinishBatchedStep(Batch.GetState(Lane), Timestamp);
+	}
+
+	for (int32 Slot = 0; Slot < CoarseDrones.Num(); ++Slot)
+	{
+		Components[CoarseDrones[Slot]]->FinishBatchedStep(CoarseStates[Slot], Timestamp);
+	}
+
+	WriteBackAsync(Timestamp);
+}
+
+void FDroneAsyncFlightSlot::SyncFromGameThread(const FDroneFlightState& State, float Tolerance)
+{
+	// Spawns, teleports and collision all leave the root away from the presented location.
+	// Hold the resolved state until the physics thread answers from it.
+	if (bRegistered && PresentedLocation.Equals(State.Location, Tolerance))
+		return;
+
+	++StateSequence;
+	bRegistered = true;
+	Previous = Current = State;
+	PresentedLocation = State.Location;
+}
+
+bool FDroneAsyncFlightSlot::ApplyResult(const FDroneFlightState& State, uint32 ResultSequence)
+{
+	// Stepped from a state the game thread has since corrected
+	if (ResultSequence != StateSequence)
+		return false;
+
+	Previous = Current;
+	Current = State;
+	return true;
+}
+
+bool UDroneMovementWorldSubsystem::EnsureAsyncCallback()
+{
+	if (AsyncCallback)
+		return true;
+
+	const UPhysicsSettings* PhysicsSettings = UPhysicsSettings::Get();
+	FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+	if (!PhysicsSettings->bTickPhysicsAsync || !PhysScene || !PhysScene->GetSolver())
+	{
+		if (!bWarnedAsyncUnavailable)
+		{
+			UE_LOG(LogDroneSystem, Warning, TEXT("Async physics drone simulation needs Tick Physics Async enabled; using the game thread batch"));
+			bWarnedAsyncUnavailable = true;
+		}
+		return false;
+	}
+
+	AsyncCallback = PhysScene->GetSolver()->CreateAndRegisterSimCallbackObject_External<FDroneAsyncFlightCallback>();
+	AsyncFixedDeltaTime = FMath::Max(PhysicsSettings->AsyncFixedTimeStepSize, KINDA_SMALL_NUMBER);
+	TimeSinceAsyncResult = 0.0f;
+	return AsyncCallback != nullptr;
+}
+
+void UDroneMovementWorldSubsystem::ReleaseAsyncCallback()
+{
+	if (!AsyncCallback)
+		return;
+
+	if (FPhysScene* PhysScene = GetWorld()->GetPhysicsScene())
+	{
+		PhysScene->GetSolver()->UnregisterAndFreeSimCallbackObject_External(AsyncCallback);
+	}
+
+	AsyncCallback = nullptr;
+	AsyncRemovedDrones.Reset();
+}
+
+void UDroneMovementWorldSubsystem::ReleaseAsyncSlot(int32 Index)
+{
+	FDroneAsyncFlightSlot& Slot = AsyncSlots[Index];
+	if (!Slot.bRegistered)
+		return;
+
+	AsyncRemovedDrones.Add(Slot.DroneID);
+	Slot.bRegistered = false;
+}
+
+void UDroneMovementWorldSubsystem::PushAsyncInputs()
+{
+	SET_DWORD_STAT(STAT_DroneAsyncCount, AsyncDrones.Num());
+
+	if (!AsyncCallback || (AsyncDrones.Num() == 0 && AsyncRemovedDrones.Num() == 0))
+		return;
+
+	FDroneAsyncFlightInput* AsyncInput = AsyncCallback->GetProducerInputData_External();
+	AsyncInput->RemovedDrones.Append(AsyncRemovedDrones);
+	AsyncRemovedDrones.Reset();
+
+	for (const int32 Index : AsyncDrones)
+	{
+		UDroneMovementComponent* Component = Components[Index];
+		FDroneAsyncFlightSlot& Slot = AsyncSlots[Index];
+
+		FDroneAsyncDroneInput& DroneInput = AsyncInput->Drones.AddDefaulted_GetRef();
+		DroneInput.DroneID = Slot.DroneID;
+		DroneInput.Config = Configs[Index];
+		DroneInput.State = FDroneFlightState(
+			UpdatedComponents[Index]->GetComponentLocation(),
+			UpdatedComponents[Index]->GetComponentRotation(),
+			Component->FlightState.Velocity);
+		DroneInput.Input = FDroneFlightInput(Component->MovementInput, Component->LookInput, Component->SpeedMode);
+		DroneInput.Input.WindVelocity = Component->SampleWind(DroneInput.State.Location);
+		Component->SampleObstacles(DroneInput.State.Location, DroneInput.Input);
+		Component->ApplyAltitudeHold(DroneInput.State, DroneInput.Input);
+
+		Slot.SyncFromGameThread(DroneInput.State, AsyncCorrectionTolerance);
+		DroneInput.StateSequence = Slot.StateSequence;
+	}
+}
+
+void UDroneMovementWorldSubsystem::ReceiveAsyncResults(float DeltaTime)
+{
+	if (!AsyncCallback)
+		return;
+
+	TimeSinceAsyncResult += DeltaTime;
+
+	TMap<uint32, int32> IndexByID;
+	IndexByID.Reserve(AsyncDrones.Num());
+	for (const int32 Index : AsyncDrones)
+	{
+		IndexByID.Add(AsyncSlots[Index].DroneID, Index);
+	}
+
+	// Several fixed steps can finish in one game frame; keep the last two
+	while (Chaos::TSimCallbackOutputHandle<FDroneAsyncFlightOutput> Output = AsyncCallback->PopOutputData_External())
+	{
+		TimeSinceAsyncResult = 0.0f;
+
+		for (const FDroneAsyncDroneOutput& DroneOutput : Output->Drones)
+		{
+			const int32* Index = IndexByID.Find(DroneOutput.DroneID);
+			if (!Index)
+				continue;
+
+			AsyncSlots[*Index].ApplyResult(DroneOutput.State, DroneOutput.StateSequence);
+		}
+	}
+}
+
+void UDroneMovementWorldSubsystem::WriteBackAsync(float Timestamp)
+{
+	// Present one fixed step behind the newest result so there is always a pair to blend
+	const float Alpha = FMath::Clamp(TimeSinceAsyncResult / AsyncFixedDeltaTime, 0.0f, 1.0f);
+
+	for (const int32 Index : AsyncDrones)
+	{
+		FDroneAsyncFlightSlot& Slot = AsyncSlots[Index];
+
+		FDroneFlightState State(
+			FMath::Lerp(Slot.Previous.Location, Slot.Current.Location, Alpha),
+			FQuat::Slerp(Slot.Previous.Rotation.Quaternion(), Slot.Current.Rotation.Quaternion(), Alpha).Rotator(),
+			FMath::Lerp(Slot.Previous.Velocity, Slot.Current.Velocity, Alpha));
+
+		Slot.PresentedLocation = State.Location;
+		Components[Index]->FinishBatchedStep(State, Timestamp);
+	}
+}
@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneNetClockSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+
+void FDroneClockEstimator::Reset()
+{
+	NumSamples = 0;
+	NumOffsetSamples = 0;
+	RoundTripTime = 0.0f;
+	ClockOffset = 0.0f;
+}
+
+bool FDroneClockEstimator::AddSample(float RoundTrip, float Offset)
+{
+	// Judge the sample against the estimate before it moves
+	const bool bOutlier = NumOffsetSamples >= WarmupSamples && RoundTrip > RoundTripTime * OutlierScale + OutlierSlack;
+
+	// Running mean while warming up, then exponential
+	++NumSamples;
+	const float RoundTripAlpha = FMath::Max(Smoothing, 1.0f / NumSamples);
+	RoundTripTime = FMath::Lerp(RoundTripTime, RoundTrip, RoundTripAlpha);
+
+	if (bOutlier)
+		return false;
+
+	++NumOffsetSamples;
+	const float OffsetAlpha = FMath::Max(Smoothing, 1.0f / NumOffsetSamples);
+	ClockOffset = FMath::Lerp(ClockOffset, Offset, OffsetAlpha);
+	return true;
+}
+
+UDroneNetClockSubsystem::UDroneNetClockSubsystem()
+{
+	PingInterval = 0.5f;
+	Smoothing = 0.1f;
+	MinSamplesForSync = 3;
+	SyncBlendTime = 1.0f;
+	NextPingTime = 0.0f;
+	SyncTime = 0.0f;
+}
+
+float UDroneNetClockSubsystem::GetLocalTime() const
+{
+	return GetWorld()->GetTimeSeconds();
+}
+
+bool UDroneNetClockSubsystem::IsSynchronized() const
+{
+	return GetWorld()->GetNetMode() != NM_Client || Estimator.GetNumSamples() >= MinSamplesForSync;
+}
+
+float UDroneNetClockSubsystem::GetServerTime() const
+{
+	const UWorld* World = GetWorld();
+	if (World->GetNetMode() != NM_Client)
+		return World->GetTimeSeconds();
+
+	const AGameStateBase* GameState = World->GetGameState();
+	const float FallbackTime = GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+	if (Estimator.GetNumSamples() < MinSamplesForSync)
+		return FallbackTime;
+
+	// Ease over from the game state's time so input and mark timestamps do not jump at sync
+	const float LocalTime = GetLocalTime();
+	const float Alpha = (SyncBlendTime > KINDA_SMALL_NUMBER) ? FMath::Clamp((LocalTime - SyncTime) / SyncBlendTime, 0.0f, 1.0f) : 1.0f;
+	return FMath::Lerp(FallbackTime, LocalTime + Estimator.GetOffset(), Alpha);
+}
+
+float UDroneNetClockSubsystem::GetServerTime(const UWorld* World)
+{
+	if (!World)
+		return 0.0f;
+
+	const UDroneNetClockSubsystem* Clock = World->GetSubsystem<UDroneNetClockSubsystem>();
+	return Clock ? Clock->GetServerTime() : World->GetTimeSeconds();
+}
+
+bool UDroneNetClockSubsystem::ConsumePingSlot()
+{
+	const float Now = GetLocalTime();
+	if (Now < NextPingTime)
+		return false;
+
+	NextPingTime = Now + PingInterval;
+	return true;
+}
+
+void UDroneNetClockSubsystem::AddPingSample(float ClientSendTime, float ServerSendTime, float ServerHoldTime)
+{
+	const float ClientReceiveTime = GetLocalTime();
+	const float RoundTrip = FMath::Max(ClientReceiveTime - ClientSendTime - ServerHoldTime, 0.0f);
+
+	// The echo left the server half a round trip ago
+	Estimator.Smoothing = Smoothing;
+	Estimator.AddSample(RoundTrip, ServerSendTime + RoundTrip * 0.5f - ClientReceiveTime);
+
+	if (Estimator.GetNumSamples() == MinSamplesForSync)
+	{
+		SyncTime = ClientReceiveTime;
+	}
+}
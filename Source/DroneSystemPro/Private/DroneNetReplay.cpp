@@ -0,0 +1,316 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneNetReplay.h"
+#include "DroneBase.h"
+#include "DroneMovementComponent.h"
+#include "DroneVisionComponent.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "UObject/CoreNet.h"
+
+namespace DroneNetReplayPrivate
+{
+	const float CorrectionBucketEdges[FDroneReplayReport::NumCorrectionBuckets - 1] = { 10.0f, 25.0f, 50.0f, 100.0f, 250.0f, 500.0f };
+
+	/** Standalone game world that lives for one replay */
+	struct FReplayWorld
+	{
+		UWorld* World;
+
+		explicit FReplayWorld(const TCHAR* Name)
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, FName(Name));
+
+			FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+			Context.SetCurrentWorld(World);
+
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+		}
+
+		~FReplayWorld()
+		{
+			for (TActorIterator<AActor> It(World); It; ++It)
+			{
+				It->RouteEndPlay(EEndPlayReason::Quit);
+			}
+
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+	};
+
+	/** Serialized packet on its way, oldest delivery first */
+	struct FPacketInFlight
+	{
+		double DeliveryTime = 0.0;
+		TArray<uint8> Data;
+		int64 NumBits = 0;
+	};
+
+	class FSimulatedLink
+	{
+	public:
+		void Send(FPacketInFlight&& Packet)
+		{
+			const int32 Index = Algo::UpperBoundBy(Queue, Packet.DeliveryTime, &FPacketInFlight::DeliveryTime);
+			Queue.Insert(MoveTemp(Packet), Index);
+		}
+
+		bool Receive(double Now, FPacketInFlight& OutPacket)
+		{
+			if (Queue.Num() == 0 || Queue[0].DeliveryTime > Now)
+				return false;
+
+			OutPacket = MoveTemp(Queue[0]);
+			Queue.RemoveAt(0, 1, EAllowShrinking::No);
+			return true;
+		}
+
+	private:
+		TArray<FPacketInFlight> Queue;
+	};
+
+	template<typename StructType>
+	int64 NetSerialize(StructType& Value, TArray<uint8>& OutData)
+	{
+		FNetBitWriter Writer(nullptr, 1024);
+		bool bSuccess = false;
+		Value.NetSerialize(Writer, nullptr, bSuccess);
+
+		OutData = *Writer.GetBuffer();
+		OutData.SetNum(static_cast<int32>((Writer.GetNumBits() + 7) >> 3));
+		return Writer.GetNumBits();
+	}
+
+	/** Spawn a drone with its roles set before BeginPlay, so neither side joins the batch subsystem */
+	UDroneMovementComponent* SpawnDrone(UWorld* World, const FDroneReplaySettings& Settings, bool bServer)
+	{
+		UClass* DroneClass = Settings.DroneClass ? Settings.DroneClass.Get() : ADroneBase::StaticClass();
+		AActor* Drone = World->SpawnActorDeferred<AActor>(DroneClass, FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!Drone)
+			return nullptr;
+
+		if (bServer)
+		{
+			Drone->SetAutonomousProxy(true);
+		}
+		else
+		{
+			Drone->SetRole(ROLE_AutonomousProxy);
+		}
+
+		Drone->FinishSpawning(FTransform::Identity);
+
+		UDroneMovementComponent* Movement = Drone->FindComponentByClass<UDroneMovementComponent>();
+		if (!Movement)
+			return nullptr;
+
+		if (Settings.DroneConfig)
+		{
+			Movement->SetDroneConfig(Settings.DroneConfig);
+		}
+		else if (!Movement->GetDroneConfig())
+		{
+			Movement->SetDroneConfig(NewObject<UDroneConfig>(Drone));
+		}
+
+		return Movement;
+	}
+}
+
+float FDroneReplayReport::GetBucketUpperEdge(int32 Bucket)
+{
+	return (Bucket < NumCorrectionBuckets - 1) ? DroneNetReplayPrivate::CorrectionBucketEdges[Bucket] : MAX_flt;
+}
+
+float FDroneReplayReport::GetCorrectionsPerMinute() const
+{
+	return (SimulatedTime > 0.0f) ? NumCorrections * 60.0f / SimulatedTime : 0.0f;
+}
+
+FString FDroneReplayReport::ToString() const
+{
+	const float Seconds = FMath::Max(SimulatedTime, KINDA_SMALL_NUMBER);
+
+	FString Result = FString::Printf(TEXT("%.1fs, %d frames: %d corrections (%.1f/min, max %.1f), %d rejected moves; sent %lld B (%.0f B/s, %d packets, %d lost), received %lld B (%.0f B/s, %d snapshots, %d lost); replayed in %.1f ms\nCorrection error:"),
+		SimulatedTime, NumFrames, NumCorrections, GetCorrectionsPerMinute(), MaxCorrectionError, NumRejectedMoves,
+		BytesSent, BytesSent / Seconds, InputPacketsSent, InputPacketsLost,
+		BytesReceived, BytesReceived / Seconds, SnapshotsSent, SnapshotsLost,
+		ReplaySeconds * 1000.0);
+
+	float LowerEdge = 0.0f;
+	for (int32 Bucket = 0; Bucket < NumCorrectionBuckets; ++Bucket)
+	{
+		const float UpperEdge = GetBucketUpperEdge(Bucket);
+		Result += (UpperEdge < MAX_flt)
+			? FString::Printf(TEXT(" [%.0f-%.0f: %d]"), LowerEdge, UpperEdge, CorrectionHistogram[Bucket])
+			: FString::Printf(TEXT(" [%.0f+: %d]"), LowerEdge, CorrectionHistogram[Bucket]);
+		LowerEdge = UpperEdge;
+	}
+
+	return Result;
+}
+
+FDroneReplayReport FDroneNetReplay::Run(const FDroneInputRecording& Recording, const FDroneReplaySettings& Settings)
+{
+	using namespace DroneNetReplayPrivate;
+
+	FDroneReplayReport Report;
+	if (!GEngine || Recording.Num() == 0)
+		return Report;
+
+	FReplayWorld ServerWorld(TEXT("DroneReplayServer"));
+	FReplayWorld ClientWorld(TEXT("DroneReplayClient"));
+
+	UDroneMovementComponent* Server = SpawnDrone(ServerWorld.World, Settings, true);
+	UDroneMovementComponent* Client = SpawnDrone(ClientWorld.World, Settings, false);
+	if (!Server || !Client)
+		return Report;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FRandomStream Random(Settings.Seed);
+	FSimulatedLink ToServer;
+	FSimulatedLink ToClient;
+	FDroneNetConditions Conditions = Settings.Conditions;
+	double ClientTime = 0.0;
+	double ServerTime = 0.0;
+
+	auto GetLatency = [&Random, &Conditions, &Settings]()
+	{
+		return Conditions.RoundTripTime * 0.5 + Random.FRand() * Settings.Jitter;
+	};
+
+	// Client packets go through the net serializer instead of the RPC
+	Client->InputPacketOverride = [&](const FDroneInputPacket& Packet)
+	{
+		FDroneInputPacket Sent = Packet;
+		FPacketInFlight InFlight;
+		InFlight.NumBits = NetSerialize(Sent, InFlight.Data);
+
+		Report.BytesSent += InFlight.Data.Num();
+		++Report.InputPacketsSent;
+
+		if (Random.FRand() < Conditions.OutLoss)
+		{
+			++Report.InputPacketsLost;
+			return;
+		}
+
+		InFlight.DeliveryTime = ClientTime + GetLatency();
+		ToServer.Send(MoveTemp(InFlight));
+	};
+
+	const float ServerStep = 1.0f / FMath::Max(Settings.ServerTickRate, 1.0f);
+	const float SnapshotInterval = 1.0f / FMath::Max(Server->GetOwner()->NetUpdateFrequency, 1.0f);
+	double NextSnapshotTime = 0.0;
+	double LastSnapshotDelivery = 0.0;
+	TArray<uint8> LastSnapshotData;
+
+	UDroneVisionComponent* ClientVision = Client->VisionComponent;
+	FPacketInFlight Delivered;
+
+	for (int32 Frame = 0; Frame < Recording.Num(); ++Frame)
+	{
+		const FDroneInputState& Input = Recording.GetInput(Frame);
+		if (Settings.bUseRecordedConditions)
+		{
+			Conditions = Recording.GetConditions(Frame);
+		}
+
+		// Replicated snapshots land between frames; property replication never goes backwards
+		while (ToClient.Receive(ClientTime, Delivered))
+		{
+			FNetBitReader Reader(nullptr, Delivered.Data.GetData(), Delivered.NumBits);
+			FDroneMovementSnapshot Snapshot;
+			bool bSuccess = false;
+			Snapshot.NetSerialize(Reader, nullptr, bSuccess);
+
+			const int32 PreviousCorrections = Client->CorrectionCount;
+			Client->ServerSnapshot = Snapshot;
+			Client->OnRep_ServerSnapshot();
+
+			if (Client->CorrectionCount != PreviousCorrections)
+			{
+				const float Error = Client->LastCorrectionError;
+				int32 Bucket = 0;
+				while (Error >= FDroneReplayReport::GetBucketUpperEdge(Bucket))
+				{
+					++Bucket;
+				}
+
+				++Report.CorrectionHistogram[Bucket];
+				Report.MaxCorrectionError = FMath::Max(Report.MaxCorrectionError, Error);
+			}
+		}
+
+		Client->SetMovementInput(Input.MovementInput);
+		Client->SetLookInput(Input.LookInput);
+		Client->SetSpeedMode(Input.SpeedMode);
+		if (ClientVision && ClientVision->GetVisionMode() != Input.VisionMode)
+		{
+			ClientVision->SetVisionMode(Input.VisionMode);
+		}
+
+		ClientWorld.World->Tick(LEVELTICK_All, Input.DeltaTime);
+		ClientTime += Input.DeltaTime;
+
+		// Server frames that fall within the client frame
+		while (ServerTime + ServerStep <= ClientTime)
+		{
+			ServerTime += ServerStep;
+
+			while (ToServer.Receive(ServerTime, Delivered))
+			{
+				FNetBitReader Reader(nullptr, Delivered.Data.GetData(), Delivered.NumBits);
+				FDroneInputPacket Packet;
+				bool bSuccess = false;
+				Packet.NetSerialize(Reader, nullptr, bSuccess);
+
+				Server->Server_SendInputs_Implementation(Packet);
+			}
+
+			ServerWorld.World->Tick(LEVELTICK_All, ServerStep);
+
+			if (ServerTime < NextSnapshotTime)
+				continue;
+
+			NextSnapshotTime += SnapshotInterval;
+
+			// Unchanged properties are not resent once delivered
+			FDroneMovementSnapshot Snapshot = Server->ServerSnapshot;
+			FPacketInFlight InFlight;
+			InFlight.NumBits = NetSerialize(Snapshot, InFlight.Data);
+			if (InFlight.Data == LastSnapshotData)
+				continue;
+
+			Report.BytesReceived += InFlight.Data.Num();
+			++Report.SnapshotsSent;
+
+			// A lost update is resent with the next one, as a NAK makes the property dirty again
+			if (Random.FRand() < Conditions.InLoss)
+			{
+				++Report.SnapshotsLost;
+				continue;
+			}
+
+			LastSnapshotData = InFlight.Data;
+			InFlight.DeliveryTime = FMath::Max(ServerTime + GetLatency(), LastSnapshotDelivery);
+			LastSnapshotDelivery = InFlight.DeliveryTime;
+			ToClient.Send(MoveTemp(InFlight));
+		}
+	}
+
+	Client->InputPacketOverride.Reset();
+
+	Report.SimulatedTime = static_cast<float>(ClientTime);
+	Report.NumFrames = Recording.Num();
+	Report.NumCorrections = Client->GetCorrectionCount();
+	Report.NumRejectedMoves = Server->GetRejectedMoveCount();
+	Report.ReplaySeconds = FPlatformTime::Seconds() - StartTime;
+
+	return Report;
+}
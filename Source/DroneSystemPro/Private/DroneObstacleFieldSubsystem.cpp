@@ -0,0 +1,341 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneObstacleFieldSubsystem.h"
+#include "DroneObstacleFieldVolume.h"
+#include "DroneSystemPro.h"
+
+DECLARE_CYCLE_STAT(TEXT("Obstacle Field Build"), STAT_DroneObstacleFieldBuild, STATGROUP_DroneSystem);
+
+namespace DroneDistanceFieldPrivate
+{
+	/** Stand-in for infinity that keeps the transform's arithmetic finite */
+	constexpr float FarSquared = 1.0e12f;
+
+	/**
+	 * Exact 1D squared Euclidean distance transform (Felzenszwalb and Huttenlocher)
+	 * Scratch buffers hold N entries for Parabolas and N + 1 for Bounds.
+	 */
+	void DistanceTransform1D(const float* Input, float* Output, int32 N, int32* Parabolas, float* Bounds)
+	{
+		int32 K = 0;
+		Parabolas[0] = 0;
+		Bounds[0] = -FarSquared;
+		Bounds[1] = FarSquared;
+
+		for (int32 Q = 1; Q < N; ++Q)
+		{
+			float S;
+			for (;;)
+			{
+				const int32 V = Parabolas[K];
+				S = ((Input[Q] + Q * Q) - (Input[V] + V * V)) / (2.0f * (Q - V));
+				if (S > Bounds[K] || K == 0)
+					break;
+				--K;
+			}
+
+			++K;
+			Parabolas[K] = Q;
+			Bounds[K] = S;
+			Bounds[K + 1] = FarSquared;
+		}
+
+		K = 0;
+		for (int32 Q = 0; Q < N; ++Q)
+		{
+			while (Bounds[K + 1] < Q)
+			{
+				++K;
+			}
+
+			const int32 V = Parabolas[K];
+			Output[Q] = FMath::Square(static_cast<float>(Q - V)) + Input[V];
+		}
+	}
+
+	/** Squared voxel distance from every voxel to the nearest voxel whose occupancy equals bFeature */
+	void DistanceTransform3D(const FIntVector& Resolution, const TBitArray<>& Solid, bool bFeature, TArray<float>& OutSquared)
+	{
+		const int32 NumVoxels = Resolution.X * Resolution.Y * Resolution.Z;
+		OutSquared.SetNumUninitialized(NumVoxels);
+		for (int32 Index = 0; Index < NumVoxels; ++Index)
+		{
+			OutSquared[Index] = (Solid[Index] == bFeature) ? 0.0f : FarSquared;
+		}
+
+		const int32 MaxAxis = FMath::Max3(Resolution.X, Resolution.Y, Resolution.Z);
+		TArray<float> Line;
+		TArray<float> Result;
+		TArray<int32> Parabolas;
+		TArray<float> Bounds;
+		Line.SetNumUninitialized(MaxAxis);
+		Result.SetNumUninitialized(MaxAxis);
+		Parabolas.SetNumUninitialized(MaxAxis);
+		Bounds.SetNumUninitialized(MaxAxis + 1);
+
+		// Separable: one pass per axis over every line along it
+		const int32 Strides[3] = { 1, Resolution.X, Resolution.X * Resolution.Y };
+		const int32 Sizes[3] = { Resolution.X, Resolution.Y, Resolution.Z };
+
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const int32 Stride = Strides[Axis];
+			const int32 Size = Sizes[Axis];
+
+			for (int32 Start = 0; Start < NumVoxels; ++Start)
+			{
+				// Visit each line once, from the voxel whose coordinate on Axis is zero
+				if ((Start / Stride) % Size != 0)
+					continue;
+
+				for (int32 Step = 0; Step < Size; ++Step)
+				{
+					Line[Step] = OutSquared[Start + Step * Stride];
+				}
+
+				DistanceTransform1D(Line.GetData(), Result.GetData(), Size, Parabolas.GetData(), Bounds.GetData());
+
+				for (int32 Step = 0; Step < Size; ++Step)
+				{
+					OutSquared[Start + Step * Stride] = Result[Step];
+				}
+			}
+		}
+	}
+
+	uint8 Quantize(float Distance, float MaxDistance)
+	{
+		const float Normalized = FMath::Clamp(Distance / MaxDistance, -1.0f, 1.0f);
+		return static_cast<uint8>(FMath::RoundToInt((Normalized * 0.5f + 0.5f) * 255.0f));
+	}
+
+	float Dequantize(uint8 Value, float MaxDistance)
+	{
+		return (Value / 255.0f * 2.0f - 1.0f) * MaxDistance;
+	}
+}
+
+void FDroneDistanceField::Reset()
+{
+	Origin = FVector::ZeroVector;
+	Resolution = FIntVector::ZeroValue;
+	BrickCounts = FIntVector::ZeroValue;
+	BrickTable.Empty();
+	BrickData.Empty();
+}
+
+void FDroneDistanceField::Build(const FVector& InOrigin, const FIntVector& InResolution, float InVoxelSize, float InMaxDistance, const TBitArray<>& Solid)
+{
+	using namespace DroneDistanceFieldPrivate;
+
+	SCOPE_CYCLE_COUNTER(STAT_DroneObstacleFieldBuild);
+
+	Reset();
+
+	const int32 NumVoxels = InResolution.X * InResolution.Y * InResolution.Z;
+	if (InResolution.GetMin() < 1 || Solid.Num() != NumVoxels)
+		return;
+
+	Origin = InOrigin;
+	Resolution = InResolution;
+	VoxelSize = FMath::Max(InVoxelSize, 1.0f);
+	MaxDistance = FMath::Max(InMaxDistance, VoxelSize);
+	BrickCounts = FIntVector(
+		FMath::DivideAndRoundUp(Resolution.X, BrickSize),
+		FMath::DivideAndRoundUp(Resolution.Y, BrickSize),
+		FMath::DivideAndRoundUp(Resolution.Z, BrickSize));
+
+	// Distance to the other state's nearest voxel center; the surface lies half a voxel short of it
+	TArray<float> OutsideSquared;
+	TArray<float> InsideSquared;
+	DistanceTransform3D(Resolution, Solid, true, OutsideSquared);
+	DistanceTransform3D(Resolution, Solid, false, InsideSquared);
+
+	const uint8 EmptyValue = Quantize(MaxDistance, MaxDistance);
+	const uint8 SolidValue = Quantize(-MaxDistance, MaxDistance);
+
+	BrickTable.SetNumUninitialized(BrickCounts.X * BrickCounts.Y * BrickCounts.Z);
+	uint8 Brick[BrickVoxels];
+
+	for (int32 BrickZ = 0; BrickZ < BrickCounts.Z; ++BrickZ)
+	{
+		for (int32 BrickY = 0; BrickY < BrickCounts.Y; ++BrickY)
+		{
+			for (int32 BrickX = 0; BrickX < BrickCounts.X; ++BrickX)
+			{
+				bool bAllEmpty = true;
+				bool bAllSolid = true;
+
+				for (int32 Local = 0; Local < BrickVoxels; ++Local)
+				{
+					const int32 X = BrickX * BrickSize + (Local % BrickSize);
+					const int32 Y = BrickY * BrickSize + (Local / BrickSize) % BrickSize;
+					const int32 Z = BrickZ * BrickSize + Local / (BrickSize * BrickSize);
+
+					// Padding past the resolution is never sampled
+					if (X >= Resolution.X || Y >= Resolution.Y || Z >= Resolution.Z)
+					{
+						Brick[Local] = EmptyValue;
+						continue;
+					}
+
+					const int32 Index = X + Y * Resolution.X + Z * Resolution.X * Resolution.Y;
+					const float Distance = Solid[Index]
+						? -(FMath::Sqrt(InsideSquared[Index]) - 0.5f) * VoxelSize
+						: (FMath::Sqrt(OutsideSquared[Index]) - 0.5f) * VoxelSize;
+
+					Brick[Local] = Quantize(Distance, MaxDistance);
+					bAllEmpty &= Brick[Local] == EmptyValue;
+					bAllSolid &= Brick[Local] == SolidValue;
+				}
+
+				int32& Entry = BrickTable[BrickX + BrickY * BrickCounts.X + BrickZ * BrickCounts.X * BrickCounts.Y];
+				if (bAllEmpty)
+				{
+					Entry = EmptyBrick;
+				}
+				else if (bAllSolid)
+				{
+					Entry = SolidBrick;
+				}
+				else
+				{
+					Entry = GetNumStoredBricks();
+					BrickData.Append(Brick, BrickVoxels);
+				}
+			}
+		}
+	}
+
+	BrickData.Shrink();
+}
+
+FBox FDroneDistanceField::GetBounds() const
+{
+	if (!IsValid())
+		return FBox(ForceInit);
+
+	return FBox(Origin, Origin + FVector(Resolution - FIntVector(1)) * VoxelSize);
+}
+
+float FDroneDistanceField::GetVoxel(int32 X, int32 Y, int32 Z) const
+{
+	const int32 Entry = BrickTable[(X / BrickSize) + (Y / BrickSize) * BrickCounts.X + (Z / BrickSize) * BrickCounts.X * BrickCounts.Y];
+	if (Entry == EmptyBrick)
+		return MaxDistance;
+	if (Entry == SolidBrick)
+		return -MaxDistance;
+
+	const int32 Local = (X % BrickSize) + (Y % BrickSize) * BrickSize + (Z % BrickSize) * BrickSize * BrickSize;
+	return DroneDistanceFieldPrivate::Dequantize(BrickData[Entry * BrickVoxels + Local], MaxDistance);
+}
+
+float FDroneDistanceField::Sample(const FVector& Location, FVector* OutGradient) const
+{
+	if (OutGradient)
+	{
+		*OutGradient = FVector::ZeroVector;
+	}
+
+	if (!IsValid())
+		return MaxDistance;
+
+	// Voxel space; half a voxel of slack past the outer centers
+	const FVector Voxel = (Location - Origin) / VoxelSize;
+	if (Voxel.X < -0.5 || Voxel.Y < -0.5 || Voxel.Z < -0.5
+		|| Voxel.X > Resolution.X - 0.5 || Voxel.Y > Resolution.Y - 0.5 || Voxel.Z > Resolution.Z - 0.5)
+		return MaxDistance;
+
+	int32 Base[3];
+	float Alpha[3];
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const float Clamped = FMath::Clamp(static_cast<float>(Voxel[Axis]), 0.0f, static_cast<float>(Resolution[Axis] - 1));
+		Base[Axis] = FMath::Clamp(FMath::FloorToInt(Clamped), 0, FMath::Max(Resolution[Axis] - 2, 0));
+		Alpha[Axis] = FMath::Clamp(Clamped - Base[Axis], 0.0f, 1.0f);
+	}
+
+	const int32 X1 = FMath::Min(Base[0] + 1, Resolution.X - 1);
+	const int32 Y1 = FMath::Min(Base[1] + 1, Resolution.Y - 1);
+	const int32 Z1 = FMath::Min(Base[2] + 1, Resolution.Z - 1);
+
+	const float C000 = GetVoxel(Base[0], Base[1], Base[2]);
+	const float C100 = GetVoxel(X1, Base[1], Base[2]);
+	const float C010 = GetVoxel(Base[0], Y1, Base[2]);
+	const float C110 = GetVoxel(X1, Y1, Base[2]);
+	const float C001 = GetVoxel(Base[0], Base[1], Z1);
+	const float C101 = GetVoxel(X1, Base[1], Z1);
+	const float C011 = GetVoxel(Base[0], Y1, Z1);
+	const float C111 = GetVoxel(X1, Y1, Z1);
+
+	const float X00 = FMath::Lerp(C000, C100, Alpha[0]);
+	const float X10 = FMath::Lerp(C010, C110, Alpha[0]);
+	const float X01 = FMath::Lerp(C001, C101, Alpha[0]);
+	const float X11 = FMath::Lerp(C011, C111, Alpha[0]);
+	const float Y0 = FMath::Lerp(X00, X10, Alpha[1]);
+	const float Y1Value = FMath::Lerp(X01, X11, Alpha[1]);
+
+	if (OutGradient)
+	{
+		// Analytic derivative of the trilinear blend
+		const float DX = FMath::Lerp(FMath::Lerp(C100 - C000, C110 - C010, Alpha[1]), FMath::Lerp(C101 - C001, C111 - C011, Alpha[1]), Alpha[2]);
+		const float DY = FMath::Lerp(X10 - X00, X11 - X01, Alpha[2]);
+		const float DZ = Y1Value - Y0;
+		*OutGradient = FVector(DX, DY, DZ) / VoxelSize;
+	}
+
+	return FMath::Lerp(Y0, Y1Value, Alpha[2]);
+}
+
+void UDroneObstacleFieldSubsystem::Deinitialize()
+{
+	Volumes.Reset();
+
+	Super::Deinitialize();
+}
+
+void UDroneObstacleFieldSubsystem::RegisterVolume(ADroneObstacleFieldVolume* Volume)
+{
+	if (!Volume || !Volume->GetField().IsValid())
+		return;
+
+	Volumes.AddUnique(Volume);
+}
+
+void UDroneObstacleFieldSubsystem::UnregisterVolume(ADroneObstacleFieldVolume* Volume)
+{
+	Volumes.Remove(Volume);
+}
+
+float UDroneObstacleFieldSubsystem::SampleDistance(const FVector& Location, FVector& OutNormal) const
+{
+	OutNormal = FVector::ZeroVector;
+	float Nearest = MAX_flt;
+
+	// Levels place a handful of volumes, so a linear scan beats any index
+	for (const TWeakObjectPtr<ADroneObstacleFieldVolume>& Volume : Volumes)
+	{
+		if (!Volume.IsValid())
+			continue;
+
+		const FDroneDistanceField& Field = Volume->GetField();
+		if (!Field.GetBounds().ExpandBy(Field.GetMaxDistance()).IsInside(Location))
+			continue;
+
+		FVector Gradient;
+		const float Distance = Field.Sample(Location, &Gradient);
+		if (Distance < Nearest)
+		{
+			Nearest = Distance;
+			OutNormal = Gradient.GetSafeNormal();
+		}
+	}
+
+	return Nearest;
+}
+
+float UDroneObstacleFieldSubsystem::GetObstacleDistance(FVector Location) const
+{
+	FVector Normal;
+	return SampleDistance(Location, Normal);
+}
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneObstacleFieldVolume.h"
+#include "DroneSystemPro.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+
+ADroneObstacleFieldVolume::ADroneObstacleFieldVolume()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	FieldBounds = CreateDefaultSubobject<UBoxComponent>(TEXT("FieldBounds"));
+	FieldBounds->SetBoxExtent(FVector(2000.0f, 2000.0f, 1000.0f));
+	FieldBounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	FieldBounds->SetGenerateOverlapEvents(false);
+	RootComponent = FieldBounds;
+
+	VoxelSize = 50.0f;
+	MaxDistance = 600.0f;
+	MaxVoxels = 16 * 1024 * 1024;
+}
+
+void ADroneObstacleFieldVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!Field.IsValid())
+	{
+		UE_LOG(LogDroneSystem, Warning, TEXT("Obstacle field volume %s has not been baked"), *GetName());
+		return;
+	}
+
+	if (UDroneObstacleFieldSubsystem* Subsystem = GetWorld()->GetSubsystem<UDroneObstacleFieldSubsystem>())
+	{
+		Subsystem->RegisterVolume(this);
+	}
+}
+
+void ADroneObstacleFieldVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDroneObstacleFieldSubsystem* Subsystem = GetWorld() ? GetWorld()->GetSubsystem<UDroneObstacleFieldSubsystem>() : nullptr)
+	{
+		Subsystem->UnregisterVolume(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ADroneObstacleFieldVolume::BakeField()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+		return;
+
+	const FBox Bounds = FieldBounds->Bounds.GetBox();
+	const FIntVector Resolution(
+		FMath::Max(FMath::CeilToInt(Bounds.GetSize().X / VoxelSize), 1),
+		FMath::Max(FMath::CeilToInt(Bounds.GetSize().Y / VoxelSize), 1),
+		FMath::Max(FMath::CeilToInt(Bounds.GetSize().Z / VoxelSize), 1));
+
+	const int64 NumVoxels = static_cast<int64>(Resolution.X) * Resolution.Y * Resolution.Z;
+	if (NumVoxels > MaxVoxels)
+	{
+		UE_LOG(LogDroneSystem, Warning, TEXT("Obstacle field volume %s needs %d x %d x %d voxels at voxel size %.0f; not baked"),
+			*GetName(), Resolution.X, Resolution.Y, Resolution.Z, VoxelSize);
+		return;
+	}
+
+	// One overlap per voxel against level geometry only; movable actors are left to collision
+	const FVector Origin = Bounds.Min + FVector(VoxelSize * 0.5f);
+	const FCollisionShape VoxelShape = FCollisionShape::MakeBox(FVector(VoxelSize * 0.5f));
+	const FCollisionObjectQueryParams ObjectParams(ECC_WorldStatic);
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(DroneObstacleFieldBake), false, this);
+
+	TBitArray<> Solid(false, static_cast<int32>(NumVoxels));
+	int32 NumSolid = 0;
+
+	for (int32 Z = 0; Z < Resolution.Z; ++Z)
+	{
+		for (int32 Y = 0; Y < Resolution.Y; ++Y)
+		{
+			for (int32 X = 0; X < Resolution.X; ++X)
+			{
+				const FVector Center = Origin + FVector(X, Y, Z) * VoxelSize;
+				if (World->OverlapAnyTestByObjectType(Center, FQuat::Identity, ObjectParams, VoxelShape, Params))
+				{
+					Solid[X + Y * Resolution.X + Z * Resolution.X * Resolution.Y] = true;
+					++NumSolid;
+				}
+			}
+		}
+	}
+
+	Modify();
+	Field.Build(Origin, Resolution, VoxelSize, MaxDistance, Solid);
+
+	UE_LOG(LogDroneSystem, Log, TEXT("Baked obstacle field %s: %d x %d x %d voxels (%d solid), %d of %d bricks stored, %.1f KB"),
+		*GetName(), Resolution.X, Resolution.Y, Resolution.Z, NumSolid,
+		Field.GetNumStoredBricks(), Field.GetNumBricks(), Field.GetAllocatedSize() / 1024.0f);
+
+	// Runtime bakes (procedural levels) take effect immediately
+	if (HasActorBegunPlay())
+	{
+		if (UDroneObstacleFieldSubsystem* Subsystem = World->GetSubsystem<UDroneObstacleFieldSubsystem>())
+		{
+			Subsystem->RegisterVolume(this);
+		}
+	}
+}
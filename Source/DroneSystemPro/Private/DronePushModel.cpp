@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DronePushModel.h"
+#include "DroneReplicationComponent.h"
+#include "Components/ActorComponent.h"
+#include "GameFramework/Actor.h"
+
+void FDroneNetDormancy::NotifyPropertyDirty(const UObject* Object)
+{
+	const UActorComponent* Component = Cast<UActorComponent>(Object);
+	AActor* Actor = Component ? Component->GetOwner() : const_cast<AActor*>(Cast<AActor>(Object));
+
+	// Awake actors, the common case, send the change anyway
+	if (!Actor || Actor->NetDormancy <= DORM_Awake || Actor->GetLocalRole() != ROLE_Authority)
+		return;
+
+	if (UDroneReplicationComponent* Replication = Actor->FindComponentByClass<UDroneReplicationComponent>())
+	{
+		Replication->WakeFromDormancy();
+	}
+	else
+	{
+		Actor->FlushNetDormancy();
+	}
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DronePushModelPrivate
+{
+	bool bTrackerEnabled = false;
+	TSet<TPair<const UObject*, FName>> MarkedProperties;
+}
+
+void FDronePushModelTracker::SetEnabled(bool bEnabled)
+{
+	DronePushModelPrivate::bTrackerEnabled = bEnabled;
+	Reset();
+}
+
+void FDronePushModelTracker::Reset()
+{
+	DronePushModelPrivate::MarkedProperties.Reset();
+}
+
+void FDronePushModelTracker::NotifyMarked(const UObject* Object, FName PropertyName)
+{
+	if (DronePushModelPrivate::bTrackerEnabled)
+	{
+		DronePushModelPrivate::MarkedProperties.Add(TPair<const UObject*, FName>(Object, PropertyName));
+	}
+}
+
+bool FDronePushModelTracker::WasMarked(const UObject* Object, FName PropertyName)
+{
+	return DronePushModelPrivate::MarkedProperties.Contains(TPair<const UObject*, FName>(Object, PropertyName));
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
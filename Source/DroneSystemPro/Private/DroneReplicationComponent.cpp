@@ -1,10 +1,130 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DroneReplicationComponent.h"
+#include "DroneSystemPro.h"
+#include "DroneBase.h"
+#include "DroneMovementComponent.h"
+#include "DroneReplicationGraph.h"
+#include "DroneVisionComponent.h"
+#include "GenericTeamAgentInterface.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/PlayerController.h"
 #include "Engine/World.h"
+#include "Engine/NetConnection.h"
 #include "Engine/NetDriver.h"
+#include "EngineUtils.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Replicated Drone Bytes"), STAT_DroneReplicatedBytes, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Throttled Drones"), STAT_DroneThrottled, STATGROUP_DroneSystem);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Drones"), STAT_DroneDormant, STATGROUP_DroneSystem);
+CSV_DEFINE_CATEGORY(DroneNet, true);
+
+static FAutoConsoleCommandWithWorld DroneDumpBandwidthCommand(
+	TEXT("Drone.DumpBandwidth"),
+	TEXT("Logs bytes per second and replication scale of every metered drone, per connection"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TActorIterator<ADroneBase> It(World); It; ++It)
+		{
+			const UDroneReplicationComponent* Replication = It->FindComponentByClass<UDroneReplicationComponent>();
+			if (!Replication || Replication->GetTotalBytesSent() == 0)
+				continue;
+
+			UE_LOG(LogDroneSystem, Display, TEXT("%s: %.0f B/s, scale %.2f, %lld B total"),
+				*It->GetName(), Replication->GetCurrentBandwidthUsage(), Replication->GetReplicationScale(), Replication->GetTotalBytesSent());
+
+			if (const UNetDriver* NetDriver = World->GetNetDriver())
+			{
+				for (const UNetConnection* Connection : NetDriver->ClientConnections)
+				{
+					UE_LOG(LogDroneSystem, Display, TEXT("    %s: %.0f B/s, scale %.2f"),
+						*Connection->LowLevelGetRemoteAddress(), Replication->GetConnectionBandwidthUsage(Connection), Replication->GetConnectionScale(Connection));
+				}
+			}
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld DroneDumpDormancyCommand(
+	TEXT("Drone.DumpDormancy"),
+	TEXT("Logs how many drones are dormant, and how many of those are parked"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		int32 NumDrones = 0;
+		int32 NumParked = 0;
+		for (TActorIterator<ADroneBase> It(World); It; ++It)
+		{
+			++NumDrones;
+			if (!It->IsActive())
+			{
+				++NumParked;
+			}
+		}
+
+		UE_LOG(LogDroneSystem, Display, TEXT("%d of %d drones dormant, %d parked"), UDroneReplicationComponent::GetNumDormantDrones(World), NumDrones, NumParked);
+	}));
+
+namespace DroneReplicationPrivate
+{
+	/** Team of an actor, or of the pawn or controller on the other side of a possession */
+	FGenericTeamId GetTeam(const AActor* Actor)
+	{
+		if (const IGenericTeamAgentInterface* Agent = Cast<const IGenericTeamAgentInterface>(Actor))
+			return Agent->GetGenericTeamId();
+
+		if (const APawn* Pawn = Cast<APawn>(Actor))
+			return FGenericTeamId::GetTeamIdentifier(Pawn->GetController());
+
+		if (const AController* Controller = Cast<AController>(Actor))
+			return FGenericTeamId::GetTeamIdentifier(Controller->GetPawn());
+
+		return FGenericTeamId::NoTeam;
+	}
+}
+
+void FDroneBandwidthMeter::AddBytes(int32 Bytes)
+{
+	PendingBytes += Bytes;
+	TotalBytes += Bytes;
+}
+
+void FDroneBandwidthMeter::Update(float DeltaTime, float SmoothingTime)
+{
+	if (DeltaTime <= 0.0f)
+		return;
+
+	const float Sample = PendingBytes / DeltaTime;
+	const float Alpha = (SmoothingTime > 0.0f) ? 1.0f - FMath::Exp(-DeltaTime / SmoothingTime) : 1.0f;
+	BytesPerSecond = FMath::Lerp(BytesPerSecond, Sample, Alpha);
+	PendingBytes = 0;
+}
+
+float FDroneBandwidthController::Update(float BytesPerSecond, float Limit, float DeltaTime, bool bSaturated)
+{
+	HoldRemaining = FMath::Max(HoldRemaining - DeltaTime, 0.0f);
+
+	if (bSaturated)
+	{
+		Scale *= 0.5f;
+		HoldRemaining = HoldTime;
+	}
+	else if (Limit > 0.0f && BytesPerSecond > Limit)
+	{
+		// The smoothed rate still includes traffic from before the last cut
+		if (HoldRemaining <= 0.0f)
+		{
+			Scale *= Limit / BytesPerSecond;
+			HoldRemaining = HoldTime;
+		}
+	}
+	else if (Limit <= 0.0f || BytesPerSecond < Limit * Headroom)
+	{
+		Scale += RecoveryRate * DeltaTime;
+	}
+
+	Scale = FMath::Clamp(Scale, MinScale, 1.0f);
+	return Scale;
+}
 
 UDroneReplicationComponent::UDroneReplicationComponent()
 {
@@ -14,19 +134,55 @@ UDroneReplicationComponent::UDroneReplicationComponent()
 	BasePriority = 1.0f;
 	DistancePriorityScale = 1.0f;
 	MaxRelevancyDistance = 15000.0f;
+	ViewConeHalfAngle = 45.0f;
+	InViewPriorityScale = 2.0f;
+	BehindViewerPriorityScale = 0.25f;
+	ViewIndependentDistance = 1500.0f;
+	TeammatePriorityScale = 1.5f;
+	TeammateRelevancyScale = 1.5f;
 	BandwidthLimit = 0.0f; // 0 = unlimited
 	CurrentBandwidthUsage = 0.0f;
 	LastRelevancyUpdate = 0.0f;
+
+	BadLinkBandwidthCap = 1000.0f;
+	BadLinkNetSpeed = 15000;
+	BadLinkPacketLoss = 0.05f;
+	MinNetUpdateFrequency = 4.0f;
+	BandwidthControlInterval = 0.25f;
+	BandwidthSmoothingTime = 1.0f;
+	ReplicationScale = 1.0f;
+	bAutoDormancy = true;
+	ParkedDormancyDelay = 1.0f;
+	IdleDormancyDelay = 5.0f;
+	IdleSpeedThreshold = 10.0f;
+	BaseNetUpdateFrequency = 0.0f;
+	TimeSinceControlUpdate = 0.0f;
+	bNetDormant = false;
+	DormancyTimer = 0.0f;
+
+	CacheViewerThresholds();
 }
 
 void UDroneReplicationComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	BaseNetUpdateFrequency = GetOwner() ? GetOwner()->NetUpdateFrequency : 0.0f;
 	OptimizeNetworkSettings();
 	ApplyRelevancySettings();
 }
 
+void UDroneReplicationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bNetDormant)
+	{
+		bNetDormant = false;
+		DEC_DWORD_STAT(STAT_DroneDormant);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UDroneReplicationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
@@ -44,8 +200,8 @@ void UDroneReplicationComponent::TickComponent(float DeltaTime, ELevelTick TickT
 		LastRelevancyUpdate = CurrentTime;
 	}
 
-	// Track bandwidth usage (simplified)
-	CurrentBandwidthUsage = 0.0f; // Reset and recalculate
+	UpdateBandwidthControl(DeltaTime);
+	UpdateDormancy(DeltaTime);
 }
 
 void UDroneReplicationComponent::UpdateRelevancy()
@@ -65,11 +221,24 @@ bool UDroneReplicationComponent::IsRelevantTo(AActor* ViewingActor) const
 	if (ViewingActor == GetOwner()->GetOwner())
 		return true;
 
-	// Check distance
-	float DistSq = FVector::DistSquared(GetOwner()->GetActorLocation(), ViewingActor->GetActorLocation());
-	float MaxDistSq = MaxRelevancyDistance * MaxRelevancyDistance;
+	return IsRelevantAtDistance(FVector::DistSquared(GetOwner()->GetActorLocation(), ViewingActor->GetActorLocation()), ViewingActor);
+}
+
+bool UDroneReplicationComponent::IsRelevantAtDistance(float DistanceSquared, const AActor* Viewer) const
+{
+	if (DistanceSquared <= MaxRelevancyDistanceSquared)
+		return true;
+
+	return DistanceSquared <= TeammateRelevancyDistanceSquared && IsTeammate(Viewer);
+}
 
-	return DistSq <= MaxDistSq;
+bool UDroneReplicationComponent::IsTeammate(const AActor* Viewer) const
+{
+	if (!Viewer || !GetOwner())
+		return false;
+
+	const FGenericTeamId Team = DroneReplicationPrivate::GetTeam(GetOwner());
+	return Team != FGenericTeamId::NoTeam && Team == DroneReplicationPrivate::GetTeam(Viewer);
 }
 
 float UDroneReplicationComponent::GetReplicationPriority(AActor* ViewingActor) const
@@ -77,12 +246,11 @@ float UDroneReplicationComponent::GetReplicationPriority(AActor* ViewingActor) c
 	if (!ViewingActor || !GetOwner())
 		return BasePriority;
 
-	float Priority = BasePriority;
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	ViewingActor->GetActorEyesViewPoint(ViewLocation, ViewRotation);
 
-	// Distance-based priority
-	float Distance = FVector::Dist(GetOwner()->GetActorLocation(), ViewingActor->GetActorLocation());
-	float DistanceFactor = 1.0f - FMath::Clamp(Distance / MaxRelevancyDistance, 0.0f, 1.0f);
-	Priority *= (1.0f + DistanceFactor * DistancePriorityScale);
+	float Priority = BasePriority * GetViewerPriorityScale(ViewLocation, ViewRotation.Vector(), ViewingActor);
 
 	// Owner gets highest priority
 	if (ViewingActor == GetOwner()->GetOwner())
@@ -93,11 +261,275 @@ float UDroneReplicationComponent::GetReplicationPriority(AActor* ViewingActor) c
 	return Priority;
 }
 
+float UDroneReplicationComponent::GetViewerPriorityScale(const FVector& ViewLocation, const FVector& ViewDirection, const AActor* Viewer) const
+{
+	if (!GetOwner())
+		return 1.0f;
+
+	const FVector ToDrone = GetOwner()->GetActorLocation() - ViewLocation;
+	const float DistanceSquared = ToDrone.SizeSquared();
+
+	// Squared falloff, as the replication graph weighs distance
+	const float DistanceFactor = 1.0f - FMath::Clamp(DistanceSquared / MaxRelevancyDistanceSquared, 0.0f, 1.0f);
+	float Scale = 1.0f + DistanceFactor * DistancePriorityScale;
+
+	if (DistanceSquared > ViewIndependentDistanceSquared)
+	{
+		// In the cone when the angle's cosine squared beats the cone's, compared without a square root
+		const float Dot = ViewDirection | ToDrone;
+		if (Dot < 0.0f)
+		{
+			Scale *= BehindViewerPriorityScale;
+		}
+		else if (Dot * Dot >= ViewConeCosSquared * DistanceSquared)
+		{
+			Scale *= InViewPriorityScale;
+		}
+	}
+
+	if (IsTeammate(Viewer))
+	{
+		Scale *= TeammatePriorityScale;
+	}
+
+	return Scale;
+}
+
 void UDroneReplicationComponent::SetBandwidthLimit(float Limit)
 {
 	BandwidthLimit = FMath::Max(0.0f, Limit);
 }
 
+void UDroneReplicationComponent::RecordBytesSent(UNetConnection* Connection, int32 Bytes)
+{
+	TotalMeter.AddBytes(Bytes);
+	Connections.FindOrAdd(Connection).Meter.AddBytes(Bytes);
+
+	INC_DWORD_STAT_BY(STAT_DroneReplicatedBytes, Bytes);
+	CSV_CUSTOM_STAT(DroneNet, BytesSent, Bytes, ECsvCustomStatOp::Accumulate);
+}
+
+float UDroneReplicationComponent::GetConnectionBandwidthUsage(const UNetConnection* Connection) const
+{
+	const FConnectionBandwidth* Usage = Connections.Find(Connection);
+	return Usage ? Usage->Meter.GetBytesPerSecond() : 0.0f;
+}
+
+float UDroneReplicationComponent::GetConnectionScale(const UNetConnection* Connection) const
+{
+	const FConnectionBandwidth* Usage = Connections.Find(Connection);
+	return Usage ? Usage->Controller.GetScale() : 1.0f;
+}
+
+float UDroneReplicationComponent::GetConnectionLimit(UNetConnection* Connection) const
+{
+	float Limit = BandwidthLimit;
+
+	const bool bBadLink = Connection->CurrentNetSpeed < BadLinkNetSpeed
+		|| Connection->GetOutLossPercentage().GetAvgLossPercentage() > BadLinkPacketLoss;
+	if (bBadLink && BadLinkBandwidthCap > 0.0f)
+	{
+		Limit = (Limit > 0.0f) ? FMath::Min(Limit, BadLinkBandwidthCap) : BadLinkBandwidthCap;
+	}
+
+	return Limit;
+}
+
+void UDroneReplicationComponent::UpdateBandwidthControl(float DeltaTime)
+{
+	TimeSinceControlUpdate += DeltaTime;
+	if (TimeSinceControlUpdate < BandwidthControlInterval)
+		return;
+
+	const float ControlDeltaTime = TimeSinceControlUpdate;
+	TimeSinceControlUpdate = 0.0f;
+
+	TotalMeter.Update(ControlDeltaTime, BandwidthSmoothingTime);
+	CurrentBandwidthUsage = TotalMeter.GetBytesPerSecond();
+	CSV_CUSTOM_STAT(DroneNet, BytesPerSecond, CurrentBandwidthUsage, ECsvCustomStatOp::Accumulate);
+
+	UDroneReplicationGraph* Graph = UDroneReplicationGraph::Get(GetWorld());
+	ADroneBase* Drone = Cast<ADroneBase>(GetOwner());
+
+	float MinScale = 1.0f;
+	float MaxScale = 0.0f;
+
+	for (auto It = Connections.CreateIterator(); It; ++It)
+	{
+		UNetConnection* Connection = It->Key.Get();
+		if (!Connection || Connection->GetConnectionState() == USOCK_Closed)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		FConnectionBandwidth& Usage = It->Value;
+		Usage.Meter.Update(ControlDeltaTime, BandwidthSmoothingTime);
+
+		const float Scale = Usage.Controller.Update(Usage.Meter.GetBytesPerSecond(), GetConnectionLimit(Connection), ControlDeltaTime, !Connection->IsNetReady(false));
+		MinScale = FMath::Min(MinScale, Scale);
+		MaxScale = FMath::Max(MaxScale, Scale);
+
+		// The graph throttles each connection on its own
+		if (Graph && Drone)
+		{
+			Graph->SetConnectionUpdateRate(Drone, Connection, GetUpdateRateForScale(Scale));
+		}
+	}
+
+	// Without per-connection periods the worst link sets the pace for everyone
+	const float Scale = Connections.Num() == 0 ? 1.0f : (Graph ? MaxScale : MinScale);
+	ApplyReplicationScale(Scale);
+
+	if (MinScale < 1.0f)
+	{
+		INC_DWORD_STAT(STAT_DroneThrottled);
+		CSV_CUSTOM_STAT(DroneNet, ThrottledDrones, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+float UDroneReplicationComponent::GetUpdateRateForScale(float Scale) const
+{
+	// The upper half of the scale is spent on thermal detail, the lower half on rate
+	const float BaseRate = DroneConfig ? DroneConfig->ReplicationRate : BaseNetUpdateFrequency;
+	const float RateScale = FMath::Clamp(Scale * 2.0f, 0.0f, 1.0f);
+	return FMath::Max(FMath::Min(MinNetUpdateFrequency, BaseRate), BaseRate * RateScale);
+}
+
+void UDroneReplicationComponent::ApplyReplicationScale(float Scale)
+{
+	AActor* Owner = GetOwner();
+	if (!Owner)
+		return;
+
+	ReplicationScale = Scale;
+
+	// Thermal detail goes first, then update and snapshot rates down to the floor
+	const float ThermalDetail = FMath::Clamp(Scale * 2.0f - 1.0f, 0.0f, 1.0f);
+	const float UpdateRate = GetUpdateRateForScale(Scale);
+
+	if (!FMath::IsNearlyEqual(Owner->NetUpdateFrequency, UpdateRate, 0.1f))
+	{
+		Owner->NetUpdateFrequency = UpdateRate;
+
+		if (UDroneReplicationGraph* Graph = UDroneReplicationGraph::Get(GetWorld()))
+		{
+			Graph->RefreshDroneSettings(Cast<ADroneBase>(Owner));
+		}
+	}
+
+	// Forced net updates from RPCs and other properties must not carry extra movement
+	if (UDroneMovementComponent* Movement = Owner->FindComponentByClass<UDroneMovementComponent>())
+	{
+		Movement->SetSnapshotInterval(Scale < 1.0f ? 1.0f / UpdateRate : 0.0f);
+	}
+
+	if (UDroneVisionComponent* Vision = Owner->FindComponentByClass<UDroneVisionComponent>())
+	{
+		Vision->SetThermalDetail(ThermalDetail);
+	}
+}
+
+void UDroneReplicationComponent::UpdateDormancy(float DeltaTime)
+{
+	bool bParked = false;
+	if (!bAutoDormancy || !CanBeDormant(bParked))
+	{
+		DormancyTimer = 0.0f;
+		SetNetDormant(false);
+		return;
+	}
+
+	if (bNetDormant)
+	{
+		CSV_CUSTOM_STAT(DroneNet, DormantDrones, 1, ECsvCustomStatOp::Accumulate);
+		return;
+	}
+
+	// Changes marked just before this still go out; the channel closes once it is up to date
+	DormancyTimer += DeltaTime;
+	if (DormancyTimer >= (bParked ? ParkedDormancyDelay : IdleDormancyDelay))
+	{
+		SetNetDormant(true);
+	}
+}
+
+bool UDroneReplicationComponent::CanBeDormant(bool& bOutParked) const
+{
+	bOutParked = false;
+
+	const ADroneBase* Drone = Cast<ADroneBase>(GetOwner());
+	if (!Drone)
+		return false;
+
+	// Owning clients need snapshots and clock echoes to keep predicting
+	if (Drone->IsPlayerControlled())
+		return false;
+
+	// Docking deactivates the drone, so this covers docked drones too
+	if (!Drone->IsActive())
+	{
+		bOutParked = true;
+		return true;
+	}
+
+	// Thermal scans replicate their detections every interval
+	const UDroneVisionComponent* Vision = Drone->GetDroneVision();
+	if (Vision && Vision->GetVisionMode() == EDroneVisionMode::Thermal)
+		return false;
+
+	const UDroneMovementComponent* Movement = Drone->GetDroneMovement();
+	return Movement && Movement->GetCurrentSpeed() < IdleSpeedThreshold && Movement->GetMovementInput().IsNearlyZero();
+}
+
+void UDroneReplicationComponent::WakeFromDormancy()
+{
+	DormancyTimer = 0.0f;
+
+	if (bNetDormant)
+	{
+		SetNetDormant(false);
+	}
+	else if (AActor* Owner = GetOwner())
+	{
+		// Put to sleep by someone else: send the change and leave it dormant
+		Owner->FlushNetDormancy();
+	}
+}
+
+void UDroneReplicationComponent::SetNetDormant(bool bDormant)
+{
+	AActor* Owner = GetOwner();
+	if (!Owner || bDormant == bNetDormant)
+		return;
+
+	bNetDormant = bDormant;
+	Owner->SetNetDormancy(bDormant ? DORM_DormantAll : DORM_Awake);
+
+	if (bDormant)
+	{
+		INC_DWORD_STAT(STAT_DroneDormant);
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_DroneDormant);
+	}
+}
+
+int32 UDroneReplicationComponent::GetNumDormantDrones(const UWorld* World)
+{
+	int32 NumDormant = 0;
+	for (TActorIterator<ADroneBase> It(World); It; ++It)
+	{
+		const UDroneReplicationComponent* Replication = It->FindComponentByClass<UDroneReplicationComponent>();
+		if (Replication && Replication->IsNetDormant())
+		{
+			++NumDormant;
+		}
+	}
+	return NumDormant;
+}
+
 void UDroneReplicationComponent::SetDroneConfig(UDroneConfig* NewConfig)
 {
 	DroneConfig = NewConfig;
@@ -111,7 +543,7 @@ void UDroneReplicationComponent::OptimizeNetworkSettings()
 		return;
 
 	// Apply network settings from config
-	GetOwner()->NetUpdateFrequency = DroneConfig->ReplicationRate;
+	GetOwner()->NetUpdateFrequency = GetUpdateRateForScale(ReplicationScale);
 	GetOwner()->NetCullDistanceSquared = DroneConfig->NetCullDistance * DroneConfig->NetCullDistance;
 }
 
@@ -121,7 +553,22 @@ void UDroneReplicationComponent::ApplyRelevancySettings()
 		return;
 
 	MaxRelevancyDistance = DroneConfig ? DroneConfig->NetCullDistance : 15000.0f;
+	CacheViewerThresholds();
 
 	// Apply cull distance
 	GetOwner()->NetCullDistanceSquared = MaxRelevancyDistance * MaxRelevancyDistance;
+
+	// The replication graph keeps its own copy of these
+	if (UDroneReplicationGraph* Graph = UDroneReplicationGraph::Get(GetWorld()))
+	{
+		Graph->RefreshDroneSettings(Cast<ADroneBase>(GetOwner()));
+	}
+}
+
+void UDroneReplicationComponent::CacheViewerThresholds()
+{
+	MaxRelevancyDistanceSquared = FMath::Max(FMath::Square(MaxRelevancyDistance), KINDA_SMALL_NUMBER);
+	TeammateRelevancyDistanceSquared = FMath::Square(MaxRelevancyDistance * FMath::Max(TeammateRelevancyScale, 1.0f));
+	ViewIndependentDistanceSquared = FMath::Square(ViewIndependentDistance);
+	ViewConeCosSquared = FMath::Square(FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(ViewConeHalfAngle, 1.0f, 90.0f))));
 }
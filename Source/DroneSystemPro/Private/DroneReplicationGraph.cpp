@@ -0,0 +1,389 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneReplicationGraph.h"
+#include "DroneSystemPro.h"
+#include "DroneBase.h"
+#include "DroneReplicationComponent.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rep Graph Parked Drone Update"), STAT_DroneRepGraphParkedUpdate, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rep Graph Parked Drones"), STAT_DroneRepGraphParked, STATGROUP_DroneSystem);
+
+// Owner relevant node
+
+UDroneReplicationGraphNode_OwnerRelevant::UDroneReplicationGraphNode_OwnerRelevant()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UDroneReplicationGraphNode_OwnerRelevant::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Actors.AddUnique(ActorInfo.Actor);
+}
+
+bool UDroneReplicationGraphNode_OwnerRelevant::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	const bool bRemoved = Actors.RemoveSingleSwap(ActorInfo.Actor, EAllowShrinking::No) > 0;
+
+	// The actor may be destroyed before the next rebuild
+	for (TPair<UNetConnection*, FActorRepListRefView>& Pair : ConnectionLists)
+	{
+		Pair.Value.RemoveFast(ActorInfo.Actor);
+	}
+
+	return bRemoved;
+}
+
+void UDroneReplicationGraphNode_OwnerRelevant::NotifyResetAllNetworkActors()
+{
+	Actors.Reset();
+	ConnectionLists.Reset();
+}
+
+void UDroneReplicationGraphNode_OwnerRelevant::PrepareForReplication()
+{
+	for (TPair<UNetConnection*, FActorRepListRefView>& Pair : ConnectionLists)
+	{
+		Pair.Value.Reset();
+	}
+
+	for (AActor* Actor : Actors)
+	{
+		if (UNetConnection* Connection = Actor->GetNetConnection())
+		{
+			ConnectionLists.FindOrAdd(Connection).Add(Actor);
+		}
+	}
+
+	// Drops lists of closed connections too
+	for (auto It = ConnectionLists.CreateIterator(); It; ++It)
+	{
+		if (It->Value.Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UDroneReplicationGraphNode_OwnerRelevant::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	const FActorRepListRefView* List = ConnectionLists.Find(Params.ConnectionManager.NetConnection);
+	if (!List)
+		return;
+
+	// Gathered here regardless of the grid; per-connection actor info is left alone,
+	// since a cull distance overridden here would outlive the actor's ownership
+	Params.OutGatheredReplicationLists.AddReplicationActorList(*List);
+}
+
+// Parked drone node
+
+UDroneReplicationGraphNode_ParkedDrones::UDroneReplicationGraphNode_ParkedDrones()
+{
+	CellSize = 20000.0f;
+	GatherDistance = 15000.0f;
+}
+
+FIntPoint UDroneReplicationGraphNode_ParkedDrones::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void UDroneReplicationGraphNode_ParkedDrones::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	ensureMsgf(false, TEXT("UDroneReplicationGraphNode_ParkedDrones::NotifyAddNetworkActor should not be called directly; use AddActor_Dormancy"));
+}
+
+bool UDroneReplicationGraphNode_ParkedDrones::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	ensureMsgf(false, TEXT("UDroneReplicationGraphNode_ParkedDrones::NotifyRemoveNetworkActor should not be called directly; use RemoveActor_Dormancy"));
+	return false;
+}
+
+void UDroneReplicationGraphNode_ParkedDrones::AddActor_Dormancy(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	if (ActorCells.Contains(ActorInfo.Actor))
+		return;
+
+	const FIntPoint Cell = GetCell(ActorInfo.Actor->GetActorLocation());
+	ActorCells.Add(ActorInfo.Actor, Cell);
+
+	UReplicationGraphNode_DormancyNode*& CellNode = Cells.FindOrAdd(Cell);
+	if (!CellNode)
+	{
+		CellNode = CreateChildNode<UReplicationGraphNode_DormancyNode>();
+	}
+
+	// Dormancy nodes only take actors through their dormant path
+	CellNode->AddDormantActor(ActorInfo, GlobalInfo);
+}
+
+void UDroneReplicationGraphNode_ParkedDrones::RemoveActor_Dormancy(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	FIntPoint Cell;
+	if (!ActorCells.RemoveAndCopyValue(ActorInfo.Actor, Cell))
+		return;
+
+	if (UReplicationGraphNode_DormancyNode* CellNode = Cells.FindRef(Cell))
+	{
+		CellNode->RemoveDormantActor(ActorInfo, GlobalInfo);
+	}
+}
+
+void UDroneReplicationGraphNode_ParkedDrones::NotifyResetAllNetworkActors()
+{
+	Super::NotifyResetAllNetworkActors();
+	ActorCells.Reset();
+}
+
+void UDroneReplicationGraphNode_ParkedDrones::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	if (ActorCells.Num() == 0)
+		return;
+
+	const int32 Reach = FMath::CeilToInt(GatherDistance / CellSize);
+
+	// Split screen viewers usually share cells
+	TArray<FIntPoint, TInlineAllocator<16>> Gathered;
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const FIntPoint Center = GetCell(Viewer.ViewLocation);
+		for (int32 Y = Center.Y - Reach; Y <= Center.Y + Reach; ++Y)
+		{
+			for (int32 X = Center.X - Reach; X <= Center.X + Reach; ++X)
+			{
+				const FIntPoint Cell(X, Y);
+				UReplicationGraphNode_DormancyNode* CellNode = Cells.FindRef(Cell);
+				if (!CellNode || Gathered.Contains(Cell))
+					continue;
+
+				Gathered.Add(Cell);
+				CellNode->GatherActorListsForConnection(Params);
+			}
+		}
+	}
+}
+
+// Graph
+
+UDroneReplicationGraph::UDroneReplicationGraph()
+{
+	GridCellSize = 10000.0f;
+	SpatialBias = -2097152.0f; // Engine's old world bounds
+	ParkedCellSize = 20000.0f;
+
+	GridNode = nullptr;
+	AlwaysRelevantNode = nullptr;
+	OwnerNode = nullptr;
+	ParkedNode = nullptr;
+}
+
+UDroneReplicationGraph* UDroneReplicationGraph::Get(const UWorld* World)
+{
+	UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	return NetDriver ? Cast<UDroneReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr;
+}
+
+void UDroneReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Class defaults; drones are refined per instance from their replication component
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (!ActorCDO || !ActorCDO->GetIsReplicated())
+			continue;
+
+		// Blueprint compile leftovers
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+			continue;
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+		ClassInfo.SetCullDistanceSquared((ActorCDO->bAlwaysRelevant || ActorCDO->bOnlyRelevantToOwner) ? 0.0f : ActorCDO->NetCullDistanceSquared);
+
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UDroneReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBias, SpatialBias);
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	OwnerNode = CreateNewNode<UDroneReplicationGraphNode_OwnerRelevant>();
+	AddGlobalGraphNode(OwnerNode);
+
+	ParkedNode = CreateNewNode<UDroneReplicationGraphNode_ParkedDrones>();
+	ParkedNode->CellSize = FMath::Max(ParkedCellSize, 1.0f);
+	AddGlobalGraphNode(ParkedNode);
+}
+
+void UDroneReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// Player controller, pawn and view target
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* ConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(ConnectionNode, RepGraphConnection);
+}
+
+void UDroneReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	if (ADroneBase* Drone = Cast<ADroneBase>(ActorInfo.Actor))
+	{
+		ApplyDroneSettings(Drone, Drone->FindComponentByClass<UDroneReplicationComponent>(), GlobalInfo);
+
+		const bool bParked = IsParked(Drone);
+		Drones.Add({ Drone, bParked });
+
+		OwnerNode->NotifyAddNetworkActor(ActorInfo);
+		if (bParked)
+		{
+			ParkedNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		}
+		else
+		{
+			GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		}
+		return;
+	}
+
+	if (ActorInfo.Actor->bAlwaysRelevant)
+	{
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else if (ActorInfo.Actor->bOnlyRelevantToOwner)
+	{
+		OwnerNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else
+	{
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+	}
+}
+
+void UDroneReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	if (ADroneBase* Drone = Cast<ADroneBase>(ActorInfo.Actor))
+	{
+		const int32 Index = Drones.IndexOfByPredicate([Drone](const FTrackedDrone& Tracked) { return Tracked.Drone == Drone; });
+		const bool bParked = Drones.IsValidIndex(Index) && Drones[Index].bParked;
+		if (Drones.IsValidIndex(Index))
+		{
+			Drones.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+
+		OwnerNode->NotifyRemoveNetworkActor(ActorInfo);
+		if (bParked)
+		{
+			ParkedNode->RemoveActor_Dormancy(ActorInfo, GlobalActorReplicationInfoMap.Get(Drone));
+		}
+		else
+		{
+			GridNode->RemoveActor_Dormancy(ActorInfo);
+		}
+		return;
+	}
+
+	if (ActorInfo.Actor->bAlwaysRelevant)
+	{
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+	else if (ActorInfo.Actor->bOnlyRelevantToOwner)
+	{
+		OwnerNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+	else
+	{
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+	}
+}
+
+int32 UDroneReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	UpdateParkedDrones();
+	return Super::ServerReplicateActors(DeltaSeconds);
+}
+
+void UDroneReplicationGraph::RefreshDroneSettings(ADroneBase* Drone)
+{
+	FGlobalActorReplicationInfo* GlobalInfo = Drone ? GlobalActorReplicationInfoMap.Find(Drone) : nullptr;
+	if (!GlobalInfo)
+		return;
+
+	ApplyDroneSettings(Drone, Drone->FindComponentByClass<UDroneReplicationComponent>(), *GlobalInfo);
+}
+
+void UDroneReplicationGraph::SetConnectionUpdateRate(ADroneBase* Drone, UNetConnection* Connection, float UpdateRate)
+{
+	UNetReplicationGraphConnection* ConnectionManager = Connection ? Cast<UNetReplicationGraphConnection>(Connection->GetReplicationConnectionDriver()) : nullptr;
+	if (!Drone || !ConnectionManager || !GlobalActorReplicationInfoMap.Find(Drone))
+		return;
+
+	FConnectionReplicationActorInfo& ConnectionInfo = ConnectionManager->ActorInfoMap.FindOrAdd(Drone);
+	ConnectionInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(FMath::Max(UpdateRate, 0.1f));
+}
+
+bool UDroneReplicationGraph::IsParked(const ADroneBase* Drone)
+{
+	// Docking deactivates the drone, so this covers docked drones too
+	return !Drone->IsActive();
+}
+
+void UDroneReplicationGraph::ApplyDroneSettings(const ADroneBase* Drone, const UDroneReplicationComponent* Replication, FGlobalActorReplicationInfo& GlobalInfo) const
+{
+	GlobalInfo.Settings.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(Drone->NetUpdateFrequency);
+
+	if (!Replication)
+		return;
+
+	// Same base range as UDroneReplicationComponent::IsRelevantAtDistance; the grid has no per-team cull, so teammates get no extension
+	const float MaxDistance = Replication->GetMaxRelevancyDistance();
+	GlobalInfo.Settings.SetCullDistanceSquared(MaxDistance * MaxDistance);
+
+	// GetReplicationPriority scales the distance bonus by DistancePriorityScale relative to BasePriority;
+	// the graph sorts by an additive distance penalty, so the same ratio weights it
+	GlobalInfo.Settings.DistancePriorityScale = Replication->GetDistancePriorityScale() / FMath::Max(Replication->GetBasePriority(), KINDA_SMALL_NUMBER);
+
+	ParkedNode->GatherDistance = FMath::Max(ParkedNode->GatherDistance, MaxDistance);
+}
+
+void UDroneReplicationGraph::UpdateParkedDrones()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DroneRepGraphParkedUpdate);
+
+	for (FTrackedDrone& Tracked : Drones)
+	{
+		const bool bParked = IsParked(Tracked.Drone);
+		if (bParked == Tracked.bParked)
+			continue;
+
+		Tracked.bParked = bParked;
+
+		const FNewReplicatedActorInfo ActorInfo(Tracked.Drone);
+		FGlobalActorReplicationInfo& GlobalInfo = GlobalActorReplicationInfoMap.Get(Tracked.Drone);
+		if (bParked)
+		{
+			GridNode->RemoveActor_Dormancy(ActorInfo);
+			ParkedNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		}
+		else
+		{
+			ParkedNode->RemoveActor_Dormancy(ActorInfo, GlobalInfo);
+			GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_DroneRepGraphParked, ParkedNode->Num());
+}
@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneSnapshotInterpolator.h"
+
+FDroneSnapshotInterpolator::FDroneSnapshotInterpolator()
+{
+	Reset();
+}
+
+void FDroneSnapshotInterpolator::Reset()
+{
+	Head = 0;
+	Count = 0;
+	AverageInterval = 0.05f;
+	LastReceiveTime = 0.0f;
+	CurrentDelay = Settings.MinDelay;
+	Stats = FDroneInterpolationStats();
+}
+
+void FDroneSnapshotInterpolator::AddSnapshot(const FDroneMovementSnapshot& Snapshot, float ReceiveTime)
+{
+	if (Count > 0)
+	{
+		const FDroneMovementSnapshot& Newest = GetSnapshot(Count - 1);
+
+		// Duplicates are ignored, reordered packets are too late to use
+		if (Snapshot.Timestamp <= Newest.Timestamp)
+		{
+			if (Snapshot.Timestamp < Newest.Timestamp)
+			{
+				++Stats.LateSnapshots;
+			}
+			return;
+		}
+
+		const float SendInterval = Snapshot.Timestamp - Newest.Timestamp;
+		const float ArrivalInterval = ReceiveTime - LastReceiveTime;
+
+		// Interarrival jitter (RFC 3550)
+		Stats.Jitter += (FMath::Abs(ArrivalInterval - SendInterval) - Stats.Jitter) / 16.0f;
+		AverageInterval += (SendInterval - AverageInterval) / 8.0f;
+	}
+
+	// How old snapshots are when they land; the render delay has to cover it
+	const float Transit = FMath::Max(ReceiveTime - Snapshot.Timestamp, 0.0f);
+	Stats.TransitTime = (Count > 0) ? Stats.TransitTime + (Transit - Stats.TransitTime) / 16.0f : Transit;
+
+	LastReceiveTime = ReceiveTime;
+
+	if (Count == Capacity)
+	{
+		Head = (Head + 1) % Capacity;
+		--Count;
+	}
+
+	Snapshots[(Head + Count) % Capacity] = Snapshot;
+	++Count;
+}
+
+bool FDroneSnapshotInterpolator::Sample(float ServerTime, float DeltaTime, FDroneFlightState& OutState)
+{
+	if (Count == 0)
+		return false;
+
+	// One snapshot interval plus headroom for the measured jitter
+	const float TargetDelay = FMath::Clamp(AverageInterval + Settings.JitterMultiplier * Stats.Jitter, Settings.MinDelay, Settings.MaxDelay);
+	CurrentDelay = FMath::FInterpConstantTo(CurrentDelay, TargetDelay, DeltaTime, Settings.DelayAdjustRate);
+
+	const float RenderTime = ServerTime - Stats.TransitTime - CurrentDelay;
+
+	// Discard snapshots we have fully played past, keeping the one we blend from
+	while (Count >= 2 && GetSnapshot(1).Timestamp <= RenderTime)
+	{
+		Head = (Head + 1) % Capacity;
+		--Count;
+	}
+
+	Stats.BufferedSnapshots = Count;
+	Stats.InterpolationDelay = CurrentDelay;
+	Stats.RenderTime = RenderTime;
+
+	const FDroneMovementSnapshot& From = GetSnapshot(0);
+
+	if (RenderTime <= From.Timestamp)
+	{
+		OutState = FDroneFlightState(From.Location, From.Rotation, From.Velocity);
+		return true;
+	}
+
+	if (Count >= 2)
+	{
+		const FDroneMovementSnapshot& To = GetSnapshot(1);
+		const float Alpha = (RenderTime - From.Timestamp) / (To.Timestamp - From.Timestamp);
+		OutState = Hermite(From, To, Alpha);
+		return true;
+	}
+
+	// Packets are late: extrapolate along the last velocity, then hold
+	const float Overshoot = RenderTime - From.Timestamp;
+	if (Overshoot > Settings.MaxExtrapolationTime)
+	{
+		++Stats.StarvedSamples;
+	}
+	else
+	{
+		++Stats.ExtrapolatedSamples;
+	}
+
+	const float ExtrapolationTime = FMath::Min(Overshoot, Settings.MaxExtrapolationTime);
+	OutState = FDroneFlightState(From.Location + From.Velocity * ExtrapolationTime, From.Rotation, From.Velocity);
+	return true;
+}
+
+FDroneFlightState FDroneSnapshotInterpolator::Hermite(const FDroneMovementSnapshot& From, const FDroneMovementSnapshot& To, float Alpha)
+{
+	const float Interval = To.Timestamp - From.Timestamp;
+
+	// Velocities scaled to the interval are the curve tangents
+	FDroneFlightState Result;
+	Result.Location = FMath::CubicInterp(From.Location, From.Velocity * Interval, To.Location, To.Velocity * Interval, Alpha);
+	Result.Velocity = FMath::Lerp(From.Velocity, To.Velocity, Alpha);
+	Result.Rotation = FQuat::Slerp(From.Rotation.Quaternion(), To.Rotation.Quaternion(), Alpha).Rotator();
+	return Result;
+}
@@ -4,6 +4,8 @@
 
 #define LOCTEXT_NAMESPACE "FDroneSystemProModule"
 
+DEFINE_LOG_CATEGORY(LogDroneSystem);
+
 void FDroneSystemProModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
@@ -0,0 +1,188 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneTerrainSubsystem.h"
+#include "DroneSystemPro.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Terrain Tile Build"), STAT_DroneTerrainTileBuild, STATGROUP_DroneSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Terrain Tiles"), STAT_DroneTerrainTiles, STATGROUP_DroneSystem);
+
+namespace DroneTerrainPrivate
+{
+	/** Division rounding towards negative infinity */
+	FORCEINLINE int32 FloorDivide(int32 Value, int32 Divisor)
+	{
+		return (Value >= 0) ? Value / Divisor : (Value - Divisor + 1) / Divisor;
+	}
+}
+
+FDroneHeightfieldCache::FDroneHeightfieldCache(float InSampleSpacing, int32 InTileResolution, int32 InMaxTiles)
+{
+	Reset(InSampleSpacing, InTileResolution, InMaxTiles);
+}
+
+void FDroneHeightfieldCache::Reset(float InSampleSpacing, int32 InTileResolution, int32 InMaxTiles)
+{
+	Tiles.Reset();
+	SampleSpacing = FMath::Max(InSampleSpacing, 1.0f);
+	TileResolution = FMath::Clamp(InTileResolution, 2, 64);
+	MaxTiles = FMath::Max(InMaxTiles, 4);
+	UseCounter = 0;
+}
+
+FIntPoint FDroneHeightfieldCache::GetTileCoord(const FVector2D& Location) const
+{
+	const int32 SampleX = FMath::FloorToInt(Location.X / SampleSpacing);
+	const int32 SampleY = FMath::FloorToInt(Location.Y / SampleSpacing);
+	return FIntPoint(DroneTerrainPrivate::FloorDivide(SampleX, TileResolution), DroneTerrainPrivate::FloorDivide(SampleY, TileResolution));
+}
+
+FDroneHeightfieldCache::FTile& FDroneHeightfieldCache::FindOrBuildTile(const FIntPoint& Coord, FGroundSampler Sampler)
+{
+	if (FTile* Existing = Tiles.Find(Coord))
+	{
+		Existing->LastUsed = ++UseCounter;
+		return *Existing;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_DroneTerrainTileBuild);
+
+	if (Tiles.Num() >= MaxTiles)
+	{
+		EvictLeastRecentlyUsed();
+	}
+
+	FTile& Tile = Tiles.Add(Coord);
+	Tile.LastUsed = ++UseCounter;
+	Tile.Heights.SetNumUninitialized(TileResolution * TileResolution);
+
+	const FVector2D TileOrigin = FVector2D(Coord) * GetTileSize();
+	for (int32 Y = 0; Y < TileResolution; ++Y)
+	{
+		for (int32 X = 0; X < TileResolution; ++X)
+		{
+			Tile.Heights[X + Y * TileResolution] = Sampler(TileOrigin + FVector2D(X, Y) * SampleSpacing);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_DroneTerrainTiles, Tiles.Num());
+	return Tile;
+}
+
+void FDroneHeightfieldCache::EvictLeastRecentlyUsed()
+{
+	// Runs once per tile build at most, so a scan is fine
+	const FIntPoint* Oldest = nullptr;
+	uint64 OldestUse = MAX_uint64;
+	for (const TPair<FIntPoint, FTile>& Pair : Tiles)
+	{
+		if (Pair.Value.LastUsed < OldestUse)
+		{
+			OldestUse = Pair.Value.LastUsed;
+			Oldest = &Pair.Key;
+		}
+	}
+
+	if (Oldest)
+	{
+		const FIntPoint Coord = *Oldest;
+		Tiles.Remove(Coord);
+	}
+}
+
+float FDroneHeightfieldCache::GetSample(int32 SampleX, int32 SampleY, FGroundSampler Sampler)
+{
+	const FIntPoint Coord(DroneTerrainPrivate::FloorDivide(SampleX, TileResolution), DroneTerrainPrivate::FloorDivide(SampleY, TileResolution));
+	const FTile& Tile = FindOrBuildTile(Coord, Sampler);
+
+	const int32 LocalX = SampleX - Coord.X * TileResolution;
+	const int32 LocalY = SampleY - Coord.Y * TileResolution;
+	return Tile.Heights[LocalX + LocalY * TileResolution];
+}
+
+bool FDroneHeightfieldCache::GetHeight(const FVector2D& Location, FGroundSampler Sampler, float& OutHeight)
+{
+	const FVector2D Grid = Location / SampleSpacing;
+	const int32 X0 = FMath::FloorToInt(Grid.X);
+	const int32 Y0 = FMath::FloorToInt(Grid.Y);
+	const float AlphaX = static_cast<float>(Grid.X - X0);
+	const float AlphaY = static_cast<float>(Grid.Y - Y0);
+
+	const float H00 = GetSample(X0, Y0, Sampler);
+	const float H10 = GetSample(X0 + 1, Y0, Sampler);
+	const float H01 = GetSample(X0, Y0 + 1, Sampler);
+	const float H11 = GetSample(X0 + 1, Y0 + 1, Sampler);
+
+	if (H00 != NoGround && H10 != NoGround && H01 != NoGround && H11 != NoGround)
+	{
+		OutHeight = FMath::Lerp(FMath::Lerp(H00, H10, AlphaX), FMath::Lerp(H01, H11, AlphaX), AlphaY);
+		return true;
+	}
+
+	// Ledges and holes: stay above the highest neighbour rather than blending with nothing
+	OutHeight = FMath::Max(FMath::Max(H00, H10), FMath::Max(H01, H11));
+	return OutHeight != NoGround;
+}
+
+UDroneTerrainSubsystem::UDroneTerrainSubsystem()
+{
+	SampleSpacing = 400.0f;
+	TileResolution = 16;
+	MaxCachedTiles = 512;
+	TraceMaxZ = 100000.0f;
+	TraceMinZ = -100000.0f;
+}
+
+void UDroneTerrainSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Cache.Reset(SampleSpacing, TileResolution, MaxCachedTiles);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UDroneTerrainSubsystem::HandleLevelChanged);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UDroneTerrainSubsystem::HandleLevelChanged);
+}
+
+void UDroneTerrainSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	Invalidate();
+
+	Super::Deinitialize();
+}
+
+void UDroneTerrainSubsystem::HandleLevelChanged(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld())
+	{
+		Invalidate();
+	}
+}
+
+void UDroneTerrainSubsystem::Invalidate()
+{
+	Cache.Reset(SampleSpacing, TileResolution, MaxCachedTiles);
+}
+
+float UDroneTerrainSubsystem::TraceGround(const FVector2D& Location) const
+{
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(DroneTerrainSample), false);
+
+	FHitResult Hit;
+	if (!GetWorld()->LineTraceSingleByObjectType(Hit, FVector(Location, TraceMaxZ), FVector(Location, TraceMinZ), FCollisionObjectQueryParams(ECC_WorldStatic), Params))
+		return FDroneHeightfieldCache::NoGround;
+
+	return static_cast<float>(Hit.ImpactPoint.Z);
+}
+
+bool UDroneTerrainSubsystem::GetGroundHeight(const FVector& Location, float& OutHeight)
+{
+	return Cache.GetHeight(FVector2D(Location), [this](const FVector2D& Sample) { return TraceGround(Sample); }, OutHeight);
+}
+
+float UDroneTerrainSubsystem::GetHeightAboveGround(FVector Location)
+{
+	float GroundHeight;
+	return GetGroundHeight(Location, GroundHeight) ? Location.Z - GroundHeight : Location.Z;
+}
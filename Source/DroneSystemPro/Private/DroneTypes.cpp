@@ -0,0 +1,272 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneTypes.h"
+#include "Engine/NetSerialization.h"
+#include "UObject/CoreNet.h"
+
+namespace DroneSnapshotFlags
+{
+	// Set when the field differs from its rest value; cleared fields cost no payload
+	constexpr uint8 HasVelocity = 1 << 0;
+	constexpr uint8 HasPitch = 1 << 1;
+	constexpr uint8 HasRoll = 1 << 2;
+
+	constexpr uint32 NumBits = 3;
+}
+
+namespace DroneModeBits
+{
+	// Speed mode in bit 0, vision mode in bits 1-2
+	constexpr uint32 NumBits = 3;
+
+	uint8 Pack(EDroneSpeedMode SpeedMode, EDroneVisionMode VisionMode)
+	{
+		return (static_cast<uint8>(SpeedMode) & 1) | ((static_cast<uint8>(VisionMode) & 3) << 1);
+	}
+
+	void Unpack(uint8 Bits, EDroneSpeedMode& OutSpeedMode, EDroneVisionMode& OutVisionMode)
+	{
+		OutSpeedMode = static_cast<EDroneSpeedMode>(Bits & 1);
+		OutVisionMode = static_cast<EDroneVisionMode>(FMath::Min<uint8>((Bits >> 1) & 3, static_cast<uint8>(EDroneVisionMode::Thermal)));
+	}
+}
+
+bool FDroneMovementSnapshot::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint8 Flags = 0;
+	uint16 Yaw = 0;
+	uint16 Pitch = 0;
+	uint16 Roll = 0;
+
+	if (Ar.IsSaving())
+	{
+		Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+		Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+		Roll = FRotator::CompressAxisToShort(Rotation.Roll);
+
+		// Velocity below the 0.1 quantization step would round to zero anyway
+		Flags |= Velocity.IsNearlyZero(0.05f) ? 0 : DroneSnapshotFlags::HasVelocity;
+		Flags |= (Pitch != 0) ? DroneSnapshotFlags::HasPitch : 0;
+		Flags |= (Roll != 0) ? DroneSnapshotFlags::HasRoll : 0;
+	}
+
+	Ar.SerializeBits(&Flags, DroneSnapshotFlags::NumBits);
+
+	bOutSuccess &= SerializePackedVector<10, 24>(Location, Ar);
+
+	if (Flags & DroneSnapshotFlags::HasVelocity)
+	{
+		bOutSuccess &= SerializePackedVector<10, 18>(Velocity, Ar);
+	}
+	else if (Ar.IsLoading())
+	{
+		Velocity = FVector::ZeroVector;
+	}
+
+	Ar << Yaw;
+	if (Flags & DroneSnapshotFlags::HasPitch)
+	{
+		Ar << Pitch;
+	}
+	if (Flags & DroneSnapshotFlags::HasRoll)
+	{
+		Ar << Roll;
+	}
+
+	// Only the low 16 bits travel; receivers widen with ExpandInputID
+	uint16 WireInputID = static_cast<uint16>(InputID);
+	Ar << WireInputID;
+
+	// Wrapped ticks; receivers widen with ExpandTimestamp
+	uint16 WireTimestamp = FDroneNetTime::ToTicks(Timestamp);
+	Ar << WireTimestamp;
+
+	uint8 Modes = DroneModeBits::Pack(SpeedMode, VisionMode);
+	Ar.SerializeBits(&Modes, DroneModeBits::NumBits);
+
+	if (Ar.IsLoading())
+	{
+		Timestamp = static_cast<float>(WireTimestamp / FDroneNetTime::TicksPerSecond);
+		Rotation.Yaw = FRotator::DecompressAxisFromShort(Yaw);
+		Rotation.Pitch = (Flags & DroneSnapshotFlags::HasPitch) ? FRotator::DecompressAxisFromShort(Pitch) : 0.0f;
+		Rotation.Roll = (Flags & DroneSnapshotFlags::HasRoll) ? FRotator::DecompressAxisFromShort(Roll) : 0.0f;
+		InputID = WireInputID;
+		DroneModeBits::Unpack(Modes, SpeedMode, VisionMode);
+	}
+
+	return true;
+}
+
+int32 FDroneMovementSnapshot::GetSerializedBits() const
+{
+	FNetBitWriter Writer(nullptr, 512);
+	FDroneMovementSnapshot Copy = *this;
+	bool bSuccess = false;
+	Copy.NetSerialize(Writer, nullptr, bSuccess);
+	return static_cast<int32>(Writer.GetNumBits());
+}
+
+namespace DroneInputQuantization
+{
+	constexpr float LookScale = 256.0f;
+	constexpr float DeltaTimeScale = 10000.0f;
+
+	int8 QuantizeAxis(float Value)
+	{
+		return static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Value, -1.0f, 1.0f) * 127.0f));
+	}
+
+	float DequantizeAxis(int8 Value)
+	{
+		return Value / 127.0f;
+	}
+
+	int16 QuantizeLook(float Value)
+	{
+		return static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Value * LookScale), -MAX_int16, MAX_int16));
+	}
+
+	float DequantizeLook(int16 Value)
+	{
+		return Value / LookScale;
+	}
+
+	uint16 QuantizeDeltaTime(float Value)
+	{
+		return static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Value * DeltaTimeScale), 0, static_cast<int32>(MAX_uint16)));
+	}
+
+	float DequantizeDeltaTime(uint16 Value)
+	{
+		return Value / DeltaTimeScale;
+	}
+}
+
+void FDroneInputState::SerializeQuantized(FArchive& Ar)
+{
+	using namespace DroneInputQuantization;
+
+	int8 Move[3] = { QuantizeAxis(MovementInput.X), QuantizeAxis(MovementInput.Y), QuantizeAxis(MovementInput.Z) };
+	int16 Look[2] = { QuantizeLook(LookInput.X), QuantizeLook(LookInput.Y) };
+	uint16 WireDeltaTime = QuantizeDeltaTime(DeltaTime);
+
+	// Idle sticks are common; one bit each skips the payload
+	uint8 bHasMove = (Move[0] | Move[1] | Move[2]) != 0;
+	uint8 bHasLook = (Look[0] | Look[1]) != 0;
+	Ar.SerializeBits(&bHasMove, 1);
+	Ar.SerializeBits(&bHasLook, 1);
+
+	if (bHasMove)
+	{
+		Ar << Move[0] << Move[1] << Move[2];
+	}
+	else
+	{
+		Move[0] = Move[1] = Move[2] = 0;
+	}
+
+	if (bHasLook)
+	{
+		Ar << Look[0] << Look[1];
+	}
+	else
+	{
+		Look[0] = Look[1] = 0;
+	}
+
+	Ar << WireDeltaTime;
+
+	uint8 Modes = DroneModeBits::Pack(SpeedMode, VisionMode);
+	Ar.SerializeBits(&Modes, DroneModeBits::NumBits);
+
+	if (Ar.IsLoading())
+	{
+		MovementInput = FVector(DequantizeAxis(Move[0]), DequantizeAxis(Move[1]), DequantizeAxis(Move[2]));
+		LookInput = FVector2D(DequantizeLook(Look[0]), DequantizeLook(Look[1]));
+		DeltaTime = DequantizeDeltaTime(WireDeltaTime);
+		DroneModeBits::Unpack(Modes, SpeedMode, VisionMode);
+	}
+}
+
+void FDroneInputState::Quantize()
+{
+	using namespace DroneInputQuantization;
+
+	MovementInput = FVector(
+		DequantizeAxis(QuantizeAxis(MovementInput.X)),
+		DequantizeAxis(QuantizeAxis(MovementInput.Y)),
+		DequantizeAxis(QuantizeAxis(MovementInput.Z)));
+	LookInput = FVector2D(DequantizeLook(QuantizeLook(LookInput.X)), DequantizeLook(QuantizeLook(LookInput.Y)));
+	DeltaTime = DequantizeDeltaTime(QuantizeDeltaTime(DeltaTime));
+}
+
+bool FDroneInputPacket::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint32 NumInputs = FMath::Min(Inputs.Num(), MaxInputs);
+	Ar.SerializeInt(NumInputs, MaxInputs + 1);
+
+	uint8 bPing = bHasClockPing;
+	Ar.SerializeBits(&bPing, 1);
+	bHasClockPing = bPing != 0;
+	if (bHasClockPing)
+	{
+		Ar << ClockPingTicks;
+	}
+
+	if (NumInputs == 0)
+	{
+		Inputs.Reset();
+		return true;
+	}
+
+	// Only the newest ID and timestamp are sent; the rest are consecutive
+	const int32 FirstIndex = Inputs.Num() - static_cast<int32>(NumInputs);
+	uint32 NewestID = Ar.IsSaving() ? Inputs.Last().InputID : 0;
+	Ar << NewestID;
+
+	uint16 NewestTicks = Ar.IsSaving() ? FDroneNetTime::ToTicks(Inputs.Last().Timestamp) : 0;
+	Ar << NewestTicks;
+
+	if (Ar.IsLoading())
+	{
+		Inputs.SetNum(NumInputs);
+	}
+
+	for (uint32 Index = 0; Index < NumInputs; ++Index)
+	{
+		FDroneInputState& Input = Inputs[Ar.IsSaving() ? FirstIndex + Index : Index];
+		Input.SerializeQuantized(Ar);
+
+		if (Ar.IsLoading())
+		{
+			Input.InputID = NewestID - (NumInputs - 1 - Index);
+		}
+	}
+
+	if (Ar.IsLoading())
+	{
+		// Each input was sampled one delta before the next
+		float Timestamp = static_cast<float>(NewestTicks / FDroneNetTime::TicksPerSecond);
+		for (int32 Index = Inputs.Num() - 1; Index >= 0; --Index)
+		{
+			Inputs[Index].Timestamp = Timestamp;
+			Timestamp -= Inputs[Index].DeltaTime;
+		}
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+float FDroneInputPacket::GetTimestampCorrection(float Reference) const
+{
+	if (Inputs.Num() == 0)
+		return 0.0f;
+
+	const float WireTimestamp = Inputs.Last().Timestamp;
+	return FDroneNetTime::Expand(FDroneNetTime::ToTicks(WireTimestamp), Reference) - WireTimestamp;
+}
@@ -1,8 +1,10 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DroneUtilityComponent.h"
+#include "DronePushModel.h"
 #include "DroneBatteryComponent.h"
 #include "DroneMovementComponent.h"
+#include "DroneTerrainSubsystem.h"
 #include "Components/SpotLightComponent.h"
 #include "GameFramework/Actor.h"
 #include "Net/UnrealNetwork.h"
@@ -48,7 +50,10 @@ void UDroneUtilityComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UDroneUtilityComponent, bFlashlightEnabled);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDroneUtilityComponent, bFlashlightEnabled, Params);
 }
 
 void UDroneUtilityComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -66,6 +71,7 @@ void UDroneUtilityComponent::SetFlashlightEnabled(bool bEnabled)
 	if (GetOwner() && GetOwner()->HasAuthority())
 	{
 		bFlashlightEnabled = bEnabled;
+		DRONE_MARK_PROPERTY_DIRTY(UDroneUtilityComponent, bFlashlightEnabled, this);
 		Multicast_SetFlashlight(bEnabled);
 		NotifyBatteryComponent(bEnabled);
 	}
@@ -78,6 +84,7 @@ void UDroneUtilityComponent::SetFlashlightEnabled(bool bEnabled)
 void UDroneUtilityComponent::Server_SetFlashlight_Implementation(bool bEnabled)
 {
 	bFlashlightEnabled = bEnabled;
+	DRONE_MARK_PROPERTY_DIRTY(UDroneUtilityComponent, bFlashlightEnabled, this);
 	Multicast_SetFlashlight(bEnabled);
 	NotifyBatteryComponent(bEnabled);
 }
@@ -90,6 +97,7 @@ bool UDroneUtilityComponent::Server_SetFlashlight_Validate(bool bEnabled)
 void UDroneUtilityComponent::Multicast_SetFlashlight_Implementation(bool bEnabled)
 {
 	bFlashlightEnabled = bEnabled;
+	DRONE_MARK_PROPERTY_DIRTY(UDroneUtilityComponent, bFlashlightEnabled, this);
 	UpdateFlashlightVisual();
 	OnFlashlightToggled.Broadcast(bEnabled);
 }
@@ -152,7 +160,9 @@ float UDroneUtilityComponent::GetAltitude() const
 	if (!GetOwner())
 		return 0.0f;
 
-	return GetOwner()->GetActorLocation().Z;
+	const FVector Location = GetOwner()->GetActorLocation();
+	UDroneTerrainSubsystem* Terrain = GetWorld() ? GetWorld()->GetSubsystem<UDroneTerrainSubsystem>() : nullptr;
+	return Terrain ? Terrain->GetHeightAboveGround(Location) : Location.Z;
 }
 
 float UDroneUtilityComponent::GetSpeed() const
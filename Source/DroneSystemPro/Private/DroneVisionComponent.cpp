@@ -1,7 +1,10 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DroneVisionComponent.h"
+#include "DroneBase.h"
 #include "DroneBatteryComponent.h"
+#include "DroneMovementComponent.h"
+#include "DronePushModel.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/Character.h"
 #include "Net/UnrealNetwork.h"
@@ -17,6 +20,8 @@ UDroneVisionComponent::UDroneVisionComponent()
 	JammingIntensity = 0.0f;
 	LastScanTime = 0.0f;
 	ScanInterval = 0.5f; // Scan every 0.5 seconds
+	MaxThermalDetections = 8;
+	ThermalDetail = 1.0f;
 }
 
 void UDroneVisionComponent::BeginPlay()
@@ -30,8 +35,13 @@ void UDroneVisionComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UDroneVisionComponent, CurrentVisionMode);
-	DOREPLIFETIME(UDroneVisionComponent, ThermalDetections);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDroneVisionComponent, ThermalDetections, Params);
+
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDroneVisionComponent, CurrentVisionMode, Params);
 }
 
 void UDroneVisionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -41,11 +51,17 @@ void UDroneVisionComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 	if (!GetOwner() || !GetOwner()->HasAuthority())
 		return;
 
+	// Parked drones stop scanning so they can go dormant
+	const ADroneBase* Drone = Cast<ADroneBase>(GetOwner());
+	if (Drone && !Drone->IsActive())
+		return;
+
 	// Automatic thermal scanning in thermal mode
 	if (CurrentVisionMode == EDroneVisionMode::Thermal)
 	{
 		float CurrentTime = GetWorld()->GetTimeSeconds();
-		if (CurrentTime - LastScanTime >= ScanInterval)
+		// Reduced detail scans less often, down to a quarter of the rate
+		if (CurrentTime - LastScanTime >= ScanInterval / FMath::Max(ThermalDetail, 0.25f))
 		{
 			PerformThermalDetection();
 			LastScanTime = CurrentTime;
@@ -58,15 +74,38 @@ void UDroneVisionComponent::SetVisionMode(EDroneVisionMode NewMode)
 	if (GetOwner() && GetOwner()->HasAuthority())
 	{
 		CurrentVisionMode = NewMode;
+		DRONE_MARK_PROPERTY_DIRTY(UDroneVisionComponent, CurrentVisionMode, this);
 		Multicast_SetVisionMode(NewMode);
 		NotifyBatteryComponent(NewMode);
 	}
+	else if (IsPredictedLocally())
+	{
+		// The next input carries it; reconciliation rolls it back if the server disagrees
+		SetPredictedVisionMode(NewMode);
+	}
 	else
 	{
 		Server_SetVisionMode(NewMode);
 	}
 }
 
+void UDroneVisionComponent::SetPredictedVisionMode(EDroneVisionMode NewMode)
+{
+	if (CurrentVisionMode == NewMode)
+		return;
+
+	CurrentVisionMode = NewMode;
+	DRONE_MARK_PROPERTY_DIRTY(UDroneVisionComponent, CurrentVisionMode, this);
+	ApplyVisionPostProcess();
+	OnVisionModeChanged.Broadcast(NewMode);
+}
+
+bool UDroneVisionComponent::IsPredictedLocally() const
+{
+	const AActor* Owner = GetOwner();
+	return Owner && Owner->GetLocalRole() == ROLE_AutonomousProxy && Owner->FindComponentByClass<UDroneMovementComponent>();
+}
+
 void UDroneVisionComponent::CycleVisionMode()
 {
 	EDroneVisionMode NewMode;
@@ -119,9 +158,15 @@ void UDroneVisionComponent::SetJammingIntensity(float Intensity)
 	JammingIntensity = FMath::Clamp(Intensity, 0.0f, 1.0f);
 }
 
+void UDroneVisionComponent::SetThermalDetail(float Detail)
+{
+	ThermalDetail = FMath::Clamp(Detail, 0.0f, 1.0f);
+}
+
 void UDroneVisionComponent::Server_SetVisionMode_Implementation(EDroneVisionMode NewMode)
 {
 	CurrentVisionMode = NewMode;
+	DRONE_MARK_PROPERTY_DIRTY(UDroneVisionComponent, CurrentVisionMode, this);
 	Multicast_SetVisionMode(NewMode);
 	NotifyBatteryComponent(NewMode);
 }
@@ -133,7 +178,12 @@ bool UDroneVisionComponent::Server_SetVisionMode_Validate(EDroneVisionMode NewMo
 
 void UDroneVisionComponent::Multicast_SetVisionMode_Implementation(EDroneVisionMode NewMode)
 {
+	// A late echo would undo newer predicted toggles; the owner hears back through reconciliation
+	if (IsPredictedLocally())
+		return;
+
 	CurrentVisionMode = NewMode;
+	DRONE_MARK_PROPERTY_DIRTY(UDroneVisionComponent, CurrentVisionMode, this);
 	ApplyVisionPostProcess();
 	OnVisionModeChanged.Broadcast(NewMode);
 }
@@ -150,6 +200,7 @@ void UDroneVisionComponent::PerformThermalDetection()
 		return;
 
 	ThermalDetections.Empty();
+	DRONE_MARK_PROPERTY_DIRTY(UDroneVisionComponent, ThermalDetections, this);
 
 	float DetectionRange = FMath::Min(GetEffectiveSensorRange(), DroneConfig->ThermalDetectionRange);
 	FVector OwnerLocation = GetOwner()->GetActorLocation();
@@ -176,6 +227,17 @@ void UDroneVisionComponent::PerformThermalDetection()
 		}
 	}
 
+	// Under a bandwidth budget only the hottest signatures replicate
+	if (ThermalDetail < 1.0f)
+	{
+		const int32 MaxDetections = FMath::Max(1, FMath::CeilToInt(MaxThermalDetections * ThermalDetail));
+		if (ThermalDetections.Num() > MaxDetections)
+		{
+			ThermalDetections.Sort([](const FThermalDetection& A, const FThermalDetection& B) { return A.HeatSignature > B.HeatSignature; });
+			ThermalDetections.SetNum(MaxDetections);
+		}
+	}
+
 	// Broadcast detection event
 	OnThermalDetection.Broadcast(ThermalDetections);
 }
@@ -0,0 +1,162 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneWindSubsystem.h"
+#include "DroneWindVolume.h"
+#include "DroneSystemPro.h"
+
+DECLARE_CYCLE_STAT(TEXT("Wind Grid Bake"), STAT_DroneWindBake, STATGROUP_DroneSystem);
+
+FDroneWindGrid::FDroneWindGrid(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+	, Version(1)
+{
+}
+
+void FDroneWindGrid::Reset(float InCellSize)
+{
+	Nodes.Reset();
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	++Version;
+}
+
+void FDroneWindGrid::AddWind(const FIntVector& Node, const FVector& Wind)
+{
+	Nodes.FindOrAdd(Node, FVector3f::ZeroVector) += FVector3f(Wind);
+	++Version;
+}
+
+FIntVector FDroneWindGrid::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+FVector FDroneWindGrid::Sample(const FVector& Location, FDroneWindSampleCache& Cache) const
+{
+	if (Nodes.Num() == 0)
+		return FVector::ZeroVector;
+
+	const FIntVector Cell = GetCell(Location);
+
+	if (Cache.Version != Version || Cache.Cell != Cell)
+	{
+		// Corner bits: 1 = +X, 2 = +Y, 4 = +Z
+		Cache.bCalm = true;
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			const FIntVector Node = Cell + FIntVector(Corner & 1, (Corner >> 1) & 1, (Corner >> 2) & 1);
+			const FVector3f* Wind = Nodes.Find(Node);
+			Cache.Corners[Corner] = Wind ? *Wind : FVector3f::ZeroVector;
+			Cache.bCalm &= (Wind == nullptr);
+		}
+
+		Cache.Cell = Cell;
+		Cache.Version = Version;
+	}
+
+	if (Cache.bCalm)
+		return FVector::ZeroVector;
+
+	const FVector3f Alpha((Location - GetNodeLocation(Cell)) / CellSize);
+	const FVector3f* C = Cache.Corners;
+
+	const FVector3f X00 = FMath::Lerp(C[0], C[1], Alpha.X);
+	const FVector3f X10 = FMath::Lerp(C[2], C[3], Alpha.X);
+	const FVector3f X01 = FMath::Lerp(C[4], C[5], Alpha.X);
+	const FVector3f X11 = FMath::Lerp(C[6], C[7], Alpha.X);
+
+	return FVector(FMath::Lerp(FMath::Lerp(X00, X10, Alpha.Y), FMath::Lerp(X01, X11, Alpha.Y), Alpha.Z));
+}
+
+UDroneWindSubsystem::UDroneWindSubsystem()
+{
+	CellSize = 1000.0f;
+	MaxNodesPerVolume = 262144;
+	bDirty = false;
+}
+
+void UDroneWindSubsystem::Deinitialize()
+{
+	Volumes.Reset();
+	Grid.Reset(CellSize);
+
+	Super::Deinitialize();
+}
+
+void UDroneWindSubsystem::RegisterVolume(ADroneWindVolume* Volume)
+{
+	if (!Volume)
+		return;
+
+	Volumes.AddUnique(Volume);
+	bDirty = true;
+}
+
+void UDroneWindSubsystem::UnregisterVolume(ADroneWindVolume* Volume)
+{
+	if (Volumes.Remove(Volume) > 0)
+	{
+		bDirty = true;
+	}
+}
+
+FVector UDroneWindSubsystem::SampleWind(const FVector& Location, FDroneWindSampleCache& Cache)
+{
+	if (bDirty)
+	{
+		Rebake();
+	}
+
+	return Grid.Sample(Location, Cache);
+}
+
+FVector UDroneWindSubsystem::GetWindAt(FVector Location)
+{
+	FDroneWindSampleCache Cache;
+	return SampleWind(Location, Cache);
+}
+
+void UDroneWindSubsystem::Rebake()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DroneWindBake);
+
+	bDirty = false;
+	Grid.Reset(CellSize);
+
+	Volumes.RemoveAll([](const TWeakObjectPtr<ADroneWindVolume>& Volume) { return !Volume.IsValid(); });
+
+	for (const TWeakObjectPtr<ADroneWindVolume>& Volume : Volumes)
+	{
+		const FBox Bounds = Volume->GetInfluenceBounds();
+		const FIntVector Min = Grid.GetCell(Bounds.Min);
+		const FIntVector Max = Grid.GetCell(Bounds.Max) + FIntVector(1);
+		const FIntVector Size = Max - Min + FIntVector(1);
+
+		if (static_cast<int64>(Size.X) * Size.Y * Size.Z > MaxNodesPerVolume)
+		{
+			UE_LOG(LogDroneSystem, Warning, TEXT("Wind volume %s needs %d x %d x %d nodes at cell size %.0f; skipped"),
+				*Volume->GetName(), Size.X, Size.Y, Size.Z, CellSize);
+			continue;
+		}
+
+		for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+			{
+				for (int32 X = Min.X; X <= Max.X; ++X)
+				{
+					const FIntVector Node(X, Y, Z);
+					const FVector Wind = Volume->GetWindAt(Grid.GetNodeLocation(Node));
+					if (!Wind.IsNearlyZero())
+					{
+						Grid.AddWind(Node, Wind);
+					}
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogDroneSystem, Log, TEXT("Baked wind grid: %d volumes, %d nodes"), Volumes.Num(), Grid.GetNumNodes());
+}
@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DroneWindVolume.h"
+#include "DroneWindSubsystem.h"
+#include "Components/BoxComponent.h"
+#include "Components/ArrowComponent.h"
+#include "Engine/World.h"
+
+ADroneWindVolume::ADroneWindVolume()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	WindBounds = CreateDefaultSubobject<UBoxComponent>(TEXT("WindBounds"));
+	WindBounds->SetBoxExtent(FVector(1000.0f, 1000.0f, 500.0f));
+	WindBounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	WindBounds->SetGenerateOverlapEvents(false);
+	RootComponent = WindBounds;
+
+	WindDirection = CreateDefaultSubobject<UArrowComponent>(TEXT("WindDirection"));
+	WindDirection->SetupAttachment(WindBounds);
+	WindDirection->ArrowSize = 5.0f;
+
+	WindSpeed = 300.0f;
+	FalloffDistance = 200.0f;
+}
+
+void ADroneWindVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UDroneWindSubsystem* WindSubsystem = GetWorld()->GetSubsystem<UDroneWindSubsystem>())
+	{
+		WindSubsystem->RegisterVolume(this);
+	}
+}
+
+void ADroneWindVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDroneWindSubsystem* WindSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UDroneWindSubsystem>() : nullptr)
+	{
+		WindSubsystem->UnregisterVolume(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FVector ADroneWindVolume::GetWindAt(const FVector& Location) const
+{
+	const FVector Extent = WindBounds->GetScaledBoxExtent();
+	const FVector Local = WindBounds->GetComponentTransform().InverseTransformPositionNoScale(Location).GetAbs();
+
+	// Distance to the nearest face, positive inside
+	const float Inside = FMath::Min3(Extent.X - Local.X, Extent.Y - Local.Y, Extent.Z - Local.Z);
+	if (Inside <= 0.0f)
+		return FVector::ZeroVector;
+
+	const float Weight = (FalloffDistance > KINDA_SMALL_NUMBER) ? FMath::Min(Inside / FalloffDistance, 1.0f) : 1.0f;
+	return GetWindVelocity() * Weight;
+}
+
+FBox ADroneWindVolume::GetInfluenceBounds() const
+{
+	return WindBounds->Bounds.GetBox();
+}
+
+void ADroneWindVolume::SetWindSpeed(float NewWindSpeed)
+{
+	WindSpeed = NewWindSpeed;
+
+	if (UDroneWindSubsystem* WindSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UDroneWindSubsystem>() : nullptr)
+	{
+		WindSubsystem->MarkDirty();
+	}
+}
@@ -1,6 +1,9 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "HackingComponent.h"
+#include "DronePushModel.h"
+#include "DroneLagCompensationSubsystem.h"
+#include "DroneNetClockSubsystem.h"
 #include "GameFramework/Actor.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/World.h"
@@ -23,7 +26,10 @@ void UHackingComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Ou
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UHackingComponent, CurrentSession);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHackingComponent, CurrentSession, Params);
 }
 
 void UHackingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -46,27 +52,34 @@ bool UHackingComponent::StartHack(AActor* Target, float Duration)
 
 	if (GetOwner() && GetOwner()->HasAuthority())
 	{
-		if (!ValidateHackTarget(Target))
+		if (!ValidateHackTarget(Target, UDroneNetClockSubsystem::GetServerTime(GetWorld())))
 			return false;
 
-		// Initialize session
-		CurrentSession.HackerActor = GetOwner();
-		CurrentSession.TargetActor = Target;
-		CurrentSession.Duration = Duration;
-		CurrentSession.Progress = 0.0f;
-		CurrentSession.StartTime = GetWorld()->GetTimeSeconds();
-		CurrentSession.bIsActive = true;
-
-		Multicast_HackStarted(GetOwner(), Target);
+		BeginSession(Target, Duration);
 		return true;
 	}
 	else
 	{
-		Server_StartHack(Target, Duration);
+		const UDroneLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UDroneLagCompensationSubsystem>();
+		Server_StartHack(Target, Duration, LagCompensation ? LagCompensation->GetClientViewTime(Target) : UDroneNetClockSubsystem::GetServerTime(GetWorld()));
 		return true;
 	}
 }
 
+void UHackingComponent::BeginSession(AActor* Target, float Duration)
+{
+	// Initialize session
+	CurrentSession.HackerActor = GetOwner();
+	CurrentSession.TargetActor = Target;
+	CurrentSession.Duration = Duration;
+	CurrentSession.Progress = 0.0f;
+	CurrentSession.StartTime = UDroneNetClockSubsystem::GetServerTime(GetWorld());
+	CurrentSession.bIsActive = true;
+	DRONE_MARK_PROPERTY_DIRTY(UHackingComponent, CurrentSession, this);
+
+	Multicast_HackStarted(GetOwner(), Target);
+}
+
 void UHackingComponent::CancelHack()
 {
 	if (GetOwner() && GetOwner()->HasAuthority())
@@ -97,21 +110,18 @@ AActor* UHackingComponent::GetHackTarget() const
 	return CurrentSession.TargetActor;
 }
 
-void UHackingComponent::Server_StartHack_Implementation(AActor* Target, float Duration)
+void UHackingComponent::Server_StartHack_Implementation(AActor* Target, float Duration, float ClientTime)
 {
-	StartHack(Target, Duration);
+	// Out of range at the client's view time is a failed attempt, not a cheat
+	if (IsHacking() || !ValidateHackTarget(Target, ClientTime))
+		return;
+
+	BeginSession(Target, Duration);
 }
 
-bool UHackingComponent::Server_StartHack_Validate(AActor* Target, float Duration)
+bool UHackingComponent::Server_StartHack_Validate(AActor* Target, float Duration, float ClientTime)
 {
-	if (!Target || !GetOwner())
-		return false;
-
-	// Validate range
-	float DistSq = FVector::DistSquared(GetOwner()->GetActorLocation(), Target->GetActorLocation());
-	float MaxRangeSq = HackRange * HackRange;
-
-	return DistSq <= (MaxRangeSq * 1.2f); // Allow some tolerance
+	return Target != nullptr && Duration > 0.0f && FMath::IsFinite(Duration) && FMath::IsFinite(ClientTime);
 }
 
 void UHackingComponent::Server_CancelHack_Implementation()
@@ -150,16 +160,17 @@ void UHackingComponent::ProcessHacking(float DeltaTime)
 		return;
 
 	// Check if hacker is still in range
-	if (!ValidateHackTarget(CurrentSession.TargetActor))
+	if (!ValidateHackTarget(CurrentSession.TargetActor, UDroneNetClockSubsystem::GetServerTime(GetWorld())))
 	{
 		FailHack();
 		return;
 	}
 
 	// Update progress
-	float CurrentTime = GetWorld()->GetTimeSeconds();
+	float CurrentTime = UDroneNetClockSubsystem::GetServerTime(GetWorld());
 	float ElapsedTime = CurrentTime - CurrentSession.StartTime;
 	CurrentSession.Progress = FMath::Clamp(ElapsedTime / CurrentSession.Duration, 0.0f, 1.0f);
+	DRONE_MARK_PROPERTY_DIRTY(UHackingComponent, CurrentSession, this);
 
 	// Send progress update to client
 	if (GetOwner()->GetLocalRole() == ROLE_Authority)
@@ -174,11 +185,15 @@ void UHackingComponent::ProcessHacking(float DeltaTime)
 	}
 }
 
-bool UHackingComponent::ValidateHackTarget(AActor* Target) const
+bool UHackingComponent::ValidateHackTarget(AActor* Target, float Time) const
 {
 	if (!Target || !GetOwner())
 		return false;
 
+	// Compare positions as they were at Time (the present for server-side checks)
+	if (const UDroneLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UDroneLagCompensationSubsystem>())
+		return LagCompensation->WereInRange(GetOwner(), Target, HackRange, Time);
+
 	// Check range
 	float DistSq = FVector::DistSquared(GetOwner()->GetActorLocation(), Target->GetActorLocation());
 	float MaxRangeSq = HackRange * HackRange;
@@ -192,6 +207,7 @@ void UHackingComponent::CompleteHack()
 	AActor* Target = CurrentSession.TargetActor;
 
 	CurrentSession = FHackingSession(); // Reset session
+	DRONE_MARK_PROPERTY_DIRTY(UHackingComponent, CurrentSession, this);
 
 	Multicast_HackCompleted(Hacker, Target);
 }
@@ -202,6 +218,7 @@ void UHackingComponent::FailHack()
 	AActor* Target = CurrentSession.TargetActor;
 
 	CurrentSession = FHackingSession(); // Reset session
+	DRONE_MARK_PROPERTY_DIRTY(UHackingComponent, CurrentSession, this);
 
 	Multicast_HackFailed(Hacker, Target);
 }
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "JammingComponent.h"
+#include "DronePushModel.h"
 #include "DroneBase.h"
 #include "DroneVisionComponent.h"
 #include "DroneBatteryComponent.h"
@@ -28,15 +29,20 @@ void UJammingComponent::BeginPlay()
 
 	JamStrength = DefaultJamStrength;
 	JamRadius = DefaultJamRadius;
+	DRONE_MARK_PROPERTY_DIRTY(UJammingComponent, JamStrength, this);
+	DRONE_MARK_PROPERTY_DIRTY(UJammingComponent, JamRadius, this);
 }
 
 void UJammingComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UJammingComponent, bJammingEnabled);
-	DOREPLIFETIME(UJammingComponent, JamStrength);
-	DOREPLIFETIME(UJammingComponent, JamRadius);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UJammingComponent, bJammingEnabled, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UJammingComponent, JamStrength, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UJammingComponent, JamRadius, Params);
 }
 
 void UJammingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -57,6 +63,7 @@ void UJammingComponent::SetJammingEnabled(bool bEnabled)
 	if (GetOwner() && GetOwner()->HasAuthority())
 	{
 		bJammingEnabled = bEnabled;
+		DRONE_MARK_PROPERTY_DIRTY(UJammingComponent, bJammingEnabled, this);
 	}
 }
 
@@ -65,6 +72,7 @@ void UJammingComponent::SetJamStrength(float Strength)
 	if (GetOwner() && GetOwner()->HasAuthority())
 	{
 		JamStrength = FMath::Clamp(Strength, 0.0f, 2.0f);
+		DRONE_MARK_PROPERTY_DIRTY(UJammingComponent, JamStrength, this);
 	}
 }
 
@@ -73,6 +81,7 @@ void UJammingComponent::SetJamRadius(float Radius)
 	if (GetOwner() && GetOwner()->HasAuthority())
 	{
 		JamRadius = FMath::Max(0.0f, Radius);
+		DRONE_MARK_PROPERTY_DIRTY(UJammingComponent, JamRadius, this);
 	}
 }
 
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "TerminalActor.h"
+#include "DronePushModel.h"
 #include "HackingComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Net/UnrealNetwork.h"
@@ -29,7 +30,10 @@ void ATerminalActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLi
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ATerminalActor, bIsHacked);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATerminalActor, bIsHacked, Params);
 }
 
 void ATerminalActor::SetHacked(bool bHacked)
@@ -37,6 +41,7 @@ void ATerminalActor::SetHacked(bool bHacked)
 	if (HasAuthority())
 	{
 		bIsHacked = bHacked;
+		DRONE_MARK_PROPERTY_DIRTY(ATerminalActor, bIsHacked, this);
 		UpdateVisuals();
 
 		if (bIsHacked)
@@ -51,6 +56,7 @@ void ATerminalActor::ResetTerminal()
 	if (HasAuthority())
 	{
 		bIsHacked = false;
+		DRONE_MARK_PROPERTY_DIRTY(ATerminalActor, bIsHacked, this);
 		UpdateVisuals();
 		OnTerminalReset.Broadcast();
 	}
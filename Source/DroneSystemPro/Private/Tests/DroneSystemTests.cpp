@@ -2,12 +2,41 @@
 
 #include "Misc/AutomationTest.h"
 #include "Tests/AutomationCommon.h"
+#include "UObject/CoreNet.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "DroneBase.h"
 #include "DroneBatteryComponent.h"
 #include "DroneMovementComponent.h"
+#include "DroneMovementWorldSubsystem.h"
+#include "DroneFlightModel.h"
+#include "DroneFlightBatch.h"
+#include "DroneMoveHistory.h"
+#include "DroneWindSubsystem.h"
+#include "DroneObstacleFieldSubsystem.h"
+#include "DroneTerrainSubsystem.h"
+#include "DroneLagCompensationSubsystem.h"
+#include "DroneNetClockSubsystem.h"
+#include "DroneNetReplay.h"
+#include "DroneSnapshotInterpolator.h"
 #include "DroneMarkingComponent.h"
+#include "DroneVisionComponent.h"
+#include "DroneUtilityComponent.h"
+#include "DronePushModel.h"
+#include "DroneReplicationComponent.h"
+#include "DroneReplicationGraph.h"
 #include "JammingComponent.h"
+#include "HackingComponent.h"
 #include "DroneDockingComponent.h"
+#include "TerminalActor.h"
+#include "AIController.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
 
 #if WITH_DEV_AUTOMATION_TESTS
 
@@ -53,6 +82,1597 @@ bool FDroneMovementSpeedTest::RunTest(const FString& Parameters)
 	return true;
 }
 
+// Flight Model Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneFlightModelDeterminismTest, "DroneSystemPro.Movement.FlightModelDeterminism", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneFlightModelDeterminismTest::RunTest(const FString& Parameters)
+{
+	FDroneFlightConfig Config;
+
+	// A recorded run with changing inputs and uneven frame times, like a move history
+	const int32 NumFrames = 240;
+	TArray<FDroneFlightInput> Inputs;
+	TArray<float> DeltaTimes;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const float Phase = Frame * 0.05f;
+		Inputs.Add(FDroneFlightInput(FVector(FMath::Cos(Phase), FMath::Sin(Phase), (Frame % 40 < 20) ? 0.5f : -0.5f), FVector2D(FMath::Sin(Phase * 0.5f), 0.0f), (Frame % 60 < 30) ? EDroneSpeedMode::High : EDroneSpeedMode::Low));
+		DeltaTimes.Add((Frame % 3 == 0) ? 1.0f / 30.0f : 1.0f / 144.0f);
+	}
+
+	// Reconciliation rewinds to an acknowledged state and replays the rest from a copy
+	const int32 AckedFrame = NumFrames / 2;
+	FDroneFlightState Live;
+	FDroneFlightState Acked;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		if (Frame == AckedFrame)
+		{
+			Acked = Live;
+		}
+		FDroneFlightModel::Simulate(Live, Inputs[Frame], Config, DeltaTimes[Frame]);
+	}
+
+	FDroneFlightState Replayed = Acked;
+	for (int32 Frame = AckedFrame; Frame < NumFrames; ++Frame)
+	{
+		FDroneFlightModel::Simulate(Replayed, Inputs[Frame], Config, DeltaTimes[Frame]);
+	}
+
+	TestFalse(TEXT("Drone should have moved after the acknowledged frame"), Replayed.Location == Acked.Location);
+	TestTrue(TEXT("Replay from a saved state should match exactly"), Replayed.Location == Live.Location && Replayed.Velocity == Live.Velocity && Replayed.Rotation == Live.Rotation);
+	TestTrue(TEXT("Speed should respect the speed caps"), Live.Velocity.Size() <= Config.GetMaxSpeed(EDroneSpeedMode::High) + KINDA_SMALL_NUMBER);
+
+	// A long frame is exactly its substeps run one by one
+	const FDroneFlightState Start = Live;
+	FDroneFlightState Long = Start;
+	const float LongDelta = 0.1f;
+	const int32 NumSteps = FDroneFlightModel::Simulate(Long, Inputs[0], Config, LongDelta);
+	TestEqual(TEXT("Long frames should be substepped"), NumSteps, 6);
+
+	FDroneFlightState Stepped = Start;
+	for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+	{
+		TestEqual(TEXT("A substep should not be split again"), FDroneFlightModel::Simulate(Stepped, Inputs[0], Config, LongDelta / NumSteps), 1);
+	}
+
+	TestTrue(TEXT("Substepped frame should match its substeps exactly"), Long.Location == Stepped.Location && Long.Velocity == Stepped.Velocity && Long.Rotation == Stepped.Rotation);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneFixedStepAccumulatorTest, "DroneSystemPro.Movement.FixedStepAccumulator", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneFixedStepAccumulatorTest::RunTest(const FString& Parameters)
+{
+	FDroneFixedStepAccumulator Accumulator;
+	Accumulator.StepTime = 0.01f;
+	Accumulator.MaxStepsPerFrame = 4;
+
+	// Uneven frames step the same total as the time that passed
+	int32 TotalSteps = 0;
+	const float Frames[] = { 0.004f, 0.013f, 0.0165f, 0.007f, 0.021f, 0.0095f };
+	float TotalTime = 0.0f;
+	for (int32 Repeat = 0; Repeat < 50; ++Repeat)
+	{
+		for (const float FrameTime : Frames)
+		{
+			TotalSteps += Accumulator.Advance(FrameTime);
+			TotalTime += FrameTime;
+		}
+	}
+
+	TestTrue(TEXT("Steps should cover the elapsed time"), FMath::Abs(TotalSteps - FMath::RoundToInt(TotalTime / Accumulator.StepTime)) <= 1);
+	TestTrue(TEXT("Alpha should stay within a step"), Accumulator.GetAlpha() >= 0.0f && Accumulator.GetAlpha() <= 1.0f);
+
+	// A one second hitch runs the cap and drops the rest
+	Accumulator.Reset();
+	TestEqual(TEXT("Hitch should be capped"), Accumulator.Advance(1.0f), 4);
+	TestTrue(TEXT("Dropped steps should be counted"), Accumulator.GetNumDroppedSteps() >= 95);
+	TestTrue(TEXT("Backlog should not carry over"), Accumulator.Advance(0.0f) == 0);
+
+	return true;
+}
+
+// Batched Flight Kernel Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneFlightBatchBenchmarkTest, "DroneSystemPro.Performance.FlightBatchKernel", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FDroneFlightBatchBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const FDroneFlightConfig Config;
+	const float DeltaTime = 1.0f / 30.0f;
+	const int32 NumFrames = 60;
+
+	for (const int32 NumDrones : { 1000, 10000 })
+	{
+		// Deterministic spread of headings and inputs, including idle drones
+		FRandomStream Random(NumDrones);
+		TArray<FDroneFlightState> States;
+		TArray<FDroneFlightInput> Inputs;
+		FDroneFlightBatch VectorBatch;
+		VectorBatch.SetNum(NumDrones);
+
+		for (int32 Index = 0; Index < NumDrones; ++Index)
+		{
+			const FDroneFlightState State(Random.GetPointInBoxWithExtent(FVector::ZeroVector, FVector(50000.0f)), FRotator(Random.FRandRange(-30.0f, 30.0f), Random.FRandRange(-180.0f, 180.0f), 0.0f), Random.VRand() * 300.0f);
+			const FVector Move = (Index % 5 == 0) ? FVector::ZeroVector : Random.VRand();
+			const FDroneFlightInput Input(Move, FVector2D(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f)), (Index % 2) ? EDroneSpeedMode::High : EDroneSpeedMode::Low);
+
+			States.Add(State);
+			Inputs.Add(Input);
+			VectorBatch.SetDrone(Index, State, Input, Config);
+		}
+
+		FDroneFlightBatch ScalarBatch = VectorBatch;
+
+		// Baseline: one FDroneFlightModel call per drone
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int32 Index = 0; Index < NumDrones; ++Index)
+			{
+				FDroneFlightModel::Simulate(States[Index], Inputs[Index], Config, DeltaTime);
+			}
+		}
+		const double PerDroneSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			FDroneFlightBatchKernel::Simulate(ScalarBatch, 0, ScalarBatch.NumPadded(), DeltaTime, Config.MaxSubstepDeltaTime, Config.MaxSubsteps, false);
+		}
+		const double ScalarSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			FDroneFlightBatchKernel::Simulate(VectorBatch, 0, VectorBatch.NumPadded(), DeltaTime, Config.MaxSubstepDeltaTime, Config.MaxSubsteps, true);
+		}
+		const double VectorSeconds = FPlatformTime::Seconds() - StartTime;
+
+		const double DroneSteps = static_cast<double>(NumDrones) * NumFrames;
+		AddInfo(FString::Printf(TEXT("%d drones: per-drone %.2f M/s, batch scalar %.2f M/s, batch vector %.2f M/s (%.2fx over per-drone)"),
+			NumDrones,
+			DroneSteps / FMath::Max(PerDroneSeconds, 1e-9) / 1e6,
+			DroneSteps / FMath::Max(ScalarSeconds, 1e-9) / 1e6,
+			DroneSteps / FMath::Max(VectorSeconds, 1e-9) / 1e6,
+			PerDroneSeconds / FMath::Max(VectorSeconds, 1e-9)));
+
+		// Vector path must track the scalar reference, and both the flight model
+		float MaxVectorError = 0.0f;
+		float MaxModelError = 0.0f;
+		for (int32 Index = 0; Index < NumDrones; ++Index)
+		{
+			const FDroneFlightState Vector = VectorBatch.GetState(Index);
+			const FDroneFlightState Scalar = ScalarBatch.GetState(Index);
+			MaxVectorError = FMath::Max(MaxVectorError, static_cast<float>(FVector::Dist(Vector.Location, Scalar.Location)));
+			MaxModelError = FMath::Max(MaxModelError, static_cast<float>(FVector::Dist(Scalar.Location, States[Index].Location)));
+		}
+
+		TestTrue(FString::Printf(TEXT("%d drones: vector path should match scalar reference (%.3f)"), NumDrones, MaxVectorError), MaxVectorError < 1.0f);
+		TestTrue(FString::Printf(TEXT("%d drones: scalar reference should match flight model (%.3f)"), NumDrones, MaxModelError), MaxModelError < 1.0f);
+	}
+
+	return true;
+}
+
+// Wind Field Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneWindGridTest, "DroneSystemPro.Environment.WindGrid", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneWindGridTest::RunTest(const FString& Parameters)
+{
+	FDroneWindGrid Grid(100.0f);
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		// Wind grows along +X only
+		const FIntVector Node(Corner & 1, (Corner >> 1) & 1, (Corner >> 2) & 1);
+		Grid.AddWind(Node, FVector(Node.X ? 300.0f : 100.0f, 0.0f, 0.0f));
+	}
+
+	FDroneWindSampleCache Cache;
+	TestTrue(TEXT("Wind at a node should match the node"), Grid.Sample(FVector(0.0f, 0.0f, 0.0f), Cache).Equals(FVector(100.0f, 0.0f, 0.0f), 0.01f));
+	TestTrue(TEXT("Wind should interpolate linearly inside a cell"), Grid.Sample(FVector(25.0f, 50.0f, 50.0f), Cache).Equals(FVector(150.0f, 0.0f, 0.0f), 0.01f));
+	TestEqual(TEXT("Cache should hold the sampled cell"), Cache.Cell, FIntVector(0, 0, 0));
+
+	TestTrue(TEXT("Unbaked cells should be calm"), Grid.Sample(FVector(-5000.0f, 0.0f, 0.0f), Cache).IsZero());
+
+	Grid.AddWind(FIntVector(-50, 0, 0), FVector(0.0f, 0.0f, 10.0f));
+	TestTrue(TEXT("Grid changes should invalidate caches"), !Grid.Sample(FVector(-5000.0f, 0.0f, 0.0f), Cache).IsZero());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneDistanceFieldTest, "DroneSystemPro.Environment.DistanceField", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneDistanceFieldTest::RunTest(const FString& Parameters)
+{
+	// 10 unit voxels, a floor slab filling the lowest 8 layers: surface at Z = 80
+	const FIntVector Resolution(16, 16, 32);
+	TBitArray<> Solid(false, Resolution.X * Resolution.Y * Resolution.Z);
+	for (int32 Index = 0; Index < Solid.Num(); ++Index)
+	{
+		Solid[Index] = Index / (Resolution.X * Resolution.Y) < 8;
+	}
+
+	FDroneDistanceField Field;
+	Field.Build(FVector(5.0f), Resolution, 10.0f, 60.0f, Solid);
+
+	FVector Gradient;
+	TestEqual(TEXT("Distance above the floor"), Field.Sample(FVector(80.0f, 80.0f, 130.0f), &Gradient), 50.0f, 1.0f);
+	TestTrue(TEXT("Gradient should point away from the floor"), Gradient.GetSafeNormal().Equals(FVector::UpVector, 0.01f));
+	TestEqual(TEXT("Distance inside the floor is negative"), Field.Sample(FVector(80.0f, 80.0f, 40.0f)), -40.0f, 1.0f);
+	TestEqual(TEXT("Distance is clamped far from geometry"), Field.Sample(FVector(80.0f, 80.0f, 300.0f)), 60.0f, 1.0f);
+	TestEqual(TEXT("Outside the bounds is open air"), Field.Sample(FVector(-1000.0f, 0.0f, 0.0f)), 60.0f);
+
+	// Only the bricks around the surface carry voxels
+	AddInfo(FString::Printf(TEXT("%d of %d bricks stored, %llu bytes"), Field.GetNumStoredBricks(), Field.GetNumBricks(), static_cast<uint64>(Field.GetAllocatedSize())));
+	TestEqual(TEXT("Far bricks should not be stored"), Field.GetNumStoredBricks(), 8);
+
+	// Avoidance brakes an approach and leaves sliding along the surface alone
+	FDroneFlightConfig Config;
+	FDroneFlightInput Input;
+	Input.ObstacleNormal = FVector::UpVector;
+	Input.ObstacleDistance = 150.0f;
+	TestTrue(TEXT("Approach should be braked"), FDroneFlightModel::CalculateAvoidance(FVector(0.0f, 0.0f, -600.0f), Input, Config).Z > 0.0f);
+	TestTrue(TEXT("Avoidance should only act along the normal"), FMath::IsNearlyZero(FDroneFlightModel::CalculateAvoidance(FVector(600.0f, 0.0f, -600.0f), Input, Config).X));
+
+	Input.ObstacleDistance = Config.AvoidanceDistance + 1.0f;
+	TestTrue(TEXT("Distant obstacles should be ignored"), FDroneFlightModel::CalculateAvoidance(FVector(0.0f, 0.0f, -600.0f), Input, Config).IsZero());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneHeightfieldCacheTest, "DroneSystemPro.Environment.HeightfieldCache", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneHeightfieldCacheTest::RunTest(const FString& Parameters)
+{
+	// A ramp rising along X, with a pit of no ground around the origin
+	int32 NumSamples = 0;
+	auto Sampler = [&NumSamples](const FVector2D& Location)
+	{
+		++NumSamples;
+		return (FMath::Abs(Location.X) < 1.0 && FMath::Abs(Location.Y) < 1.0) ? FDroneHeightfieldCache::NoGround : static_cast<float>(Location.X * 0.5);
+	};
+
+	FDroneHeightfieldCache Cache(100.0f, 8, 4);
+
+	float Height = 0.0f;
+	TestTrue(TEXT("Ground should be found"), Cache.GetHeight(FVector2D(250.0f, 310.0f), Sampler, Height));
+	TestEqual(TEXT("Planar ground interpolates exactly"), Height, 125.0f, 0.01f);
+	TestEqual(TEXT("One tile should be built"), Cache.GetNumTiles(), 1);
+	TestEqual(TEXT("A tile costs one sample per grid point"), NumSamples, 64);
+
+	Cache.GetHeight(FVector2D(420.0f, 130.0f), Sampler, Height);
+	TestEqual(TEXT("Lookups inside a built tile should not sample again"), NumSamples, 64);
+
+	// Samples at -100..0 straddle four tiles around the origin
+	TestTrue(TEXT("Holes fall back to the highest neighbour"), Cache.GetHeight(FVector2D(-50.0f, -50.0f), Sampler, Height));
+	TestEqual(TEXT("Highest neighbour of the pit"), Height, 0.0f, 0.01f);
+	TestEqual(TEXT("Tiles are capped"), Cache.GetNumTiles(), 4);
+
+	Cache.GetHeight(FVector2D(5000.0f, 5000.0f), Sampler, Height);
+	TestEqual(TEXT("Least recently used tile should be evicted"), Cache.GetNumTiles(), 4);
+	TestEqual(TEXT("Negative coordinates use floor tiles"), Cache.GetTileCoord(FVector2D(-1.0f, 0.0f)), FIntPoint(-1, 0));
+
+	return true;
+}
+
+// Move History Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneMoveHistoryTest, "DroneSystemPro.Movement.MoveHistory", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneMoveHistoryTest::RunTest(const FString& Parameters)
+{
+	TDroneSequenceBuffer<int32, 8> Buffer;
+
+	// Start near the wrap point to cover sequence rollover
+	const uint32 FirstID = MAX_uint32 - 3;
+	for (uint32 Offset = 0; Offset < 12; ++Offset)
+	{
+		Buffer.Add(FirstID + Offset, static_cast<int32>(Offset));
+	}
+
+	TestEqual(TEXT("Buffer should be capped at capacity"), Buffer.Num(), 8u);
+	TestNull(TEXT("Evicted entries should not be found"), Buffer.Find(FirstID));
+	TestTrue(TEXT("Entries past the wrap should be found"), Buffer.Find(FirstID + 10) && *Buffer.Find(FirstID + 10) == 10);
+
+	Buffer.Acknowledge(FirstID + 9);
+	TestEqual(TEXT("Acknowledge should trim through the acked ID"), Buffer.Num(), 2u);
+	TestNull(TEXT("Acked entries should be gone"), Buffer.Find(FirstID + 9));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneSequenceBufferJumpTest, "DroneSystemPro.Movement.SequenceBufferJump", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneSequenceBufferJumpTest::RunTest(const FString& Parameters)
+{
+	TDroneSequenceBuffer<int32, 8> Buffer;
+	Buffer.Add(10, 10);
+	Buffer.Add(11, 11);
+
+	// A forged ID half the sequence space ahead must not walk every number in between
+	const uint32 FarID = 11u + (1u << 31) - 1u;
+	const double StartTime = FPlatformTime::Seconds();
+	TestNotNull(TEXT("Far ID should be stored"), Buffer.Add(FarID, 1));
+	TestTrue(TEXT("Jump should be constant time"), FPlatformTime::Seconds() - StartTime < 0.1);
+
+	TestEqual(TEXT("Window should end at the far ID"), Buffer.GetNextID(), FarID + 1);
+	TestEqual(TEXT("Window should span the capacity"), Buffer.Num(), 8u);
+	TestNull(TEXT("Entries before the jump should be cleared"), Buffer.Find(11));
+	TestTrue(TEXT("Far entry should be found"), Buffer.Find(FarID) && *Buffer.Find(FarID) == 1);
+
+	// Slots reused after the jump hold nothing stale
+	for (uint32 ID = FarID - 7; ID != FarID; ++ID)
+	{
+		TestFalse(TEXT("Skipped IDs should be empty"), Buffer.Contains(ID));
+	}
+
+	// A gap of exactly the capacity takes the same path
+	Buffer.Add(FarID + 9, 2);
+	TestEqual(TEXT("Capacity sized jump should keep a full window"), Buffer.Num(), 8u);
+	TestNull(TEXT("Previous entry should be evicted"), Buffer.Find(FarID));
+	TestTrue(TEXT("New entry should be found"), Buffer.Find(FarID + 9) && *Buffer.Find(FarID + 9) == 2);
+
+	return true;
+}
+
+// Lag Compensation Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneTransformHistoryTest, "DroneSystemPro.Networking.TransformHistory", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneTransformHistoryTest::RunTest(const FString& Parameters)
+{
+	FDroneTransformHistory History(4);
+
+	FVector Location;
+	FQuat Rotation;
+	TestFalse(TEXT("Empty history should not sample"), History.Sample(0.0f, Location, Rotation));
+
+	// Moves 100 units along X every 0.1s; six samples overflow the four slots
+	for (int32 Step = 0; Step < 6; ++Step)
+	{
+		History.Record(Step * 0.1f, FVector(Step * 100.0f, 0.0f, 0.0f), FQuat::Identity);
+	}
+
+	TestEqual(TEXT("History should be capped at capacity"), History.Num(), 4);
+	TestEqual(TEXT("Oldest samples should be overwritten"), History.GetOldestTime(), 0.2f, KINDA_SMALL_NUMBER);
+
+	History.Sample(0.35f, Location, Rotation);
+	TestTrue(TEXT("Samples should interpolate between neighbours"), Location.Equals(FVector(350.0f, 0.0f, 0.0f), 0.1f));
+
+	History.Sample(0.0f, Location, Rotation);
+	TestTrue(TEXT("Times before the window should clamp to the oldest sample"), Location.Equals(FVector(200.0f, 0.0f, 0.0f), 0.1f));
+
+	History.Record(0.45f, FVector::ZeroVector, FQuat::Identity);
+	History.Sample(1.0f, Location, Rotation);
+	TestTrue(TEXT("Out of order samples should be ignored"), Location.Equals(FVector(500.0f, 0.0f, 0.0f), 0.1f));
+
+	return true;
+}
+
+// Snapshot Serialization Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneSnapshotSizeTest, "DroneSystemPro.Networking.SnapshotSize", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneSnapshotSizeTest::RunTest(const FString& Parameters)
+{
+	// Full precision: 3 FVectors, FRotator, float, uint32 (doubles in LWC builds)
+	const int32 UnquantizedBits = (3 * 3 * sizeof(FVector::FReal) + sizeof(float) + sizeof(uint32)) * 8;
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		FDroneMovementSnapshot Snapshot;
+	};
+
+	const FCase Cases[] = {
+		{ TEXT("Hovering"), FDroneMovementSnapshot(FVector(12000.0f, -3400.0f, 850.0f), FRotator(0.0f, 90.0f, 0.0f), FVector::ZeroVector, 12.5f, 70000) },
+		{ TEXT("Cruising"), FDroneMovementSnapshot(FVector(12000.0f, -3400.0f, 850.0f), FRotator(0.0f, 90.0f, 0.0f), FVector(1200.0f, 0.0f, 0.0f), 12.5f, 70000) },
+		{ TEXT("Banking climb"), FDroneMovementSnapshot(FVector(-250000.0f, 80000.0f, 4000.0f), FRotator(20.0f, -135.0f, 30.0f), FVector(-600.0f, 500.0f, 300.0f), 12.5f, 70000) },
+	};
+
+	for (const FCase& Case : Cases)
+	{
+		const int32 Bits = Case.Snapshot.GetSerializedBits();
+		AddInfo(FString::Printf(TEXT("%s snapshot: %d bits (%d unquantized)"), Case.Name, Bits, UnquantizedBits));
+		TestTrue(FString::Printf(TEXT("%s snapshot should fit in 32 bytes"), Case.Name), Bits <= 256);
+
+		// Round trip through the net serializer
+		FNetBitWriter Writer(nullptr, 512);
+		FDroneMovementSnapshot Source = Case.Snapshot;
+		bool bSuccess = false;
+		Source.NetSerialize(Writer, nullptr, bSuccess);
+
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		FDroneMovementSnapshot Result;
+		Result.NetSerialize(Reader, nullptr, bSuccess);
+
+		TestTrue(FString::Printf(TEXT("%s location within quantization"), Case.Name), Result.Location.Equals(Case.Snapshot.Location, 0.1f));
+		TestTrue(FString::Printf(TEXT("%s velocity within quantization"), Case.Name), Result.Velocity.Equals(Case.Snapshot.Velocity, 0.1f));
+		TestTrue(FString::Printf(TEXT("%s rotation within quantization"), Case.Name), Result.Rotation.Equals(Case.Snapshot.Rotation, 0.01f));
+		TestEqual(FString::Printf(TEXT("%s input ID expands"), Case.Name), FDroneMovementSnapshot::ExpandInputID(Result.InputID, 70010), Case.Snapshot.InputID);
+		TestEqual(FString::Printf(TEXT("%s timestamp expands"), Case.Name), FDroneMovementSnapshot::ExpandTimestamp(Result.Timestamp, 12.6f), Case.Snapshot.Timestamp, 0.001f);
+	}
+
+	return true;
+}
+
+// Snapshot Interpolation Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneSnapshotInterpolatorTest, "DroneSystemPro.Networking.SnapshotInterpolation", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneSnapshotInterpolatorTest::RunTest(const FString& Parameters)
+{
+	// Snapshots every 0.1s arriving alternately 40ms late: jitter settles near 40ms
+	{
+		FDroneSnapshotInterpolator Interpolator;
+		float ReceiveTime = 0.0f;
+		for (int32 Index = 0; Index < 64; ++Index)
+		{
+			const float Timestamp = Index * 0.1f;
+			ReceiveTime = Timestamp + 0.5f + ((Index % 2) ? 0.04f : 0.0f);
+			Interpolator.AddSnapshot(FDroneMovementSnapshot(FVector::ZeroVector, FRotator::ZeroRotator, FVector::ZeroVector, Timestamp, Index), ReceiveTime);
+		}
+
+		const float Jitter = Interpolator.GetStats().Jitter;
+		TestEqual(TEXT("Jitter should follow the arrival variation"), Jitter, 0.04f, 0.002f);
+
+		FDroneFlightState State;
+		Interpolator.Sample(ReceiveTime, 0.1f, State);
+		TestEqual(TEXT("Delay should change at the adjust rate"), Interpolator.GetStats().InterpolationDelay, 0.06f, KINDA_SMALL_NUMBER);
+
+		for (int32 Step = 0; Step < 20; ++Step)
+		{
+			Interpolator.Sample(ReceiveTime, 0.1f, State);
+		}
+
+		const float TargetDelay = 0.1f + Interpolator.Settings.JitterMultiplier * Jitter;
+		TestEqual(TEXT("Delay should settle at interval plus jitter headroom"), Interpolator.GetStats().InterpolationDelay, TargetDelay, 0.001f);
+	}
+
+	// Fixed delay and 1s transit, so render time is server time minus 1.125s;
+	// binary fractions keep the interval endpoints exact
+	FDroneSnapshotInterpolator Interpolator;
+	Interpolator.Settings.MinDelay = 0.125f;
+	Interpolator.Settings.MaxDelay = 0.125f;
+	Interpolator.Reset();
+
+	FDroneFlightState State;
+	TestFalse(TEXT("Empty buffer should not sample"), Interpolator.Sample(0.0f, 0.0f, State));
+
+	Interpolator.AddSnapshot(FDroneMovementSnapshot(FVector::ZeroVector, FRotator::ZeroRotator, FVector(1600.0f, 0.0f, 0.0f), 0.0f, 1), 1.0f);
+	Interpolator.AddSnapshot(FDroneMovementSnapshot(FVector(100.0f, 0.0f, 0.0f), FRotator(0.0f, 90.0f, 0.0f), FVector::ZeroVector, 0.125f, 2), 1.125f);
+
+	Interpolator.Sample(1.125f, 0.0f, State);
+	TestTrue(TEXT("Start of the interval should be the older snapshot"), State.Location.Equals(FVector::ZeroVector, 0.1f));
+
+	// Hermite with the 200 unit start tangent lands ahead of the linear midpoint
+	Interpolator.Sample(1.1875f, 0.0f, State);
+	TestTrue(TEXT("Midpoint should follow the velocity tangents"), State.Location.Equals(FVector(75.0f, 0.0f, 0.0f), 0.1f));
+	TestTrue(TEXT("Midpoint velocity should blend"), State.Velocity.Equals(FVector(800.0f, 0.0f, 0.0f), 0.5f));
+	TestEqual(TEXT("Midpoint rotation should blend"), State.Rotation.Yaw, 45.0, 0.1);
+	TestEqual(TEXT("Render time should be the sampled server time"), Interpolator.GetStats().RenderTime, 0.0625f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Transit should be the snapshot age on arrival"), Interpolator.GetStats().TransitTime, 1.0f, KINDA_SMALL_NUMBER);
+
+	Interpolator.Sample(1.25f, 0.0f, State);
+	TestTrue(TEXT("End of the interval should be the newer snapshot"), State.Location.Equals(FVector(100.0f, 0.0f, 0.0f), 0.1f));
+
+	// Duplicates are dropped silently, reordered snapshots count as late
+	Interpolator.AddSnapshot(FDroneMovementSnapshot(FVector(200.0f, 0.0f, 0.0f), FRotator::ZeroRotator, FVector(1000.0f, 0.0f, 0.0f), 0.25f, 3), 1.25f);
+	Interpolator.AddSnapshot(FDroneMovementSnapshot(FVector(900.0f, 0.0f, 0.0f), FRotator::ZeroRotator, FVector::ZeroVector, 0.25f, 3), 1.26f);
+	TestEqual(TEXT("Duplicate snapshot should not count as late"), Interpolator.GetStats().LateSnapshots, 0);
+	Interpolator.AddSnapshot(FDroneMovementSnapshot(FVector(900.0f, 0.0f, 0.0f), FRotator::ZeroRotator, FVector::ZeroVector, 0.1875f, 4), 1.3f);
+	TestEqual(TEXT("Reordered snapshot should count as late"), Interpolator.GetStats().LateSnapshots, 1);
+
+	// Past the newest snapshot: extrapolate along its velocity, then hold at the cap
+	Interpolator.Sample(1.5f, 0.0f, State);
+	TestTrue(TEXT("Short gaps should extrapolate"), State.Location.Equals(FVector(325.0f, 0.0f, 0.0f), 0.1f));
+	TestEqual(TEXT("Extrapolated sample should be counted"), Interpolator.GetStats().ExtrapolatedSamples, 1);
+	TestEqual(TEXT("Only the newest snapshot should remain"), Interpolator.GetStats().BufferedSnapshots, 1);
+
+	Interpolator.Sample(1.75f, 0.0f, State);
+	const float MaxOffset = 1000.0f * Interpolator.Settings.MaxExtrapolationTime;
+	TestTrue(TEXT("Extrapolation should stop at the time cap"), State.Location.Equals(FVector(200.0f + MaxOffset, 0.0f, 0.0f), 0.1f));
+	TestEqual(TEXT("Starved sample should be counted"), Interpolator.GetStats().StarvedSamples, 1);
+
+	return true;
+}
+
+// Predicted Mode Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDronePredictedModesTest, "DroneSystemPro.Networking.PredictedModes", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDronePredictedModesTest::RunTest(const FString& Parameters)
+{
+	// Toggles predicted mid-packet must reach the server on the exact input they were made on
+	FDroneInputPacket Packet;
+	for (int32 Index = 0; Index < 6; ++Index)
+	{
+		FDroneInputState& Input = Packet.Inputs.AddDefaulted_GetRef();
+		Input.DeltaTime = 1.0f / 60.0f;
+		Input.InputID = 500 + Index;
+		Input.Timestamp = 20.0f + Index / 60.0f;
+		Input.SpeedMode = Index >= 2 ? EDroneSpeedMode::High : EDroneSpeedMode::Low;
+		Input.VisionMode = static_cast<EDroneVisionMode>(Index % 3);
+	}
+
+	FNetBitWriter Writer(nullptr, 1024);
+	bool bSuccess = false;
+	Packet.NetSerialize(Writer, nullptr, bSuccess);
+
+	FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+	FDroneInputPacket Result;
+	Result.NetSerialize(Reader, nullptr, bSuccess);
+
+	TestTrue(TEXT("Packet deserializes"), bSuccess);
+	if (!TestEqual(TEXT("Input count"), Result.Inputs.Num(), Packet.Inputs.Num()))
+		return false;
+
+	for (int32 Index = 0; Index < Packet.Inputs.Num(); ++Index)
+	{
+		TestEqual(FString::Printf(TEXT("Input %d speed mode"), Index), Result.Inputs[Index].SpeedMode, Packet.Inputs[Index].SpeedMode);
+		TestEqual(FString::Printf(TEXT("Input %d vision mode"), Index), Result.Inputs[Index].VisionMode, Packet.Inputs[Index].VisionMode);
+	}
+
+	// The authoritative modes ride on the snapshot the client reconciles against
+	FDroneMovementSnapshot Snapshot(FVector(100.0f, 200.0f, 300.0f), FRotator::ZeroRotator, FVector::ZeroVector, 20.0f, 505);
+	Snapshot.SpeedMode = EDroneSpeedMode::High;
+	Snapshot.VisionMode = EDroneVisionMode::Thermal;
+
+	FNetBitWriter SnapshotWriter(nullptr, 512);
+	Snapshot.NetSerialize(SnapshotWriter, nullptr, bSuccess);
+
+	FNetBitReader SnapshotReader(nullptr, SnapshotWriter.GetData(), SnapshotWriter.GetNumBits());
+	FDroneMovementSnapshot SnapshotResult;
+	SnapshotResult.NetSerialize(SnapshotReader, nullptr, bSuccess);
+
+	TestEqual(TEXT("Snapshot speed mode"), SnapshotResult.SpeedMode, Snapshot.SpeedMode);
+	TestEqual(TEXT("Snapshot vision mode"), SnapshotResult.VisionMode, Snapshot.VisionMode);
+
+	return true;
+}
+
+// Replay Harness Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneNetReplayTest, "DroneSystemPro.Networking.ReplayHarness", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneNetReplayTest::RunTest(const FString& Parameters)
+{
+	// Scripted 20s session: sweeping sticks, uneven frame times and a speed boost
+	FDroneInputRecording Recording;
+	FRandomStream Random(11);
+	float Time = 0.0f;
+	while (Time < 20.0f)
+	{
+		FDroneInputState Input;
+		Input.DeltaTime = 1.0f / 60.0f + Random.FRandRange(-0.004f, 0.004f);
+		Input.MovementInput = FVector(FMath::Sin(Time * 0.7f), FMath::Cos(Time * 0.4f), FMath::Sin(Time * 1.3f) * 0.3f).GetClampedToMaxSize(1.0f);
+		Input.LookInput = FVector2D(FMath::Sin(Time * 0.5f) * 0.5f, 0.0f);
+		Input.SpeedMode = (Time > 5.0f && Time < 10.0f) ? EDroneSpeedMode::High : EDroneSpeedMode::Low;
+
+		Recording.AddFrame(Input, FDroneNetConditions(Time < 10.0f ? 0.1f : 0.16f, 0.0f, 0.0f));
+		Time += Input.DeltaTime;
+	}
+
+	// The file form round trips exactly
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	TestTrue(TEXT("Recording writes"), Recording.Serialize(Writer));
+
+	FDroneInputRecording Loaded;
+	FMemoryReader Reader(Data);
+	TestTrue(TEXT("Recording reads"), Loaded.Serialize(Reader));
+	if (!TestEqual(TEXT("Frame count"), Loaded.Num(), Recording.Num()))
+		return false;
+
+	AddInfo(FString::Printf(TEXT("%d frames in %d bytes"), Recording.Num(), Data.Num()));
+	for (int32 Frame = 0; Frame < Recording.Num(); ++Frame)
+	{
+		const FDroneInputState& Expected = Recording.GetInput(Frame);
+		const FDroneInputState& Actual = Loaded.GetInput(Frame);
+		if (Actual.MovementInput != Expected.MovementInput || Actual.LookInput != Expected.LookInput || Actual.DeltaTime != Expected.DeltaTime || Actual.SpeedMode != Expected.SpeedMode)
+		{
+			AddError(FString::Printf(TEXT("Frame %d differs after loading"), Frame));
+			return false;
+		}
+	}
+	TestEqual(TEXT("Conditions survive loading"), Loaded.GetConditions(Loaded.Num() - 1).RoundTripTime, 0.16f, 0.001f);
+
+	// A clean link predicts perfectly
+	const FDroneReplayReport Clean = FDroneNetReplay::Run(Loaded);
+	AddInfo(FString::Printf(TEXT("Clean: %s"), *Clean.ToString()));
+	TestEqual(TEXT("Clean link needs no corrections"), Clean.NumCorrections, 0);
+	TestTrue(TEXT("Inputs were sent"), Clean.BytesSent > 0 && Clean.InputPacketsSent > 0);
+	TestTrue(TEXT("Snapshots were received"), Clean.BytesReceived > 0 && Clean.SnapshotsSent > 0);
+
+	// Bursts of loss longer than the input redundancy make the server skip moves
+	FDroneReplaySettings Lossy;
+	Lossy.Conditions = FDroneNetConditions(0.1f, 0.9f, 0.2f);
+	Lossy.bUseRecordedConditions = false;
+	Lossy.Jitter = 0.03f;
+	Lossy.Seed = 3;
+
+	const FDroneReplayReport LossyReport = FDroneNetReplay::Run(Loaded, Lossy);
+	AddInfo(FString::Printf(TEXT("Lossy: %s"), *LossyReport.ToString()));
+	TestTrue(TEXT("Heavy loss causes corrections"), LossyReport.NumCorrections > 0);
+
+	const FDroneReplayReport Repeat = FDroneNetReplay::Run(Loaded, Lossy);
+	TestEqual(TEXT("Replays are deterministic"), Repeat.NumCorrections, LossyReport.NumCorrections);
+
+	// Captured sessions (Drone.RecordInput 1) are replayed as they are
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(FDroneInputRecording::GetRecordingDir() / TEXT("*.") + FDroneInputRecording::GetFileExtension()), true, false);
+	for (const FString& File : Files)
+	{
+		FDroneInputRecording Captured;
+		if (!Captured.LoadFromFile(FDroneInputRecording::GetRecordingDir() / File))
+		{
+			AddWarning(FString::Printf(TEXT("Could not load %s"), *File));
+			continue;
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: %s"), *File, *FDroneNetReplay::Run(Captured).ToString()));
+	}
+
+	return true;
+}
+
+// Network Clock Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneNetClockTest, "DroneSystemPro.Networking.NetClock", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneNetClockTest::RunTest(const FString& Parameters)
+{
+	// Wire ticks wrap every 65.536s and widen against a nearby reference
+	TestEqual(TEXT("Ticks should widen across the wrap"), FDroneNetTime::Expand(FDroneNetTime::ToTicks(131.1f), 130.9f), 131.1f, 0.001f);
+	TestEqual(TEXT("Ticks should widen behind the reference"), FDroneNetTime::Expand(FDroneNetTime::ToTicks(499.95f), 500.2f), 499.95f, 0.001f);
+
+	// 100ms round trip, server 20s ahead, with occasional queueing spikes
+	FDroneClockEstimator Estimator;
+	for (int32 Sample = 0; Sample < 40; ++Sample)
+	{
+		const bool bSpike = (Sample % 10) == 9;
+		const float RoundTrip = bSpike ? 0.4f : 0.1f + (Sample % 3) * 0.005f;
+
+		// A spike on the return path skews the symmetric offset estimate
+		Estimator.AddSample(RoundTrip, bSpike ? 20.15f : 20.0f);
+	}
+
+	TestTrue(TEXT("Round trip should converge near the typical sample"), FMath::IsNearlyEqual(Estimator.GetRoundTripTime(), 0.1f, 0.05f));
+	TestEqual(TEXT("Offset should ignore queueing spikes"), Estimator.GetOffset(), 20.0f, 0.001f);
+
+	return true;
+}
+
+// Push Model Tests
+namespace DronePushModelTestPrivate
+{
+	/** Standalone game world for tests that need ticking actors with authority */
+	struct FTestWorld
+	{
+		UWorld* World;
+
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("DronePushModelTest"));
+
+			FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+			Context.SetCurrentWorld(World);
+
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+		}
+
+		~FTestWorld()
+		{
+			for (TActorIterator<AActor> It(World); It; ++It)
+			{
+				It->RouteEndPlay(EEndPlayReason::Quit);
+			}
+
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+	};
+
+	/** Replicated properties an object's own class declares, as text, to spot unmarked changes */
+	class FPropertyWatch
+	{
+	public:
+		FPropertyWatch(FAutomationTestBase& Test, UObject* InObject)
+			: Object(InObject)
+		{
+			UClass* Class = Object->GetClass();
+			Class->SetUpRuntimeReplicationData();
+
+			TArray<FLifetimeProperty> LifetimeProps;
+			Object->GetLifetimeReplicatedProps(LifetimeProps);
+
+			for (TFieldIterator<FProperty> It(Class, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+			{
+				FProperty* Property = *It;
+				if (!Property->HasAnyPropertyFlags(CPF_Net))
+					continue;
+
+				const FLifetimeProperty* Lifetime = LifetimeProps.FindByPredicate([Property](const FLifetimeProperty& Entry) { return Entry.RepIndex == Property->RepIndex; });
+				Test.TestTrue(FString::Printf(TEXT("%s::%s is push based"), *Class->GetName(), *Property->GetName()), Lifetime && Lifetime->bIsPushBased);
+
+				Properties.Add({ Property, Export(Property) });
+			}
+		}
+
+		/** Names of properties that changed since the last call without a dirty mark */
+		TArray<FString> CollectUnmarkedChanges()
+		{
+			TArray<FString> Unmarked;
+			for (FWatchedProperty& Watched : Properties)
+			{
+				FString Value = Export(Watched.Property);
+				if (Value == Watched.Value)
+					continue;
+
+				if (!FDronePushModelTracker::WasMarked(Object, Watched.Property->GetFName()))
+				{
+					Unmarked.Add(Object->GetClass()->GetName() + TEXT("::") + Watched.Property->GetName());
+				}
+				Watched.Value = MoveTemp(Value);
+			}
+			return Unmarked;
+		}
+
+	private:
+		struct FWatchedProperty
+		{
+			FProperty* Property;
+			FString Value;
+		};
+
+		FString Export(const FProperty* Property) const
+		{
+			FString Value;
+			Property->ExportTextItem_InContainer(Value, Object, nullptr, nullptr, PPF_None);
+			return Value;
+		}
+
+		UObject* Object;
+		TArray<FWatchedProperty> Properties;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDronePushModelTest, "DroneSystemPro.Networking.PushModel", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDronePushModelTest::RunTest(const FString& Parameters)
+{
+	using namespace DronePushModelTestPrivate;
+
+	if (!GEngine)
+	{
+		AddError(TEXT("Requires an engine"));
+		return false;
+	}
+
+	FTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ADroneBase* Drone = World->SpawnActor<ADroneBase>(FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator, SpawnParams);
+	ADroneBase* OtherDrone = World->SpawnActor<ADroneBase>(FVector(300.0f, 0.0f, 100.0f), FRotator::ZeroRotator, SpawnParams);
+	ATerminalActor* Terminal = World->SpawnActor<ATerminalActor>(FVector(0.0f, 200.0f, 0.0f), FRotator::ZeroRotator, SpawnParams);
+	AActor* Station = World->SpawnActor<AActor>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	if (!Drone || !OtherDrone || !Terminal || !Station)
+	{
+		AddError(TEXT("Failed to spawn test actors"));
+		return false;
+	}
+
+	Drone->SetDroneConfig(NewObject<UDroneConfig>(Drone));
+
+	UJammingComponent* Jamming = NewObject<UJammingComponent>(Station);
+	UHackingComponent* Hacking = NewObject<UHackingComponent>(Drone);
+	UDroneDockingComponent* Docking = NewObject<UDroneDockingComponent>(Station);
+	Jamming->RegisterComponent();
+	Hacking->RegisterComponent();
+	Docking->RegisterComponent();
+
+	TArray<FPropertyWatch> Watches;
+	for (UObject* Object : TArray<UObject*>{ Drone, Drone->GetDroneBattery(), Drone->GetDroneVision(), Drone->GetDroneMarking(), Drone->GetDroneUtility(), Jamming, Hacking, Docking, Terminal })
+	{
+		if (Object)
+		{
+			Watches.Emplace(*this, Object);
+		}
+	}
+
+	FDronePushModelTracker::SetEnabled(true);
+
+	auto CheckStep = [this, &Watches](const TCHAR* Step)
+	{
+		for (FPropertyWatch& Watch : Watches)
+		{
+			for (const FString& Property : Watch.CollectUnmarkedChanges())
+			{
+				AddError(FString::Printf(TEXT("%s changed %s without marking it dirty"), Step, *Property));
+			}
+		}
+		FDronePushModelTracker::Reset();
+	};
+
+	// Every server-side mutation path
+	Drone->GetDroneBattery()->SetBatteryLevel(50.0f);
+	CheckStep(TEXT("SetBatteryLevel"));
+
+	Drone->GetDroneBattery()->StartRecharging();
+	World->Tick(LEVELTICK_All, 0.1f);
+	CheckStep(TEXT("Recharging"));
+
+	Drone->GetDroneBattery()->StopRecharging();
+	World->Tick(LEVELTICK_All, 0.1f);
+	CheckStep(TEXT("Draining"));
+
+	Drone->GetDroneVision()->SetVisionMode(EDroneVisionMode::Thermal);
+	CheckStep(TEXT("SetVisionMode"));
+
+	Drone->GetDroneVision()->PerformThermalScan();
+	CheckStep(TEXT("PerformThermalScan"));
+
+	Drone->GetDroneMarking()->MarkTarget(OtherDrone);
+	CheckStep(TEXT("MarkTarget"));
+
+	World->Tick(LEVELTICK_All, 0.1f);
+	Drone->GetDroneMarking()->MarkTarget(OtherDrone);
+	CheckStep(TEXT("Refreshing a mark"));
+
+	Drone->GetDroneMarking()->UnmarkTarget(OtherDrone);
+	CheckStep(TEXT("UnmarkTarget"));
+
+	if (Drone->GetDroneUtility())
+	{
+		Drone->GetDroneUtility()->SetFlashlightEnabled(true);
+		CheckStep(TEXT("SetFlashlightEnabled"));
+	}
+
+	Jamming->SetJammingEnabled(true);
+	Jamming->SetJamStrength(1.5f);
+	Jamming->SetJamRadius(500.0f);
+	CheckStep(TEXT("Jamming setters"));
+
+	Hacking->StartHack(Terminal, 1.0f);
+	CheckStep(TEXT("StartHack"));
+
+	World->Tick(LEVELTICK_All, 0.1f);
+	CheckStep(TEXT("Hack progress"));
+
+	Hacking->CancelHack();
+	CheckStep(TEXT("CancelHack"));
+
+	Docking->DockDrone(Drone);
+	CheckStep(TEXT("DockDrone"));
+
+	Docking->UndockDrone();
+	CheckStep(TEXT("UndockDrone"));
+
+	Terminal->SetHacked(true);
+	CheckStep(TEXT("SetHacked"));
+
+	Terminal->ResetTerminal();
+	CheckStep(TEXT("ResetTerminal"));
+
+	// The watch itself must catch a write that skips the mark
+	FBoolProperty* HackedProperty = FindFProperty<FBoolProperty>(ATerminalActor::StaticClass(), TEXT("bIsHacked"));
+	if (TestNotNull(TEXT("bIsHacked property"), HackedProperty))
+	{
+		HackedProperty->SetPropertyValue_InContainer(Terminal, true);
+
+		int32 NumUnmarked = 0;
+		for (FPropertyWatch& Watch : Watches)
+		{
+			NumUnmarked += Watch.CollectUnmarkedChanges().Num();
+		}
+		TestEqual(TEXT("Unmarked write is detected"), NumUnmarked, 1);
+	}
+
+	FDronePushModelTracker::SetEnabled(false);
+	return true;
+}
+
+// Bandwidth Control Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneBandwidthControllerTest, "DroneSystemPro.Networking.BandwidthController", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneBandwidthControllerTest::RunTest(const FString& Parameters)
+{
+	const float DeltaTime = 0.25f;
+	const float FullRate = 4000.0f;
+	const float Limit = 1000.0f;
+
+	// A drone whose traffic follows its scale settles under the limit
+	FDroneBandwidthMeter Meter;
+	FDroneBandwidthController Controller;
+	float MaxSettledRate = 0.0f;
+	for (int32 Step = 0; Step < 200; ++Step)
+	{
+		Meter.AddBytes(FMath::RoundToInt(FullRate * Controller.GetScale() * DeltaTime));
+		Meter.Update(DeltaTime, 1.0f);
+		Controller.Update(Meter.GetBytesPerSecond(), Limit, DeltaTime, false);
+
+		if (Step >= 100)
+		{
+			MaxSettledRate = FMath::Max(MaxSettledRate, Meter.GetBytesPerSecond());
+		}
+	}
+
+	TestTrue(TEXT("Usage should settle under the limit"), MaxSettledRate <= Limit);
+	TestTrue(TEXT("Usage should not be throttled far below the limit"), MaxSettledRate >= Limit * 0.5f);
+	TestTrue(TEXT("Scale should be reduced"), Controller.GetScale() < 1.0f && Controller.GetScale() >= Controller.MinScale);
+	TestTrue(TEXT("Meter should keep the total"), Meter.GetTotalBytes() > 0);
+
+	// A saturated connection halves the scale regardless of the measured rate
+	const float SettledScale = Controller.GetScale();
+	Controller.Update(0.0f, Limit, DeltaTime, true);
+	TestEqual(TEXT("Saturation should halve the scale"), Controller.GetScale(), FMath::Max(SettledScale * 0.5f, Controller.MinScale));
+
+	// Without a limit the scale recovers fully
+	for (int32 Step = 0; Step < 40; ++Step)
+	{
+		Controller.Update(FullRate, 0.0f, DeltaTime, false);
+	}
+	TestEqual(TEXT("Scale should recover when unlimited"), Controller.GetScale(), 1.0f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneViewerPriorityTest, "DroneSystemPro.Networking.ViewerPriority", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneViewerPriorityTest::RunTest(const FString& Parameters)
+{
+	if (!GEngine)
+		return false;
+
+	DronePushModelTestPrivate::FTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	ADroneBase* Drone = World->SpawnActor<ADroneBase>(FVector::ZeroVector, FRotator::ZeroRotator);
+	ADroneBase* ViewDrone = World->SpawnActor<ADroneBase>(FVector(-5000.0f, 0.0f, 0.0f), FRotator::ZeroRotator);
+	AAIController* DroneController = World->SpawnActor<AAIController>();
+	AAIController* ViewController = World->SpawnActor<AAIController>();
+	if (!TestNotNull(TEXT("Drone"), Drone) || !TestNotNull(TEXT("View drone"), ViewDrone) || !DroneController || !ViewController)
+		return false;
+
+	DroneController->Possess(Drone);
+	ViewController->Possess(ViewDrone);
+
+	UDroneReplicationComponent* Replication = Drone->FindComponentByClass<UDroneReplicationComponent>();
+	if (!TestNotNull(TEXT("Replication component"), Replication))
+		return false;
+
+	const float MaxDistance = Replication->GetMaxRelevancyDistance();
+	const FVector Near(-5000.0f, 0.0f, 0.0f);
+	const FVector Far(-MaxDistance * 0.9f, 0.0f, 0.0f);
+	const float Time = 0.1f;
+
+	// Looking at the drone beats looking away, and near beats far
+	const float Facing = Drone->GetNetPriority(Near, FVector::ForwardVector, ViewController, ViewDrone, nullptr, Time, false);
+	const float Behind = Drone->GetNetPriority(Near, -FVector::ForwardVector, ViewController, ViewDrone, nullptr, Time, false);
+	const float Aside = Drone->GetNetPriority(Near, FVector::RightVector, ViewController, ViewDrone, nullptr, Time, false);
+	const float FarFacing = Drone->GetNetPriority(Far, FVector::ForwardVector, ViewController, ViewDrone, nullptr, Time, false);
+	TestTrue(TEXT("Drone in view should outrank one outside the cone"), Facing > Aside);
+	TestTrue(TEXT("Drone outside the cone should outrank one behind"), Aside > Behind);
+	TestTrue(TEXT("Near drone should outrank a far one"), Facing > FarFacing);
+	TestTrue(TEXT("Drone behind should still get some priority"), Behind > 0.0f);
+
+	// Relevancy ends at the cull distance unless the viewer is a teammate
+	const FVector Beyond(-MaxDistance * 1.2f, 0.0f, 0.0f);
+	TestTrue(TEXT("Near drone should be relevant"), Drone->IsNetRelevantFor(ViewController, ViewDrone, Near));
+	TestFalse(TEXT("Drone beyond the cull distance should not be relevant"), Drone->IsNetRelevantFor(ViewController, ViewDrone, Beyond));
+	TestTrue(TEXT("Own drone should be relevant at any distance"), Drone->IsNetRelevantFor(DroneController, Drone, Beyond * 10.0f));
+
+	DroneController->SetGenericTeamId(FGenericTeamId(1));
+	ViewController->SetGenericTeamId(FGenericTeamId(1));
+	TestTrue(TEXT("Viewer should be a teammate"), Replication->IsTeammate(ViewController));
+	TestTrue(TEXT("Teammates should see the drone further"), Drone->IsNetRelevantFor(ViewController, ViewDrone, Beyond));
+	TestTrue(TEXT("Teammates should get more priority"), Drone->GetNetPriority(Near, FVector::ForwardVector, ViewController, ViewDrone, nullptr, Time, false) > Facing);
+
+	ViewController->SetGenericTeamId(FGenericTeamId(2));
+	TestFalse(TEXT("Other teams should not be teammates"), Replication->IsTeammate(ViewController));
+	TestFalse(TEXT("Other teams should not see past the cull distance"), Drone->IsNetRelevantFor(ViewController, ViewDrone, Beyond));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneDormancyTest, "DroneSystemPro.Networking.Dormancy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneDormancyTest::RunTest(const FString& Parameters)
+{
+	if (!GEngine)
+		return false;
+
+	DronePushModelTestPrivate::FTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	ADroneBase* Drone = World->SpawnActor<ADroneBase>(FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator);
+	AActor* Station = World->SpawnActor<AActor>(FVector::ZeroVector, FRotator::ZeroRotator);
+	if (!TestNotNull(TEXT("Drone"), Drone) || !TestNotNull(TEXT("Station"), Station))
+		return false;
+
+	Drone->SetDroneConfig(NewObject<UDroneConfig>(Drone));
+
+	UDroneDockingComponent* Docking = NewObject<UDroneDockingComponent>(Station);
+	Docking->RegisterComponent();
+
+	UDroneReplicationComponent* Replication = Drone->FindComponentByClass<UDroneReplicationComponent>();
+	if (!TestNotNull(TEXT("Replication component"), Replication))
+		return false;
+
+	auto TickFor = [World](float Seconds)
+	{
+		for (float Time = 0.0f; Time < Seconds; Time += 0.1f)
+		{
+			World->Tick(LEVELTICK_All, 0.1f);
+		}
+	};
+
+	// Docked drones sleep after the parked delay
+	TestTrue(TEXT("Drone should dock"), Docking->DockDrone(Drone));
+	World->Tick(LEVELTICK_All, 0.1f);
+	TestFalse(TEXT("Drone should stay awake right after docking"), Replication->IsNetDormant());
+
+	TickFor(1.5f);
+	TestTrue(TEXT("Docked drone should be dormant"), Replication->IsNetDormant());
+	TestTrue(TEXT("Docked drone should be dormant on the net driver"), Drone->NetDormancy == DORM_DormantAll);
+	TestEqual(TEXT("Dormant drones should be counted"), UDroneReplicationComponent::GetNumDormantDrones(World), 1);
+
+	// Any replicated change wakes it until it has been quiet again
+	if (Drone->GetDroneUtility())
+	{
+		Drone->GetDroneUtility()->SetFlashlightEnabled(true);
+		TestFalse(TEXT("Replicated change should wake the drone"), Replication->IsNetDormant());
+		TestTrue(TEXT("Woken drone should be awake on the net driver"), Drone->NetDormancy == DORM_Awake);
+
+		TickFor(1.5f);
+		TestTrue(TEXT("Quiet docked drone should sleep again"), Replication->IsNetDormant());
+	}
+
+	// Undocked but hovering still, it sleeps after the longer idle delay
+	Docking->UndockDrone();
+	World->Tick(LEVELTICK_All, 0.1f);
+	TestFalse(TEXT("Undocked drone should wake"), Replication->IsNetDormant());
+
+	TickFor(1.5f);
+	TestFalse(TEXT("Idle drone should not sleep before the idle delay"), Replication->IsNetDormant());
+
+	TickFor(5.0f);
+	TestTrue(TEXT("Idle drone should be dormant"), Replication->IsNetDormant());
+
+	// Moving wakes it
+	Drone->GetDroneMovement()->SetMovementInput(FVector::ForwardVector);
+	World->Tick(LEVELTICK_All, 0.1f);
+	TestFalse(TEXT("Moving drone should wake"), Replication->IsNetDormant());
+	TestEqual(TEXT("No drones should be counted as dormant"), UDroneReplicationComponent::GetNumDormantDrones(World), 0);
+
+	return true;
+}
+
+// Server Input Tests
+struct FDroneMovementTestAccess
+{
+	static void ReceiveInputs(UDroneMovementComponent* Movement, const FDroneInputPacket& Packet) { Movement->Server_SendInputs_Implementation(Packet); }
+	static bool ConsumeInput(UDroneMovementComponent* Movement, FDroneInputState& OutInput) { return Movement->ConsumeNextServerInput(OutInput); }
+	static void ServerTick(UDroneMovementComponent* Movement, float DeltaTime) { Movement->ServerTick(DeltaTime); }
+	static const FDroneMovementSnapshot& GetServerSnapshot(const UDroneMovementComponent* Movement) { return Movement->ServerSnapshot; }
+	static FDroneFlightState& GetFlightState(UDroneMovementComponent* Movement) { return Movement->FlightState; }
+	static void ApplyMovement(UDroneMovementComponent* Movement) { Movement->ApplyMovement(); }
+	static bool HasContact(const UDroneMovementComponent* Movement) { return Movement->bHasContact; }
+	static float GetContactTime(const UDroneMovementComponent* Movement) { return Movement->ContactTime; }
+	static float GetContactRetestInterval(const UDroneMovementComponent* Movement) { return Movement->ContactRetestInterval; }
+	static void UpdateSignificance(UDroneMovementWorldSubsystem* Subsystem) { Subsystem->UpdateSignificance(); }
+
+	/** One batch pass at the current LODs, without rescoring */
+	static void RunBatch(UDroneMovementWorldSubsystem* Subsystem, float DeltaTime)
+	{
+		Subsystem->GatherState(DeltaTime);
+		Subsystem->Integrate(DeltaTime);
+		Subsystem->WriteBack();
+	}
+};
+
+namespace DroneServerInputTestPrivate
+{
+	/** Server side of a remote client's drone; the role is set before BeginPlay so it stays out of the batch */
+	UDroneMovementComponent* SpawnRemoteDrone(UWorld* World)
+	{
+		ADroneBase* Drone = World->SpawnActorDeferred<ADroneBase>(ADroneBase::StaticClass(), FTransform(FVector(0.0f, 0.0f, 1000.0f)), nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!Drone)
+			return nullptr;
+
+		Drone->SetAutonomousProxy(true);
+		Drone->FinishSpawning(FTransform(FVector(0.0f, 0.0f, 1000.0f)));
+		Drone->SetDroneConfig(NewObject<UDroneConfig>(Drone));
+		return Drone->FindComponentByClass<UDroneMovementComponent>();
+	}
+
+	/** Packet repeating inputs FirstID through LastID, as a client with that much redundancy sends */
+	FDroneInputPacket MakePacket(uint32 FirstID, uint32 LastID, float DeltaTime = 1.0f / 60.0f)
+	{
+		FDroneInputPacket Packet;
+		for (uint32 InputID = FirstID; InputID <= LastID; ++InputID)
+		{
+			FDroneInputState& Input = Packet.Inputs.AddDefaulted_GetRef();
+			Input.MovementInput = FVector(1.0f, 0.0f, 0.0f);
+			Input.DeltaTime = DeltaTime;
+			Input.InputID = InputID;
+		}
+		return Packet;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneInputDedupeTest, "DroneSystemPro.Networking.InputDedupe", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneInputDedupeTest::RunTest(const FString& Parameters)
+{
+	using namespace DroneServerInputTestPrivate;
+
+	if (!GEngine)
+		return false;
+
+	DronePushModelTestPrivate::FTestWorld TestWorld;
+	UDroneMovementComponent* Movement = SpawnRemoteDrone(TestWorld.World);
+	if (!TestNotNull(TEXT("Movement component"), Movement))
+		return false;
+
+	TArray<uint32> Consumed;
+	auto ConsumeAll = [Movement, &Consumed]()
+	{
+		FDroneInputState Input;
+		while (FDroneMovementTestAccess::ConsumeInput(Movement, Input))
+		{
+			Consumed.Add(Input.InputID);
+		}
+	};
+
+	// Each packet repeats the two inputs before it; some arrive after their repeats were consumed
+	for (uint32 InputID = 100; InputID <= 105; ++InputID)
+	{
+		FDroneMovementTestAccess::ReceiveInputs(Movement, MakePacket(FMath::Max(InputID - 2, 100u), InputID));
+		ConsumeAll();
+	}
+
+	// Others pile up before the server gets to them
+	for (uint32 InputID = 106; InputID <= 108; ++InputID)
+	{
+		FDroneMovementTestAccess::ReceiveInputs(Movement, MakePacket(InputID - 2, InputID));
+	}
+	ConsumeAll();
+
+	TArray<uint32> Expected;
+	for (uint32 InputID = 100; InputID <= 108; ++InputID)
+	{
+		Expected.Add(InputID);
+	}
+	TestEqual(TEXT("Each input should be consumed exactly once, in order"), Consumed, Expected);
+
+	// Inputs 109-114 were lost with every packet that repeated them
+	Consumed.Reset();
+	FDroneMovementTestAccess::ReceiveInputs(Movement, MakePacket(115, 117));
+	ConsumeAll();
+	TestEqual(TEXT("A gap beyond the redundancy window should be skipped"), Consumed, TArray<uint32>({ 115, 116, 117 }));
+
+	// A straggler from inside the gap is older than what the server already simulated
+	Consumed.Reset();
+	FDroneMovementTestAccess::ReceiveInputs(Movement, MakePacket(110, 112));
+	ConsumeAll();
+	TestEqual(TEXT("Inputs from the skipped gap should be dropped"), Consumed.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneMoveTimeBudgetTest, "DroneSystemPro.Networking.MoveTimeBudget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneMoveTimeBudgetTest::RunTest(const FString& Parameters)
+{
+	using namespace DroneServerInputTestPrivate;
+
+	if (!GEngine)
+		return false;
+
+	DronePushModelTestPrivate::FTestWorld TestWorld;
+	UDroneMovementComponent* Movement = SpawnRemoteDrone(TestWorld.World);
+	if (!TestNotNull(TEXT("Movement component"), Movement))
+		return false;
+
+	// One 0.1s move per 0.1s of real time is honest
+	const FVector Start = Movement->GetFlightState().Location;
+	FDroneMovementTestAccess::ReceiveInputs(Movement, MakePacket(1, 1, 0.1f));
+	FDroneMovementTestAccess::ServerTick(Movement, 0.1f);
+	TestEqual(TEXT("Honest move should be accepted"), Movement->GetRejectedMoveCount(), 0);
+	TestFalse(TEXT("Honest move should be simulated"), Movement->GetFlightState().Location.Equals(Start, KINDA_SMALL_NUMBER));
+
+	// Five moves in one 0.1s frame: the first spends the frame, the rest overdraw the tolerance
+	FDroneMovementTestAccess::ReceiveInputs(Movement, MakePacket(2, 6, 0.1f));
+	FDroneMovementTestAccess::ServerTick(Movement, 0.1f);
+	TestEqual(TEXT("Moves past the budget should be rejected"), Movement->GetRejectedMoveCount(), 4);
+	TestEqual(TEXT("Rejected moves should still be acknowledged"), FDroneMovementTestAccess::GetServerSnapshot(Movement).InputID, 6u);
+
+	// With almost no real time banked, none of them may move the drone
+	const FDroneFlightState Before = Movement->GetFlightState();
+	FDroneMovementTestAccess::ReceiveInputs(Movement, MakePacket(7, 9, 0.1f));
+	FDroneMovementTestAccess::ServerTick(Movement, 0.02f);
+	TestEqual(TEXT("Every overdrawn move should be rejected"), Movement->GetRejectedMoveCount(), 7);
+	TestTrue(TEXT("Rejected moves should not be integrated"), Movement->GetFlightState().Location.Equals(Before.Location, KINDA_SMALL_NUMBER));
+	TestTrue(TEXT("Rejected moves should not change velocity"), Movement->GetFlightState().Velocity.Equals(Before.Velocity, KINDA_SMALL_NUMBER));
+	TestEqual(TEXT("Latest rejected move should be acknowledged"), FDroneMovementTestAccess::GetServerSnapshot(Movement).InputID, 9u);
+
+	return true;
+}
+
+// Collision Response Tests
+namespace DroneCollisionTestPrivate
+{
+	AActor* SpawnBlockingBox(UWorld* World, const FVector& Center, const FVector& Extent, const FRotator& Rotation = FRotator::ZeroRotator)
+	{
+		AActor* Box = World->SpawnActor<AActor>(Center, Rotation);
+		UBoxComponent* Shape = NewObject<UBoxComponent>(Box);
+		Shape->SetBoxExtent(Extent, false);
+		Shape->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Box->SetRootComponent(Shape);
+		Shape->RegisterComponent();
+		Shape->SetWorldLocationAndRotation(Center, Rotation);
+		return Box;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneCollisionResponseTest, "DroneSystemPro.Movement.CollisionResponse", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneCollisionResponseTest::RunTest(const FString& Parameters)
+{
+	using namespace DroneServerInputTestPrivate;
+	using namespace DroneCollisionTestPrivate;
+
+	if (!GEngine)
+		return false;
+
+	// The drone is a 40 unit sphere at (0, 0, 1000)
+	{
+		DronePushModelTestPrivate::FTestWorld TestWorld;
+		UWorld* World = TestWorld.World;
+		UDroneMovementComponent* Movement = SpawnRemoteDrone(World);
+		if (!TestNotNull(TEXT("Movement component"), Movement))
+			return false;
+
+		// Wall face at X = 150, across the drone's path
+		SpawnBlockingBox(World, FVector(200.0f, 0.0f, 1000.0f), FVector(50.0f, 1000.0f, 1000.0f));
+
+		FDroneFlightState& State = FDroneMovementTestAccess::GetFlightState(Movement);
+		State.Location = FVector(300.0f, 100.0f, 1000.0f);
+		State.Velocity = FVector(1000.0f, 500.0f, 0.0f);
+		FDroneMovementTestAccess::ApplyMovement(Movement);
+
+		TestTrue(TEXT("Wall should stop the drone at its face"), State.Location.X > 105.0f && State.Location.X < 111.0f);
+		TestEqual(TEXT("Motion along the wall should be kept"), State.Location.Y, 100.0, 1.0);
+		TestTrue(TEXT("Velocity should be projected onto the wall"), State.Velocity.Equals(FVector(0.0f, 500.0f, 0.0f), 1.0f));
+		TestTrue(TEXT("Wall should be remembered as a contact"), FDroneMovementTestAccess::HasContact(Movement));
+
+		// Pushing straight into the remembered wall is clipped without a sweep
+		const FVector Pinned = State.Location;
+		const float ContactTime = FDroneMovementTestAccess::GetContactTime(Movement);
+		State.Location = Pinned + FVector(100.0f, 0.0f, 0.0f);
+		State.Velocity = FVector(500.0f, 0.0f, 0.0f);
+		FDroneMovementTestAccess::ApplyMovement(Movement);
+
+		TestTrue(TEXT("Clipped move should stay at the wall"), State.Location.Equals(Pinned, 0.1f));
+		TestTrue(TEXT("Clipped velocity should not point into the wall"), State.Velocity.IsNearlyZero(1.0f));
+		TestEqual(TEXT("Cached contact should skip the sweep"), FDroneMovementTestAccess::GetContactTime(Movement), ContactTime);
+
+		// Once the contact is stale the same move sweeps again and refreshes it
+		World->Tick(LEVELTICK_All, FDroneMovementTestAccess::GetContactRetestInterval(Movement) + 0.05f);
+		State.Location = Pinned + FVector(100.0f, 0.0f, 0.0f);
+		FDroneMovementTestAccess::ApplyMovement(Movement);
+
+		TestTrue(TEXT("Swept move should stay at the wall"), State.Location.X < 111.0f);
+		TestEqual(TEXT("Stale contact should be refreshed by a sweep"), FDroneMovementTestAccess::GetContactTime(Movement), World->GetTimeSeconds());
+	}
+
+	// Crease: a floor and a wall overhanging it by 20 degrees. Sliding off the wall
+	// alone would push down into the floor, so the drone follows their edge
+	{
+		DronePushModelTestPrivate::FTestWorld TestWorld;
+		UWorld* World = TestWorld.World;
+		UDroneMovementComponent* Movement = SpawnRemoteDrone(World);
+		if (!TestNotNull(TEXT("Movement component"), Movement))
+			return false;
+
+		// Floor top at Z = 950; wall face through (150, 0, 1000) facing (-0.94, 0, -0.34)
+		SpawnBlockingBox(World, FVector(0.0f, 0.0f, 900.0f), FVector(2000.0f, 2000.0f, 50.0f));
+		const FRotator WallRotation(20.0f, 0.0f, 0.0f);
+		SpawnBlockingBox(World, FVector(150.0f, 0.0f, 1000.0f) + WallRotation.RotateVector(FVector(50.0f, 0.0f, 0.0f)), FVector(50.0f, 2000.0f, 500.0f), WallRotation);
+
+		FDroneFlightState& State = FDroneMovementTestAccess::GetFlightState(Movement);
+		State.Location = FVector(300.0f, 100.0f, 900.0f);
+		State.Velocity = FVector(1000.0f, 300.0f, -300.0f);
+		FDroneMovementTestAccess::ApplyMovement(Movement);
+
+		TestTrue(TEXT("Floor should hold the drone up"), State.Location.Z > 985.0f);
+		TestTrue(TEXT("Wall should stop the drone short of its face"), State.Location.X < 115.0f);
+		TestTrue(TEXT("Drone should slide along the crease"), State.Location.Y > 10.0f);
+		TestTrue(TEXT("Velocity should follow the crease"), State.Velocity.Equals(FVector(0.0f, 300.0f, 0.0f), 1.0f));
+	}
+
+	return true;
+}
+
+// Movement LOD Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneMovementLODHysteresisTest, "DroneSystemPro.Movement.LODHysteresis", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneMovementLODHysteresisTest::RunTest(const FString& Parameters)
+{
+	if (!GEngine)
+		return false;
+
+	DronePushModelTestPrivate::FTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	UDroneMovementWorldSubsystem* Subsystem = World->GetSubsystem<UDroneMovementWorldSubsystem>();
+	APlayerController* Viewer = World->SpawnActor<APlayerController>(FVector::ZeroVector, FRotator::ZeroRotator);
+	ADroneBase* NearDrone = World->SpawnActor<ADroneBase>(FVector(1000.0f, 0.0f, 0.0f), FRotator::ZeroRotator);
+	ADroneBase* FarDrone = World->SpawnActor<ADroneBase>(FVector(0.0f, 1000.0f, 0.0f), FRotator::ZeroRotator);
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem) || !TestNotNull(TEXT("Viewer"), Viewer) || !TestNotNull(TEXT("Near drone"), NearDrone) || !TestNotNull(TEXT("Far drone"), FarDrone))
+		return false;
+
+	// Score is screen radius over distance; facing does not matter here
+	Subsystem->OffscreenScale = 1.0f;
+	for (ADroneBase* Drone : { NearDrone, FarDrone })
+	{
+		Drone->SetDroneConfig(NewObject<UDroneConfig>(Drone));
+		Subsystem->RegisterComponent(Drone->FindComponentByClass<UDroneMovementComponent>());
+	}
+
+	if (!TestEqual(TEXT("Both drones should be batched"), Subsystem->GetNumBatchedDrones(), 2))
+		return false;
+
+	const float Margin = Subsystem->SignificanceHysteresis;
+
+	// Places each drone at the distance that gives it a score, rescores, and returns its tier
+	auto Rescore = [Subsystem](ADroneBase* Drone, float Score, const FVector& Direction)
+	{
+		const float Radius = FMath::Max(static_cast<float>(Drone->GetRootComponent()->Bounds.SphereRadius), 1.0f);
+		Drone->SetActorLocation(Direction * (Radius / Score));
+		FDroneMovementTestAccess::UpdateSignificance(Subsystem);
+		return Drone->FindComponentByClass<UDroneMovementComponent>()->GetMovementLOD();
+	};
+
+	auto TestCounts = [this, Subsystem](const TCHAR* What, int32 Full, int32 Reduced, int32 Rail)
+	{
+		TestEqual(FString::Printf(TEXT("%s: Full count"), What), Subsystem->GetNumDronesInLOD(EDroneMovementLOD::Full), Full);
+		TestEqual(FString::Printf(TEXT("%s: Reduced count"), What), Subsystem->GetNumDronesInLOD(EDroneMovementLOD::Reduced), Reduced);
+		TestEqual(FString::Printf(TEXT("%s: Rail count"), What), Subsystem->GetNumDronesInLOD(EDroneMovementLOD::Rail), Rail);
+	};
+
+	const float Full = Subsystem->FullSignificance;
+	const float Reduced = Subsystem->ReducedSignificance;
+	const FVector NearDirection(1.0f, 0.0f, 0.0f);
+	const FVector FarDirection(0.0f, 1.0f, 0.0f);
+
+	TestTrue(TEXT("Near drone should start Full"), Rescore(NearDrone, Full * 2.0f, NearDirection) == EDroneMovementLOD::Full);
+	TestTrue(TEXT("Far drone should start Reduced"), Rescore(FarDrone, Reduced * 2.0f, FarDirection) == EDroneMovementLOD::Reduced);
+	TestCounts(TEXT("Initial"), 1, 1, 0);
+
+	// Full/Reduced boundary: swings inside the margin keep the tier in either direction
+	for (int32 Swing = 0; Swing < 4; ++Swing)
+	{
+		const float Score = Full * ((Swing % 2) ? 1.0f + Margin * 0.8f : 1.0f - Margin * 0.8f);
+		TestTrue(TEXT("Full tier should hold inside the margin"), Rescore(NearDrone, Score, NearDirection) == EDroneMovementLOD::Full);
+	}
+
+	TestTrue(TEXT("Clearing the lower margin should demote"), Rescore(NearDrone, Full * (1.0f - Margin * 1.2f), NearDirection) == EDroneMovementLOD::Reduced);
+	TestCounts(TEXT("Near demoted"), 0, 2, 0);
+
+	for (int32 Swing = 0; Swing < 4; ++Swing)
+	{
+		const float Score = Full * ((Swing % 2) ? 1.0f - Margin * 0.8f : 1.0f + Margin * 0.8f);
+		TestTrue(TEXT("Reduced tier should hold inside the margin"), Rescore(NearDrone, Score, NearDirection) == EDroneMovementLOD::Reduced);
+	}
+
+	TestTrue(TEXT("Clearing the upper margin should promote"), Rescore(NearDrone, Full * (1.0f + Margin * 1.2f), NearDirection) == EDroneMovementLOD::Full);
+	TestCounts(TEXT("Near promoted"), 1, 1, 0);
+
+	// Reduced/Rail boundary on the other drone
+	TestTrue(TEXT("Reduced tier should hold just under the threshold"), Rescore(FarDrone, Reduced * (1.0f - Margin * 0.8f), FarDirection) == EDroneMovementLOD::Reduced);
+	TestTrue(TEXT("Clearing the lower margin should drop to rails"), Rescore(FarDrone, Reduced * (1.0f - Margin * 1.2f), FarDirection) == EDroneMovementLOD::Rail);
+	TestCounts(TEXT("Far on rails"), 1, 0, 1);
+
+	TestTrue(TEXT("Rail tier should hold just over the threshold"), Rescore(FarDrone, Reduced * (1.0f + Margin * 0.8f), FarDirection) == EDroneMovementLOD::Rail);
+	TestTrue(TEXT("Clearing the upper margin should leave rails"), Rescore(FarDrone, Reduced * (1.0f + Margin * 1.2f), FarDirection) == EDroneMovementLOD::Reduced);
+	TestCounts(TEXT("Far off rails"), 1, 1, 0);
+
+	return true;
+}
+
+// Batched Movement Tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneBatchedWriteBackTest, "DroneSystemPro.Movement.BatchedWriteBack", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneBatchedWriteBackTest::RunTest(const FString& Parameters)
+{
+	if (!GEngine)
+		return false;
+
+	DronePushModelTestPrivate::FTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	UDroneMovementWorldSubsystem* Subsystem = World->GetSubsystem<UDroneMovementWorldSubsystem>();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+		return false;
+
+	// Six drones leave padding lanes in the second vector register
+	const int32 NumDrones = 6;
+	TArray<UDroneMovementComponent*> Movements;
+	TArray<FVector2D> LookInputs;
+	for (int32 Index = 0; Index < NumDrones; ++Index)
+	{
+		ADroneBase* Drone = World->SpawnActor<ADroneBase>(FVector(Index * 1000.0f, 0.0f, 1000.0f), FRotator(0.0f, Index * 30.0f, 0.0f));
+		if (!TestNotNull(TEXT("Drone"), Drone))
+			return false;
+
+		Drone->SetDroneConfig(NewObject<UDroneConfig>(Drone));
+		UDroneMovementComponent* Movement = Drone->FindComponentByClass<UDroneMovementComponent>();
+		Subsystem->RegisterComponent(Movement);
+
+		Movement->SetMovementInput(FVector(FMath::Cos(Index * 1.1f), FMath::Sin(Index * 1.1f), (Index % 3 - 1) * 0.5f));
+		LookInputs.Add(FVector2D(Index * 0.2f - 0.5f, 0.0f));
+		Movement->SetLookInput(LookInputs.Last());
+		Movement->SetSpeedMode(Index % 2 ? EDroneSpeedMode::High : EDroneSpeedMode::Low);
+		Movements.Add(Movement);
+	}
+
+	if (!TestEqual(TEXT("All drones should be batched"), Subsystem->GetNumBatchedDrones(), NumDrones))
+		return false;
+
+	// Each drone stepped on its own by the flight model, from the state the batch gathers
+	const float DeltaTime = 1.0f / 60.0f;
+	TArray<FDroneFlightState> Expected;
+	for (int32 Index = 0; Index < NumDrones; ++Index)
+	{
+		const UDroneMovementComponent* Movement = Movements[Index];
+		const USceneComponent* Root = Movement->GetOwner()->GetRootComponent();
+		FDroneFlightState State(Root->GetComponentLocation(), Root->GetComponentRotation(), Movement->GetVelocity());
+		FDroneFlightModel::Simulate(State, FDroneFlightInput(Movement->GetMovementInput(), LookInputs[Index], Movement->GetSpeedMode()), Movement->GetFlightConfig(), DeltaTime);
+		Expected.Add(State);
+	}
+
+	FDroneMovementTestAccess::RunBatch(Subsystem, DeltaTime);
+
+	for (int32 Index = 0; Index < NumDrones; ++Index)
+	{
+		const FDroneFlightState& Actual = Movements[Index]->GetFlightState();
+		TestTrue(FString::Printf(TEXT("Drone %d location should match the flight model"), Index), Actual.Location.Equals(Expected[Index].Location, 1.0f));
+		TestTrue(FString::Printf(TEXT("Drone %d velocity should match the flight model"), Index), Actual.Velocity.Equals(Expected[Index].Velocity, 1.0f));
+		TestTrue(FString::Printf(TEXT("Drone %d rotation should match the flight model"), Index), Actual.Rotation.Equals(Expected[Index].Rotation, 0.1f));
+		TestTrue(FString::Printf(TEXT("Drone %d root should be moved to the result"), Index), Movements[Index]->GetOwner()->GetActorLocation().Equals(Actual.Location, KINDA_SMALL_NUMBER));
+	}
+
+	TestFalse(TEXT("Drones should have moved"), Movements[0]->GetFlightState().Location.Equals(FVector(0.0f, 0.0f, 1000.0f), 1.0f));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneAsyncStateSequenceTest, "DroneSystemPro.Movement.AsyncStateSequence", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneAsyncStateSequenceTest::RunTest(const FString& Parameters)
+{
+	const float Tolerance = 1.0f;
+	auto MakeState = [](float X) { return FDroneFlightState(FVector(X, 0.0f, 1000.0f), FRotator::ZeroRotator, FVector(600.0f, 0.0f, 0.0f)); };
+
+	// Registration hands the physics thread its first state
+	FDroneAsyncFlightSlot Slot;
+	Slot.SyncFromGameThread(MakeState(0.0f), Tolerance);
+	TestTrue(TEXT("First sync should register the drone"), Slot.bRegistered);
+	const uint32 FirstSequence = Slot.StateSequence;
+
+	TestTrue(TEXT("Result from the current state should be taken"), Slot.ApplyResult(MakeState(10.0f), FirstSequence));
+	Slot.PresentedLocation = Slot.Current.Location;
+
+	// Presented where the physics thread put it: nothing to correct
+	Slot.SyncFromGameThread(MakeState(10.0f), Tolerance);
+	TestEqual(TEXT("Matching state should keep the sequence"), Slot.StateSequence, FirstSequence);
+
+	// Collision stopped the drone short; steps already in flight started from the old state
+	Slot.SyncFromGameThread(MakeState(4.0f), Tolerance);
+	TestEqual(TEXT("Correction should bump the sequence"), Slot.StateSequence, FirstSequence + 1);
+	TestEqual(TEXT("Correction should reset the presented pair"), Slot.Current.Location.X, 4.0, KINDA_SMALL_NUMBER);
+
+	TestFalse(TEXT("Stale result should be discarded"), Slot.ApplyResult(MakeState(20.0f), FirstSequence));
+	TestEqual(TEXT("Stale result should not move the drone"), Slot.Current.Location.X, 4.0, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Stale result should not shift the blend pair"), Slot.Previous.Location.X, 4.0, KINDA_SMALL_NUMBER);
+
+	TestTrue(TEXT("Result from the corrected state should be taken"), Slot.ApplyResult(MakeState(14.0f), FirstSequence + 1));
+	TestEqual(TEXT("Accepted result should become current"), Slot.Current.Location.X, 14.0, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Accepted result should shift the blend pair"), Slot.Previous.Location.X, 4.0, KINDA_SMALL_NUMBER);
+
+	return true;
+}
+
+// Replication Graph Tests
+struct FDroneReplicationGraphTestAccess
+{
+	/** What InitForNetDriver sets up, minus the net driver and connections */
+	static void Init(UDroneReplicationGraph* Graph, UWorld* World)
+	{
+		if (Graph->GraphGlobals.IsValid())
+		{
+			Graph->GraphGlobals->World = World;
+		}
+
+		Graph->InitGlobalActorClassSettings();
+		Graph->InitGlobalGraphNodes();
+	}
+
+	static void AddActor(UDroneReplicationGraph* Graph, AActor* Actor)
+	{
+		Graph->RouteAddNetworkActorToNodes(FNewReplicatedActorInfo(Actor), Graph->GlobalActorReplicationInfoMap.Get(Actor));
+	}
+
+	static void RemoveActor(UDroneReplicationGraph* Graph, AActor* Actor)
+	{
+		Graph->RouteRemoveNetworkActorToNodes(FNewReplicatedActorInfo(Actor));
+	}
+
+	static void UpdateParkedDrones(UDroneReplicationGraph* Graph) { Graph->UpdateParkedDrones(); }
+
+	static int32 GetNumTrackedDrones(const UDroneReplicationGraph* Graph) { return Graph->Drones.Num(); }
+
+	static bool IsTrackedAsParked(const UDroneReplicationGraph* Graph, const ADroneBase* Drone)
+	{
+		const UDroneReplicationGraph::FTrackedDrone* Tracked = Graph->Drones.FindByPredicate([Drone](const UDroneReplicationGraph::FTrackedDrone& Entry) { return Entry.Drone == Drone; });
+		return Tracked && Tracked->bParked;
+	}
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneReplicationGraphParkingTest, "DroneSystemPro.Networking.ReplicationGraphParking", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDroneReplicationGraphParkingTest::RunTest(const FString& Parameters)
+{
+	if (!GEngine)
+		return false;
+
+	DronePushModelTestPrivate::FTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	ADroneBase* Drone = World->SpawnActor<ADroneBase>(FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator);
+	ADroneBase* ParkedDrone = World->SpawnActor<ADroneBase>(FVector(500.0f, 0.0f, 100.0f), FRotator::ZeroRotator);
+	if (!TestNotNull(TEXT("Drone"), Drone) || !TestNotNull(TEXT("Parked drone"), ParkedDrone))
+		return false;
+
+	Drone->SetDroneConfig(NewObject<UDroneConfig>(Drone));
+	ParkedDrone->SetDroneConfig(NewObject<UDroneConfig>(ParkedDrone));
+	ParkedDrone->SetActive(false);
+
+	UDroneReplicationGraph* Graph = NewObject<UDroneReplicationGraph>(GetTransientPackage());
+	FDroneReplicationGraphTestAccess::Init(Graph, World);
+	FDroneReplicationGraphTestAccess::AddActor(Graph, Drone);
+	FDroneReplicationGraphTestAccess::AddActor(Graph, ParkedDrone);
+
+	TestEqual(TEXT("Both drones should be tracked"), FDroneReplicationGraphTestAccess::GetNumTrackedDrones(Graph), 2);
+	TestEqual(TEXT("Inactive drone should start in the parked node"), Graph->GetNumParkedDrones(), 1);
+	TestFalse(TEXT("Active drone should start in the grid"), FDroneReplicationGraphTestAccess::IsTrackedAsParked(Graph, Drone));
+
+	// Deactivation is picked up on the next graph update, not when it happens
+	Drone->SetActive(false);
+	TestEqual(TEXT("Parking should wait for the graph update"), Graph->GetNumParkedDrones(), 1);
+	FDroneReplicationGraphTestAccess::UpdateParkedDrones(Graph);
+	TestEqual(TEXT("Deactivated drone should move to the parked node"), Graph->GetNumParkedDrones(), 2);
+	TestTrue(TEXT("Deactivated drone should be tracked as parked"), FDroneReplicationGraphTestAccess::IsTrackedAsParked(Graph, Drone));
+
+	// An unchanged drone is not moved again
+	FDroneReplicationGraphTestAccess::UpdateParkedDrones(Graph);
+	TestEqual(TEXT("Repeated updates should not duplicate parked drones"), Graph->GetNumParkedDrones(), 2);
+
+	Drone->SetActive(true);
+	FDroneReplicationGraphTestAccess::UpdateParkedDrones(Graph);
+	TestEqual(TEXT("Reactivated drone should leave the parked node"), Graph->GetNumParkedDrones(), 1);
+	TestFalse(TEXT("Reactivated drone should be back in the grid"), FDroneReplicationGraphTestAccess::IsTrackedAsParked(Graph, Drone));
+
+	// Removal takes each drone out of whichever node holds it
+	FDroneReplicationGraphTestAccess::RemoveActor(Graph, ParkedDrone);
+	FDroneReplicationGraphTestAccess::RemoveActor(Graph, Drone);
+	TestEqual(TEXT("Removed drones should not be tracked"), FDroneReplicationGraphTestAccess::GetNumTrackedDrones(Graph), 0);
+	TestEqual(TEXT("Removed parked drone should leave the parked node"), Graph->GetNumParkedDrones(), 0);
+
+	return true;
+}
+
 // Marking Component Tests
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDroneMarkingTest, "DroneSystemPro.Marking.MarkTest", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
 
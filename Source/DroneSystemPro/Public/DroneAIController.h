@@ -70,6 +70,9 @@ protected:
 	FVector GetNextPatrolPoint();
 	bool HasReachedTarget(float Tolerance = 100.0f) const;
 
+	/** Terrain following while patrolling, per the profile's PatrolAltitude */
+	void UpdateAltitudeHold();
+
 	// Configuration
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "AI")
 	UDroneBehaviorProfile* BehaviorProfile;
@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/ActorChannel.h"
+#include "DroneActorChannel.generated.h"
+
+class UDroneReplicationComponent;
+
+/**
+ * Actor channel that meters the bunches it sends for drones
+ * Each bunch's payload is reported to the actor's UDroneReplicationComponent, which turns
+ * it into a per-connection byte rate. Replaces the engine actor channel with
+ * [/Script/Engine.NetDriver]
+ * !ChannelDefinitions=ClearArray
+ * +ChannelDefinitions=(ChannelName=Control, ClassName=/Script/Engine.ControlChannel, StaticChannelIndex=0, bTickOnCreate=true, bServerOpen=false, bClientOpen=true, bInitialServer=false, bInitialClient=true)
+ * +ChannelDefinitions=(ChannelName=Voice, ClassName=/Script/Engine.VoiceChannel, StaticChannelIndex=1, bTickOnCreate=true, bServerOpen=true, bClientOpen=true, bInitialServer=true, bInitialClient=true)
+ * +ChannelDefinitions=(ChannelName=Actor, ClassName=/Script/DroneSystemPro.DroneActorChannel, StaticChannelIndex=-1, bTickOnCreate=false, bServerOpen=true, bClientOpen=false, bInitialServer=false, bInitialClient=false)
+ */
+UCLASS(Transient)
+class DRONESYSTEMPRO_API UDroneActorChannel : public UActorChannel
+{
+	GENERATED_BODY()
+
+public:
+	virtual FPacketIdRange SendBunch(FOutBunch* Bunch, bool Merge) override;
+
+private:
+	/** Replication component of Actor, resolved when the channel's actor changes */
+	TWeakObjectPtr<UDroneReplicationComponent> Replication;
+
+	TWeakObjectPtr<AActor> ResolvedActor;
+};
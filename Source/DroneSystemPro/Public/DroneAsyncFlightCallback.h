@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chaos/SimCallbackObject.h"
+#include "Chaos/SimCallbackInput.h"
+#include "DroneFlightModel.h"
+
+/**
+ * Game thread to physics thread update for one drone
+ * State is only applied when StateSequence is newer than the last one the physics
+ * thread applied, since an input can be consumed by several fixed steps.
+ */
+struct FDroneAsyncDroneInput
+{
+	uint32 DroneID = 0;
+	FDroneFlightInput Input;
+	FDroneFlightConfig Config;
+
+	/** Authoritative state from the game thread (spawn, teleport, collision) */
+	FDroneFlightState State;
+	uint32 StateSequence = 0;
+};
+
+struct FDroneAsyncFlightInput : public Chaos::FSimCallbackInput
+{
+	TArray<FDroneAsyncDroneInput> Drones;
+	TArray<uint32> RemovedDrones;
+
+	void Reset()
+	{
+		Drones.Reset();
+		RemovedDrones.Reset();
+	}
+};
+
+struct FDroneAsyncDroneOutput
+{
+	uint32 DroneID = 0;
+	FDroneFlightState State;
+
+	/** Last state sequence applied; older results predate a game thread correction */
+	uint32 StateSequence = 0;
+};
+
+struct FDroneAsyncFlightOutput : public Chaos::FSimCallbackOutput
+{
+	TArray<FDroneAsyncDroneOutput> Drones;
+
+	void Reset()
+	{
+		Drones.Reset();
+	}
+};
+
+/**
+ * Runs the flight model for async drones inside the Chaos solver's fixed step
+ * The physics thread owns its copy of each drone's state; inputs persist until
+ * replaced, so frames where the game thread hitches simply hold the last input.
+ */
+class DRONESYSTEMPRO_API FDroneAsyncFlightCallback : public Chaos::TSimCallbackObject<FDroneAsyncFlightInput, FDroneAsyncFlightOutput, Chaos::ESimCallbackOptions::Presimulate>
+{
+public:
+	virtual void OnPreSimulate_Internal() override;
+
+private:
+	struct FSimulatedDrone
+	{
+		FDroneFlightState State;
+		FDroneFlightInput Input;
+		FDroneFlightConfig Config;
+		uint32 StateSequence = 0;
+	};
+
+	/** Physics thread only */
+	TMap<uint32, FSimulatedDrone> Drones;
+};
@@ -17,6 +17,7 @@ class UDroneCameraEffectsComponent;
 class UCameraComponent;
 class USpringArmComponent;
 class UStaticMeshComponent;
+class USphereComponent;
 
 /**
  * Base drone pawn with all components
@@ -38,7 +39,17 @@ protected:
 	virtual void PossessedBy(AController* NewController) override;
 
 public:
+	// Networking
+	/** Distance and team relevancy from the replication component instead of a single NetCullDistanceSquared */
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+	/** Favors drones in the viewer's view cone, close by or on its team; the viewer's own drone keeps the engine boost */
+	virtual float GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth) override;
+
 	// Component accessors
+	UFUNCTION(BlueprintPure, Category = "Drone")
+	USphereComponent* GetCollisionComponent() const { return CollisionComponent; }
+
 	UFUNCTION(BlueprintPure, Category = "Drone")
 	UDroneMovementComponent* GetDroneMovement() const { return DroneMovement; }
 
@@ -95,6 +106,10 @@ public:
 
 protected:
 	// Components
+	/** Root collision used by movement sweeps; the mesh is visual only so corrections can be smoothed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USphereComponent* CollisionComponent;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UStaticMeshComponent* DroneMesh;
 
@@ -36,6 +36,9 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Battery")
 	float GetBatteryPercent() const;
 
+	UFUNCTION(BlueprintPure, Category = "Battery")
+	float GetMaxBattery() const;
+
 	UFUNCTION(BlueprintPure, Category = "Battery")
 	bool IsDepleted() const { return BatteryLevel <= 0.0f; }
 
@@ -128,4 +131,7 @@ protected:
 private:
 	void CalculateAndApplyDrain(float DeltaTime);
 	float CalculateTotalDrainRate() const;
+
+	/** Mark a per-tick drain or recharge; a dormant drone is only woken every tenth of capacity */
+	void MarkContinuousLevelChange(float OldLevel);
 };
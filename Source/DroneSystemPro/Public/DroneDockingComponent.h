@@ -36,7 +36,7 @@ public:
 	void UndockDrone();
 
 	UFUNCTION(BlueprintPure, Category = "Docking")
-	bool IsDroneD ocked() const { return DockedDrone != nullptr; }
+	bool IsDroneDocked() const { return DockedDrone != nullptr; }
 
 	UFUNCTION(BlueprintPure, Category = "Docking")
 	ADroneBase* GetDockedDrone() const { return DockedDrone; }
@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DroneFlightModel.h"
+
+/**
+ * Packed structure-of-arrays flight state for many drones
+ * Every lane array is 16-byte aligned and padded to a multiple of LaneWidth so the
+ * vector kernel never needs a scalar tail. Positions stay in double precision per
+ * drone; lanes only carry the float displacement accumulated since SetDrone.
+ */
+struct DRONESYSTEMPRO_API FDroneFlightBatch
+{
+	using FLaneArray = TArray<float, TAlignedHeapAllocator<16>>;
+
+	/** Drones processed per vector register */
+	static constexpr int32 LaneWidth = 4;
+
+	/** Resize for NumDrones, padding with inert lanes */
+	void SetNum(int32 InNumDrones);
+
+	int32 Num() const { return NumDrones; }
+
+	/** Number of lanes including padding, always a multiple of LaneWidth */
+	int32 NumPadded() const { return Yaw.Num(); }
+
+	/** Load a drone's state, input and flattened tuning into its lanes */
+	void SetDrone(int32 Index, const FDroneFlightState& State, const FDroneFlightInput& Input, const FDroneFlightConfig& Config);
+
+	/** Read a drone's state back, including the displacement integrated so far */
+	FDroneFlightState GetState(int32 Index) const;
+
+	// State
+	TArray<FVector> Origins;
+	FLaneArray DisplacementX, DisplacementY, DisplacementZ;
+	FLaneArray VelocityX, VelocityY, VelocityZ;
+	FLaneArray Yaw, Pitch, Roll;
+
+	// Input
+	FLaneArray MoveX, MoveY, MoveZ;
+	FLaneArray LookX, LookY;
+
+	/** Wind acceleration (wind velocity times WindResponse) plus obstacle avoidance, held for the frame */
+	FLaneArray WindX, WindY, WindZ;
+
+	// Tuning, with speed mode and scale already resolved
+	FLaneArray MaxSpeed, Acceleration, Deceleration, TurnRate, MaxPitchAngle, MaxRollAngle, RollInterpSpeed;
+
+private:
+	int32 NumDrones = 0;
+};
+
+/**
+ * Integration kernels over FDroneFlightBatch
+ * Both paths implement FDroneFlightModel::Step. The vectorized path uses VectorRegister
+ * intrinsics with branchless selects; the scalar path runs the same float math one lane
+ * at a time and is the reference the vector path is validated against.
+ */
+struct DRONESYSTEMPRO_API FDroneFlightBatchKernel
+{
+	/**
+	 * Integrate lanes [StartIndex, EndIndex) by DeltaTime, four at a time
+	 * Both bounds must be multiples of FDroneFlightBatch::LaneWidth
+	 */
+	static void StepVectorized(FDroneFlightBatch& Batch, int32 StartIndex, int32 EndIndex, float DeltaTime);
+
+	/** Scalar reference for StepVectorized; any range is allowed */
+	static void StepScalar(FDroneFlightBatch& Batch, int32 StartIndex, int32 EndIndex, float DeltaTime);
+
+	/**
+	 * Integrate a lane range with equal substeps, matching FDroneFlightModel::Simulate
+	 * @return Number of substeps taken
+	 */
+	static int32 Simulate(FDroneFlightBatch& Batch, int32 StartIndex, int32 EndIndex, float DeltaTime, float MaxSubstepDeltaTime, int32 MaxSubsteps, bool bVectorized = true);
+};
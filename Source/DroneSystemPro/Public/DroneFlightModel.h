@@ -0,0 +1,171 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DroneTypes.h"
+
+class UDroneConfig;
+
+/**
+ * Kinematic state integrated by the flight model
+ */
+struct DRONESYSTEMPRO_API FDroneFlightState
+{
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	FVector Velocity = FVector::ZeroVector;
+
+	FDroneFlightState() {}
+
+	FDroneFlightState(const FVector& InLocation, const FRotator& InRotation, const FVector& InVelocity)
+		: Location(InLocation), Rotation(InRotation), Velocity(InVelocity)
+	{}
+};
+
+/**
+ * Per-step control input consumed by the flight model
+ */
+struct DRONESYSTEMPRO_API FDroneFlightInput
+{
+	/** Local space movement input (X forward, Y right, Z up), clamped to unit length */
+	FVector MovementInput = FVector::ZeroVector;
+
+	/** Look input (X yaw, Y pitch) */
+	FVector2D LookInput = FVector2D::ZeroVector;
+
+	EDroneSpeedMode SpeedMode = EDroneSpeedMode::Low;
+
+	/** Air velocity at the drone, sampled from the wind field */
+	FVector WindVelocity = FVector::ZeroVector;
+
+	/** Distance to the nearest baked obstacle; ignored beyond the config's AvoidanceDistance */
+	float ObstacleDistance = MAX_flt;
+
+	/** Unit direction away from that obstacle (distance field gradient) */
+	FVector ObstacleNormal = FVector::ZeroVector;
+
+	FDroneFlightInput() {}
+
+	FDroneFlightInput(const FVector& InMovement, const FVector2D& InLook, EDroneSpeedMode InSpeedMode)
+		: MovementInput(InMovement), LookInput(InLook), SpeedMode(InSpeedMode)
+	{}
+};
+
+/**
+ * Flattened tuning values for the flight model
+ * Built once from a UDroneConfig so the kernel never dereferences UObjects
+ */
+struct DRONESYSTEMPRO_API FDroneFlightConfig
+{
+	float MaxSpeedLow = 600.0f;
+	float MaxSpeedHigh = 1200.0f;
+	float Acceleration = 1000.0f;
+	float Deceleration = 2000.0f;
+	float TurnRate = 180.0f;
+	float MaxPitchAngle = 45.0f;
+	float MaxRollAngle = 45.0f;
+	float RollInterpSpeed = 5.0f;
+
+	/** Acceleration per unit of wind velocity; wind is applied after the speed clamp so it can carry the drone past top speed */
+	float WindResponse = 1.0f;
+
+	/** Obstacles closer than this steer the drone away; 0 disables avoidance */
+	float AvoidanceDistance = 300.0f;
+
+	/** Outward acceleration at contact, easing to zero at AvoidanceDistance */
+	float AvoidanceAcceleration = 1500.0f;
+
+	/** Environmental scale on top speed (jamming) */
+	float SpeedScale = 1.0f;
+
+	/** Longest single integration step; larger deltas are split into equal substeps */
+	float MaxSubstepDeltaTime = 1.0f / 60.0f;
+
+	/** Upper bound on substeps per Simulate call */
+	int32 MaxSubsteps = 8;
+
+	float GetMaxSpeed(EDroneSpeedMode Mode) const
+	{
+		return ((Mode == EDroneSpeedMode::High) ? MaxSpeedHigh : MaxSpeedLow) * SpeedScale;
+	}
+
+	/** Copy tuning values from a config asset, keeping defaults when null */
+	static FDroneFlightConfig FromDroneConfig(const UDroneConfig* Config);
+};
+
+/**
+ * Engine-independent drone flight kernel
+ * Pure function of (state, input, config, delta) - touches no actor or UObject,
+ * so prediction, reconciliation replay, server simulation and benchmarks share it
+ */
+struct DRONESYSTEMPRO_API FDroneFlightModel
+{
+	/**
+	 * Integrate a single step of DeltaTime
+	 * @param State		State to advance in place
+	 * @param Input		Control input held for the step
+	 * @param Config	Flattened tuning values
+	 * @param DeltaTime	Step length in seconds
+	 */
+	static void Step(FDroneFlightState& State, const FDroneFlightInput& Input, const FDroneFlightConfig& Config, float DeltaTime);
+
+	/**
+	 * Integrate DeltaTime using equal substeps no longer than Config.MaxSubstepDeltaTime
+	 * The substep count depends only on DeltaTime and Config, so identical inputs replay identically
+	 * @return Number of substeps taken
+	 */
+	static int32 Simulate(FDroneFlightState& State, const FDroneFlightInput& Input, const FDroneFlightConfig& Config, float DeltaTime);
+
+	/** Equal substep count Simulate uses for DeltaTime */
+	static int32 GetNumSubsteps(float DeltaTime, float MaxSubstepDeltaTime, int32 MaxSubsteps);
+
+	/**
+	 * Coarse kinematic step for drones nobody is watching
+	 * Velocity snaps to the desired velocity, roll is dropped; no substeps
+	 */
+	static void StepRail(FDroneFlightState& State, const FDroneFlightInput& Input, const FDroneFlightConfig& Config, float DeltaTime);
+
+	/**
+	 * Acceleration away from the obstacle in Input: brakes the approach speed so the drone
+	 * stops short of the surface, plus a push that grows towards contact. Motion along the
+	 * surface is left alone, so drones slide around obstacles.
+	 */
+	static FVector CalculateAvoidance(const FVector& Velocity, const FDroneFlightInput& Input, const FDroneFlightConfig& Config);
+
+	/** World space velocity the drone is steering towards for the given heading and input */
+	static FVector CalculateDesiredVelocity(const FRotator& Rotation, const FVector& MovementInput, float MaxSpeed);
+
+	/** Advance yaw/pitch from look input and ease roll towards the banking angle */
+	static FRotator CalculateRotation(const FRotator& Rotation, const FDroneFlightInput& Input, const FDroneFlightConfig& Config, float DeltaTime);
+};
+
+/**
+ * Splits variable frame time into fixed simulation steps
+ * Time short of a whole step carries over to the next frame and doubles as the
+ * render interpolation alpha. Steps beyond MaxStepsPerFrame are dropped, so one
+ * slow frame cannot cause ever longer ones.
+ */
+struct DRONESYSTEMPRO_API FDroneFixedStepAccumulator
+{
+	float StepTime = 1.0f / 60.0f;
+	int32 MaxStepsPerFrame = 4;
+
+	/**
+	 * Add a frame's time
+	 * @return Steps to simulate this frame
+	 */
+	int32 Advance(float DeltaTime);
+
+	/** Fraction of a step accumulated past the last simulated one, 0-1 */
+	float GetAlpha() const;
+
+	/** Steps discarded by the per-frame cap since Reset */
+	int32 GetNumDroppedSteps() const { return NumDroppedSteps; }
+
+	void Reset();
+
+private:
+	float Accumulator = 0.0f;
+	int32 NumDroppedSteps = 0;
+};
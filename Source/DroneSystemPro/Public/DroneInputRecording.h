@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DroneTypes.h"
+
+/**
+ * Network conditions seen by a client, as sampled while recording
+ */
+struct DRONESYSTEMPRO_API FDroneNetConditions
+{
+	/** Seconds */
+	float RoundTripTime = 0.0f;
+
+	/** Fraction of client to server packets lost (0-1) */
+	float OutLoss = 0.0f;
+
+	/** Fraction of server to client packets lost (0-1) */
+	float InLoss = 0.0f;
+
+	FDroneNetConditions() {}
+	FDroneNetConditions(float InRoundTripTime, float InOutLoss, float InInLoss)
+		: RoundTripTime(InRoundTripTime), OutLoss(InOutLoss), InLoss(InInLoss)
+	{
+	}
+};
+
+/**
+ * Captured input stream of one owning client plus the network conditions it saw
+ * One entry per rendered frame with the frame's delta time, at wire precision, so a
+ * replay re-runs the client's fixed step accumulation on the same frames. Conditions
+ * are kept only when they change by at least 1ms or 1%. Files live in
+ * Saved/DroneRecordings and are replayed by FDroneNetReplay.
+ */
+class DRONESYSTEMPRO_API FDroneInputRecording
+{
+public:
+	static constexpr uint32 Magic = 0x43455244; // "DREC"
+	static constexpr int32 Version = 1;
+
+	/** Append one client frame; Input is quantized, its InputID and Timestamp are dropped */
+	void AddFrame(const FDroneInputState& Input, const FDroneNetConditions& Conditions);
+
+	void Reset();
+
+	int32 Num() const { return Inputs.Num(); }
+
+	/** Recorded frame delta times summed */
+	float GetDuration() const;
+
+	const FDroneInputState& GetInput(int32 Frame) const { return Inputs[Frame]; }
+
+	/** Conditions in effect at Frame, at recorded precision */
+	FDroneNetConditions GetConditions(int32 Frame) const;
+
+	/**
+	 * Read or write the binary form
+	 * @return False on a bad header or truncated data
+	 */
+	bool Serialize(FArchive& Ar);
+
+	bool SaveToFile(const FString& FileName) const;
+	bool LoadFromFile(const FString& FileName);
+
+	/** Where recordings are written, Saved/DroneRecordings */
+	static FString GetRecordingDir();
+
+	/** File extension without the dot */
+	static const TCHAR* GetFileExtension() { return TEXT("dronerec"); }
+
+private:
+	/** Conditions from Frame on, quantized to milliseconds and percent */
+	struct FConditionSample
+	{
+		int32 Frame = 0;
+		uint16 RoundTripMs = 0;
+		uint8 OutLossPercent = 0;
+		uint8 InLossPercent = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FConditionSample& Sample)
+		{
+			return Ar << Sample.Frame << Sample.RoundTripMs << Sample.OutLossPercent << Sample.InLossPercent;
+		}
+	};
+
+	TArray<FDroneInputState> Inputs;
+	TArray<FConditionSample> ConditionSamples;
+};
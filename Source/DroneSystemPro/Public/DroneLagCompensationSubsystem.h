@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "DroneLagCompensationSubsystem.generated.h"
+
+/**
+ * One recorded actor pose
+ */
+struct FDroneRewindSample
+{
+	float Time = 0.0f;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+};
+
+/**
+ * Fixed-capacity ring buffer of poses in increasing time order
+ * Recording past capacity overwrites the oldest sample; nothing is allocated after Reset.
+ */
+class DRONESYSTEMPRO_API FDroneTransformHistory
+{
+public:
+	explicit FDroneTransformHistory(int32 InCapacity = 32);
+
+	/** Drop all samples and resize */
+	void Reset(int32 InCapacity);
+
+	/** Append a pose; samples not newer than the last one are ignored */
+	void Record(float Time, const FVector& Location, const FQuat& Rotation);
+
+	/**
+	 * Pose at Time, interpolated between the bracketing samples
+	 * Times outside the recorded window clamp to the oldest or newest sample.
+	 * @return False if nothing has been recorded
+	 */
+	bool Sample(float Time, FVector& OutLocation, FQuat& OutRotation) const;
+
+	int32 Num() const { return Count; }
+	float GetOldestTime() const { return Count > 0 ? Get(0).Time : 0.0f; }
+	float GetNewestTime() const { return Count > 0 ? Get(Count - 1).Time : 0.0f; }
+
+private:
+	/** Sample by age, 0 = oldest */
+	const FDroneRewindSample& Get(int32 Age) const;
+
+	TArray<FDroneRewindSample> Samples;
+	int32 Head;
+	int32 Count;
+};
+
+/**
+ * Server-side rewind buffer for lag-compensated validation
+ * Records every pawn (and any actor registered explicitly) at a fixed interval so
+ * client requests can be checked against where actors were when the client saw
+ * them, instead of loosening range checks for high-ping players.
+ *
+ * Clients stamp requests with GetClientViewTime(); the server clamps that to the
+ * recorded window before rewinding, so a forged timestamp buys at most MaxRewindTime.
+ */
+UCLASS(Config = Game)
+class DRONESYSTEMPRO_API UDroneLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UDroneLagCompensationSubsystem();
+
+	// UTickableWorldSubsystem
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+
+	/** Record an actor that is not a pawn (pawns are tracked automatically) */
+	void RegisterActor(AActor* Actor);
+	void UnregisterActor(AActor* Actor);
+
+	/**
+	 * Client side: server time (UDroneNetClockSubsystem) of Target as this client currently renders it
+	 * Remote drones report their snapshot interpolator's render time, which follows its adaptive
+	 * delay; other actors fall back to ClientViewDelay.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Lag Compensation")
+	float GetClientViewTime(const AActor* Target = nullptr) const;
+
+	/** Server side: a client supplied time limited to the recorded window */
+	float ClampRewindTime(float ClientTime) const;
+
+	/**
+	 * Actor transform at server time Time
+	 * Untracked actors report their current transform.
+	 * @return True if the result came from recorded history
+	 */
+	bool GetTransformAtTime(const AActor* Actor, float Time, FTransform& OutTransform) const;
+
+	UFUNCTION(BlueprintPure, Category = "Lag Compensation")
+	FVector GetActorLocationAtTime(AActor* Actor, float Time) const;
+
+	/** True if A and B were within Range (plus RangeTolerance) of each other at Time */
+	bool WereInRange(const AActor* A, const AActor* B, float Range, float Time) const;
+
+	/**
+	 * Trace against tracked actors' bounds as they were at Time
+	 * World static geometry blocks the trace at its present position.
+	 * @return Nearest rewound actor hit, or nullptr
+	 */
+	AActor* RewoundLineTrace(const FVector& Start, const FVector& End, float Time, const AActor* IgnoreActor, FVector* OutHitLocation = nullptr) const;
+
+	/** Oldest state a request may rewind to */
+	UPROPERTY(Config, EditAnywhere, Category = "Lag Compensation")
+	float MaxRewindTime;
+
+	/** Seconds between recorded samples */
+	UPROPERTY(Config, EditAnywhere, Category = "Lag Compensation")
+	float RecordInterval;
+
+	/** How far behind the server clients render remote actors without a snapshot interpolator */
+	UPROPERTY(Config, EditAnywhere, Category = "Lag Compensation")
+	float ClientViewDelay;
+
+	/** Absolute slack for rewound range checks, covering interpolation and quantization error */
+	UPROPERTY(Config, EditAnywhere, Category = "Lag Compensation")
+	float RangeTolerance;
+
+private:
+	struct FTrack
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FBox LocalBounds;
+		FDroneTransformHistory History;
+	};
+
+	void HandleActorSpawned(AActor* Actor);
+	void RecordAll(float Time);
+	int32 GetHistoryCapacity() const;
+
+	TMap<TObjectKey<AActor>, FTrack> Tracks;
+	FDelegateHandle ActorSpawnedHandle;
+	float NextRecordTime;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
 #include "DroneTypes.h"
 #include "DroneMarkingComponent.generated.h"
 
@@ -61,8 +62,13 @@ public:
 
 protected:
 	// Network RPCs
+	/** ClientTime is the lag-compensated view time the target was picked at */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_MarkTarget(AActor* Target);
+	void Server_MarkTarget(AActor* Target, float ClientTime);
+
+	/** Server re-runs the crosshair trace against actors rewound to ClientTime */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_MarkTargetInCrosshair(FVector_NetQuantize Start, FVector_NetQuantizeNormal Direction, float ClientTime);
 
 	UFUNCTION(Server, Reliable, WithValidation)
 	void Server_UnmarkTarget(AActor* Target);
@@ -84,9 +90,17 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Configuration")
 	FName MarkTag;
 
+	/** Largest accepted distance between a client's view origin and the drone's rewound camera */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Configuration")
+	float MaxViewOriginError;
+
 private:
 	void UpdateMarkedTargets(float DeltaTime);
+	void AddMark(AActor* Target);
+	bool GetViewPoint(FVector& OutStart, FVector& OutDirection) const;
 	AActor* GetTargetInCrosshair() const;
+	bool IsMarkableActor(const AActor* Actor) const;
 	bool IsTargetInRange(AActor* Target) const;
+	bool WasTargetInRange(AActor* Target, float ClientTime) const;
 	void ApplyMarkVisuals(AActor* Target, bool bMarked);
 };
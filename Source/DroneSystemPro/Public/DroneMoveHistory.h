@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DroneTypes.h"
+
+/**
+ * Fixed-capacity ring buffer keyed by a wrapping uint32 sequence number (InputID)
+ * Add, Find and Acknowledge are O(1); nothing is allocated or shifted after construction.
+ * Sequence gaps are allowed and simply leave empty slots.
+ */
+template<typename ElementType, uint32 Capacity>
+class TDroneSequenceBuffer
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "TDroneSequenceBuffer capacity must be a power of two");
+
+public:
+	TDroneSequenceBuffer()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		OldestID = 0;
+		NextID = 0;
+		for (uint32 Index = 0; Index < Capacity; ++Index)
+		{
+			bSlotValid[Index] = false;
+		}
+	}
+
+	bool IsEmpty() const { return OldestID == NextID; }
+
+	/** Number of sequence numbers spanned, including empty slots */
+	uint32 Num() const { return NextID - OldestID; }
+
+	static constexpr uint32 GetCapacity() { return Capacity; }
+
+	/** Oldest sequence number still held */
+	uint32 GetOldestID() const { return OldestID; }
+
+	/** One past the newest sequence number held */
+	uint32 GetNextID() const { return NextID; }
+
+	/**
+	 * Store an element for ID. IDs older than the buffered window are ignored;
+	 * newer IDs advance the window, evicting the oldest entries when full.
+	 * @return Stored element, or nullptr if ID was too old
+	 */
+	ElementType* Add(uint32 ID, const ElementType& Element)
+	{
+		if (IsEmpty())
+		{
+			OldestID = ID;
+			NextID = ID;
+		}
+		else if (IsBefore(ID, OldestID))
+		{
+			return nullptr;
+		}
+
+		// Advance the window, clearing any skipped slots; a jump past the whole window clears it at once
+		if (!IsBefore(ID, NextID) && ID - NextID >= Capacity)
+		{
+			for (uint32 Index = 0; Index < Capacity; ++Index)
+			{
+				bSlotValid[Index] = false;
+			}
+			NextID = ID + 1;
+		}
+
+		while (!IsBefore(ID, NextID))
+		{
+			bSlotValid[NextID & Mask] = false;
+			++NextID;
+		}
+
+		if (NextID - OldestID > Capacity)
+		{
+			OldestID = NextID - Capacity;
+		}
+
+		const uint32 Slot = ID & Mask;
+		Slots[Slot] = Element;
+		SlotIDs[Slot] = ID;
+		bSlotValid[Slot] = true;
+		return &Slots[Slot];
+	}
+
+	ElementType* Find(uint32 ID)
+	{
+		if (!Contains(ID))
+			return nullptr;
+
+		return &Slots[ID & Mask];
+	}
+
+	const ElementType* Find(uint32 ID) const
+	{
+		if (!Contains(ID))
+			return nullptr;
+
+		return &Slots[ID & Mask];
+	}
+
+	bool Contains(uint32 ID) const
+	{
+		if (IsBefore(ID, OldestID) || !IsBefore(ID, NextID))
+			return false;
+
+		const uint32 Slot = ID & Mask;
+		return bSlotValid[Slot] && SlotIDs[Slot] == ID;
+	}
+
+	/** Drop every entry up to and including ID */
+	void Acknowledge(uint32 ID)
+	{
+		if (IsBefore(ID, OldestID))
+			return;
+
+		OldestID = IsBefore(ID, NextID) ? ID + 1 : NextID;
+	}
+
+	/** Wrap-safe "A is older than B" */
+	static bool IsBefore(uint32 A, uint32 B)
+	{
+		return static_cast<int32>(A - B) < 0;
+	}
+
+private:
+	static constexpr uint32 Mask = Capacity - 1;
+
+	ElementType Slots[Capacity];
+	uint32 SlotIDs[Capacity];
+	bool bSlotValid[Capacity];
+
+	uint32 OldestID;
+	uint32 NextID;
+};
+
+/**
+ * Input sent for one client frame plus the state it was predicted to produce
+ */
+struct FDroneMoveRecord
+{
+	FDroneInputState Input;
+	FDroneMovementSnapshot PredictedSnapshot;
+};
@@ -5,8 +5,22 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "DroneTypes.h"
+#include "DroneFlightModel.h"
+#include "DroneMoveHistory.h"
+#include "DroneSnapshotInterpolator.h"
+#include "DroneWindSubsystem.h"
+#include "DroneInputRecording.h"
+#include "WorldCollision.h"
 #include "DroneMovementComponent.generated.h"
 
+class UDroneMovementWorldSubsystem;
+class UDroneWindSubsystem;
+class UDroneNetClockSubsystem;
+class UDroneVisionComponent;
+class UDroneObstacleFieldSubsystem;
+class UDroneTerrainSubsystem;
+class FDroneNetReplay;
+
 /**
  * Drone movement component with client prediction and server reconciliation
  * Handles physics-free smooth interpolation with high/low speed modes
@@ -21,8 +35,10 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 
 public:
 	// Input handling
@@ -32,6 +48,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Drone Movement")
 	void SetLookInput(FVector2D InInput);
 
+	/** On the owning client the change is predicted and carried by the input stream */
 	UFUNCTION(BlueprintCallable, Category = "Drone Movement")
 	void SetSpeedMode(EDroneSpeedMode NewMode);
 
@@ -39,10 +56,10 @@ public:
 	EDroneSpeedMode GetSpeedMode() const { return SpeedMode; }
 
 	UFUNCTION(BlueprintPure, Category = "Drone Movement")
-	FVector GetVelocity() const { return Velocity; }
+	FVector GetVelocity() const { return FlightState.Velocity; }
 
 	UFUNCTION(BlueprintPure, Category = "Drone Movement")
-	float GetCurrentSpeed() const { return Velocity.Size(); }
+	float GetCurrentSpeed() const { return FlightState.Velocity.Size(); }
 
 	UFUNCTION(BlueprintPure, Category = "Drone Movement")
 	FVector GetMovementInput() const { return MovementInput; }
@@ -54,24 +71,144 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Drone Movement")
 	UDroneConfig* GetDroneConfig() const { return DroneConfig; }
 
+	/** Client moves the server refused because they exceeded the time budget */
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	int32 GetRejectedMoveCount() const { return RejectedMoveCount; }
+
+	/** Times the owning client rewound and replayed after a server snapshot disagreed */
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	int32 GetCorrectionCount() const { return CorrectionCount; }
+
+	/** Server: refresh the replicated snapshot at most once per Interval seconds, 0 for every step */
+	void SetSnapshotInterval(float Interval);
+
+	/** Owning client: capture inputs and network conditions for FDroneNetReplay (also Drone.RecordInput 1) */
+	UFUNCTION(BlueprintCallable, Category = "Drone Movement|Recording")
+	void StartInputRecording();
+
+	/**
+	 * Stop capturing and write the recording to Saved/DroneRecordings
+	 * @return File written, or empty if nothing was recorded or the write failed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Drone Movement|Recording")
+	FString StopInputRecording();
+
+	UFUNCTION(BlueprintPure, Category = "Drone Movement|Recording")
+	bool IsRecordingInput() const { return InputRecording.IsValid(); }
+
+	/** Component offset to hide corrections; usually the drone mesh. Must be a child of the root. */
+	UFUNCTION(BlueprintCallable, Category = "Drone Movement")
+	void SetVisualComponent(USceneComponent* NewVisualComponent);
+
+	/** Jitter buffer health for simulated proxies */
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	FDroneInterpolationStats GetInterpolationStats() const { return ProxyInterpolator.GetStats(); }
+
+	/** Current flight model state (authoritative on server, predicted on owning client) */
+	const FDroneFlightState& GetFlightState() const { return FlightState; }
+
+	/** Flattened tuning values fed to the flight model */
+	const FDroneFlightConfig& GetFlightConfig() const { return FlightConfig; }
+
+	/** Pause or resume movement; use instead of toggling the tick, which the batch subsystem owns */
+	UFUNCTION(BlueprintCallable, Category = "Drone Movement")
+	void SetSimulationEnabled(bool bEnabled);
+
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	bool IsSimulationEnabled() const { return bSimulationEnabled; }
+
+	/** True while UDroneMovementWorldSubsystem simulates this drone */
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	bool IsBatched() const { return BatchIndex != INDEX_NONE; }
+
+	/** Wind velocity at the drone as of the last simulated step */
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	FVector GetWindVelocity() const { return CurrentWind; }
+
+	UFUNCTION(BlueprintCallable, Category = "Drone Movement")
+	void SetObstacleAvoidanceEnabled(bool bEnabled) { bUseObstacleAvoidance = bEnabled; }
+
+	/** Hold HeightAboveGround over terrain (ignored when disabling); vertical input is overridden while enabled */
+	UFUNCTION(BlueprintCallable, Category = "Drone Movement")
+	void SetAltitudeHold(bool bEnabled, float HeightAboveGround);
+
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	bool IsAltitudeHoldEnabled() const { return bAltitudeHold; }
+
+	/** Simulation detail assigned by the batch subsystem; Full when not batched */
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	EDroneMovementLOD GetMovementLOD() const { return MovementLOD; }
+
+	/** Locally driven authority drones can be simulated by the batch subsystem */
+	bool CanUseBatchedSimulation() const;
+
 protected:
 	// Movement simulation
 	void SimulateMovement(float DeltaTime, const FDroneInputState& Input);
-	void ApplyMovement(float DeltaTime);
+	void ApplyMovement();
+	void SyncFlightStateFromOwner();
+
+	// Collision response
+	void SlideAlongSurfaces(USceneComponent* Root, FVector Delta, const FQuat& Rotation);
+	void ClipToContactPlane(const FVector& Start, FVector& Delta);
+	void SetContact(const FHitResult& Hit);
+	void ConsumeAsyncSweep(USceneComponent* Root);
+	void RequestAsyncSweep(USceneComponent* Root);
+	void RefreshFlightConfig();
+	FDroneFlightInput MakeFlightInput(const FDroneInputState& Input) const;
+	FVector SampleWind(const FVector& Location);
+
+	/** Fill Input's obstacle distance and normal from the baked obstacle field */
+	void SampleObstacles(const FVector& Location, FDroneFlightInput& Input) const;
+
+	/** Replace Input's vertical axis with a climb rate towards the held height over the cached terrain */
+	void ApplyAltitudeHold(const FDroneFlightState& State, FDroneFlightInput& Input);
+
+	// Batched simulation
+	void UpdateBatchRegistration();
+	void FinishBatchedStep(const FDroneFlightState& NewState, float Timestamp);
+	void UpdateServerSnapshot(float Timestamp);
 
 	// Client prediction
 	void ClientTick(float DeltaTime);
+
+	/** Predict one input of StepTime and store it for sending and reconciliation */
+	void ClientStep(float StepTime);
 	void ServerTick(float DeltaTime);
+	void SimulatedProxyTick(float DeltaTime);
 
 	// Reconciliation
 	void ReconcileWithServer(const FDroneMovementSnapshot& ServerSnapshot);
+	float GetCorrectionTolerance(const FVector& AtVelocity) const;
+	void UpdateVisualOffset(float DeltaTime);
+
+	/** World offset from the root (newest step) to the state rendered between the last two steps */
+	void GetStepInterpolationOffset(FVector& OutLocation, FQuat& OutRotation) const;
+
+	/** Round trip and packet loss of the owning connection, for recordings */
+	FDroneNetConditions GetNetConditions() const;
+
+	// Server input stream
+	void SendInputPacket();
+	bool ConsumeNextServerInput(FDroneInputState& OutInput);
+	void SimulateClientMoves(float DeltaTime);
+
+	// Predicted discrete modes
+	/** Server: apply mode changes the client made since its previous input */
+	void ApplyClientModes(const FDroneInputState& Move);
+
+	/** Client: replace a mispredicted mode in pending inputs and local state with the server's */
+	void RollbackPredictedModes(EDroneSpeedMode PredictedSpeedMode, EDroneVisionMode PredictedVisionMode, const FDroneMovementSnapshot& InServerSnapshot);
+
+	EDroneVisionMode GetVisionMode() const;
 
 	// Network RPCs
-	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_SendInput(FDroneInputState Input);
+	/** Unreliable so a lost packet never stalls later ones; each packet repeats recent inputs */
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void Server_SendInputs(const FDroneInputPacket& Packet);
 
 	UFUNCTION(Client, Reliable)
-	void Client_ReceiveCorrection(FDroneMovementSnapshot ServerSnapshot);
+	void Client_ReceiveCorrection(FDroneMovementSnapshot InServerSnapshot);
 
 	// Replication
 	UPROPERTY(ReplicatedUsing=OnRep_ServerSnapshot)
@@ -80,16 +217,45 @@ protected:
 	UFUNCTION()
 	void OnRep_ServerSnapshot();
 
+	// Clock sync
+	/** Echo of the owning client's latest clock ping */
+	UPROPERTY(ReplicatedUsing=OnRep_ClockPong)
+	FDroneClockPong ClockPong;
+
+	UFUNCTION()
+	void OnRep_ClockPong();
+
+	/** Server time from the shared network clock */
+	float GetServerTime() const;
+
+	UPROPERTY(Transient)
+	UDroneNetClockSubsystem* NetClock;
+
+	/** Ping received but not yet echoed */
+	bool bHasPendingClockPing;
+	uint16 PendingClockPingTicks;
+	float PendingClockPingTime;
+
 	// Configuration
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Configuration")
 	UDroneConfig* DroneConfig;
 
 	// State
+	/** Skips the owner, which predicts it and reconciles against ServerSnapshot */
 	UPROPERTY(Replicated)
 	EDroneSpeedMode SpeedMode;
 
-	UPROPERTY()
-	FVector Velocity;
+	/** Vision component whose mode rides in the input stream */
+	UPROPERTY(Transient)
+	UDroneVisionComponent* VisionComponent;
+
+	/** Server: modes the owning client last requested, so server-side overrides hold until the next toggle */
+	EDroneSpeedMode LastClientSpeedMode;
+	EDroneVisionMode LastClientVisionMode;
+
+	FDroneFlightState FlightState;
+
+	FDroneFlightConfig FlightConfig;
 
 	UPROPERTY()
 	FVector MovementInput;
@@ -98,11 +264,8 @@ protected:
 	FVector2D LookInput;
 
 	// Client prediction state
-	UPROPERTY()
-	TArray<FDroneInputState> PendingInputs;
-
-	UPROPERTY()
-	TArray<FDroneMovementSnapshot> ClientSnapshots;
+	/** Unacknowledged inputs and their predicted results, indexed by InputID (~1.7s at 144Hz) */
+	TDroneSequenceBuffer<FDroneMoveRecord, 256> MoveHistory;
 
 	UPROPERTY()
 	uint32 NextInputID;
@@ -113,18 +276,206 @@ protected:
 	UPROPERTY()
 	float SendInterval;
 
-	// Environmental factors
+	/** How many of the newest inputs each packet repeats (capped at FDroneInputPacket::MaxInputs) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking", meta = (ClampMin = "1", ClampMax = "16"))
+	int32 RedundantInputCount;
+
+	// Server input state
+	/** Inputs received from the owning client that have not been consumed yet */
+	TDroneSequenceBuffer<FDroneInputState, 128> ServerInputBuffer;
+
+	uint32 LastConsumedInputID;
+
+	bool bHasConsumedInput;
+
+	/** Set by UDroneReplicationComponent while a bandwidth budget lowers the drone's update rate */
+	float SnapshotInterval;
+
+	float LastSnapshotTime;
+
+	/** Longest delta a single client move may simulate */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking")
+	float MaxMoveDeltaTime;
+
+	/** Cap on banked real time, bounds how far a client can burst after a stall */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking")
+	float MaxMoveTimeBudget;
+
+	/** Overdraft allowed for clock drift before moves are rejected */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking")
+	float MoveTimeTolerance;
+
+	/** Real time earned by the owning connection minus simulated move time spent */
+	float MoveTimeBudget;
+
+	int32 RejectedMoveCount;
+
+	// Correction smoothing
+	/** Position error always tolerated before correcting, in units */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking|Correction")
+	float CorrectionErrorThreshold;
+
+	/** Additional tolerance per unit of speed (seconds of travel), since fast drones drift further per frame */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking|Correction")
+	float CorrectionVelocityTolerance;
+
+	/** Time for the visual correction error to decay (about 95% gone after this) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking|Correction")
+	float CorrectionSmoothingTime;
+
+	/** Errors larger than this are snapped instead of smoothed */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking|Correction")
+	float MaxSmoothedCorrection;
+
+	int32 CorrectionCount;
+
+	/** Position error of the latest correction */
+	float LastCorrectionError;
+
+	// Fixed step simulation
+	/** Owning clients and locally driven drones simulate in fixed steps, one input per step, and render between the last two */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation")
+	bool bUseFixedTimestep;
+
+	/** Seconds per step, rounded to the 0.1ms input precision */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation", meta = (EditCondition = "bUseFixedTimestep", ClampMin = "0.001"))
+	float FixedTimestep;
+
+	/** Steps beyond this in one frame are dropped, so a hitch cannot snowball into longer frames */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation", meta = (EditCondition = "bUseFixedTimestep", ClampMin = "1"))
+	int32 MaxStepsPerFrame;
+
+	FDroneFixedStepAccumulator StepAccumulator;
+
+	/** State before the newest step, for render interpolation */
+	FDroneFlightState PreviousFlightState;
+
+	/** Whether the last tick simulated in fixed steps */
+	bool bInterpolateSteps;
+
 	UPROPERTY()
-	float WindMultiplier;
+	USceneComponent* VisualComponent;
+
+	/** Visual component's transform relative to the root, captured at BeginPlay */
+	FTransform VisualBaseTransform;
+
+	/** Remaining world-space visual error being decayed */
+	FVector VisualLocationOffset;
+	FQuat VisualRotationOffset;
+
+	// Simulated proxy interpolation
+	FDroneSnapshotInterpolator ProxyInterpolator;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking|Interpolation")
+	float InterpolationMinDelay;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking|Interpolation")
+	float InterpolationMaxDelay;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking|Interpolation")
+	float MaxExtrapolationTime;
 
+	// Collision response
+	/** Sweeps per move; each blocking hit slides the remainder along the surface */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Collision", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 MaxSlideIterations;
+
+	/** Gap kept from surfaces when depenetrating or clipping against a known contact */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Collision")
+	float CollisionSkinWidth;
+
+	/** How long a blocking contact constrains moves before a full sweep re-checks it */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Collision")
+	float ContactRetestInterval;
+
+	/** Steer away from geometry baked into obstacle field volumes; AI controllers enable this on possession */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Collision")
+	bool bUseObstacleAvoidance;
+
+	// Altitude hold
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Altitude Hold")
+	bool bAltitudeHold;
+
+	/** Target height above the ground */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Altitude Hold", meta = (ClampMin = "0.0"))
+	float HoldHeight;
+
+	/** Climb rate per unit of height error (1/s) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Altitude Hold", meta = (ClampMin = "0.0"))
+	float AltitudeHoldGain;
+
+	/** Seconds of horizontal travel to look ahead, so drones climb before rising ground */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Altitude Hold", meta = (ClampMin = "0.0"))
+	float AltitudeHoldLookahead;
+
+	/** Batched drones only: move unswept and resolve against async sweeps issued the frame before */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Performance")
+	bool bUseAsyncCollisionQueries;
+
+	/** Seconds of travel covered by each async sweep; must exceed one frame */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Performance", meta = (EditCondition = "bUseAsyncCollisionQueries"))
+	float AsyncSweepLookahead;
+
+	/** Last blocking surface, as a plane through the shape center at impact */
+	FVector ContactNormal;
+	FVector ContactPoint;
+	float ContactTime;
+	bool bHasContact;
+
+	FTraceHandle PendingSweep;
+
+	// Batched simulation
+	/** Let the world subsystem simulate this drone with all others when it is locally driven on the authority */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Performance")
+	bool bUseBatchedSimulation;
+
+	/**
+	 * Batched drones only: integrate in the Chaos async physics step at its fixed rate and
+	 * interpolate the results for presentation. Requires Tick Physics Async in the project's
+	 * physics settings; otherwise the drone stays in the regular batch.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Performance", meta = (EditCondition = "bUseBatchedSimulation"))
+	bool bUseAsyncPhysicsSimulation;
+
+	bool bSimulationEnabled;
+
+	/** Slot in UDroneMovementWorldSubsystem, INDEX_NONE when ticking on its own */
+	int32 BatchIndex;
+
+	/** Reduced and Rail tiers move without sweeping */
+	EDroneMovementLOD MovementLOD;
+
+	// Environmental factors
 	UPROPERTY()
 	float JammingMultiplier;
 
+	UPROPERTY(Transient)
+	UDroneWindSubsystem* WindSubsystem;
+
+	UPROPERTY(Transient)
+	UDroneObstacleFieldSubsystem* ObstacleField;
+
+	UPROPERTY(Transient)
+	UDroneTerrainSubsystem* TerrainSubsystem;
+
+	/** Wind grid corners around the drone; resampled only on cell changes */
+	FDroneWindSampleCache WindCache;
+
+	FVector CurrentWind;
+
 private:
+	friend class UDroneMovementWorldSubsystem;
+	friend class FDroneNetReplay;
+
+	/** Automation tests drive the server input path and collision response directly */
+	friend struct FDroneMovementTestAccess;
+
+	/** Inputs captured since StartInputRecording */
+	TUniquePtr<FDroneInputRecording> InputRecording;
+
+	/** Replaces Server_SendInputs while FDroneNetReplay carries this client's packets */
+	TFunction<void(const FDroneInputPacket&)> InputPacketOverride;
+
 	// Helper functions
 	float GetMaxSpeed() const;
-	float GetAcceleration() const;
-	FVector CalculateDesiredVelocity(const FVector& Input) const;
-	void ClampVelocity();
-	void UpdateRotation(float DeltaTime);
 };
@@ -0,0 +1,193 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DroneTypes.h"
+#include "DroneFlightModel.h"
+#include "DroneFlightBatch.h"
+#include "DroneMovementWorldSubsystem.generated.h"
+
+class UDroneMovementComponent;
+class USceneComponent;
+class FDroneAsyncFlightCallback;
+
+/**
+ * Game thread view of a drone integrated by FDroneAsyncFlightCallback
+ * Holds the two latest fixed step results, presented one step behind.
+ */
+struct FDroneAsyncFlightSlot
+{
+	uint32 DroneID = 0;
+
+	/** The physics thread has a state for this drone */
+	bool bRegistered = false;
+
+	/** Bumped whenever the game thread overrides the simulated state */
+	uint32 StateSequence = 0;
+
+	FDroneFlightState Previous;
+	FDroneFlightState Current;
+
+	/** Where the last interpolated state put the drone, before collision */
+	FVector PresentedLocation = FVector::ZeroVector;
+
+	/**
+	 * Adopt the game thread state if it moved away from the presented location (spawn,
+	 * teleport, collision); results stepped from the old state are discarded from then on
+	 */
+	void SyncFromGameThread(const FDroneFlightState& State, float Tolerance);
+
+	/** Take a physics thread result; false if it was stepped from a state since overridden */
+	bool ApplyResult(const FDroneFlightState& State, uint32 ResultSequence);
+};
+
+/**
+ * Simulates all locally driven drones (server AI, standalone) in one batched pass
+ * Registered components stop ticking individually. Each drone gets a significance
+ * score from its screen size to the nearest player and its AI state, which picks a
+ * movement LOD: Full tier drones are packed into an FDroneFlightBatch and integrated
+ * with the vector kernel across ParallelFor chunks; Reduced and Rail drones step at
+ * a lower rate without sweeps. Results are written back in one game thread loop.
+ *
+ * Drones with bUseAsyncPhysicsSimulation instead integrate on the physics thread at
+ * the async physics fixed rate. Their inputs are marshalled in each frame and their
+ * results interpolated for presentation; collision still resolves on the game thread
+ * and is fed back as a state correction.
+ */
+UCLASS(Config = Game)
+class DRONESYSTEMPRO_API UDroneMovementWorldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UDroneMovementWorldSubsystem();
+
+	// UTickableWorldSubsystem
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override { return Components.Num() > 0 || AsyncRemovedDrones.Num() > 0; }
+	virtual void Deinitialize() override;
+
+	/** Take over simulation of a component; its own tick is disabled while registered */
+	void RegisterComponent(UDroneMovementComponent* Component);
+
+	/** Hand simulation back to the component */
+	void UnregisterComponent(UDroneMovementComponent* Component);
+
+	/** Push new tuning values for a registered component */
+	void UpdateFlightConfig(const UDroneMovementComponent* Component, const FDroneFlightConfig& Config);
+
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	int32 GetNumBatchedDrones() const { return Components.Num(); }
+
+	/** Drones per tier as of the last significance update */
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	int32 GetNumDronesInLOD(EDroneMovementLOD LOD) const;
+
+	/** Drones integrated in the async physics step this frame */
+	UFUNCTION(BlueprintPure, Category = "Drone Movement")
+	int32 GetNumAsyncDrones() const { return AsyncDrones.Num(); }
+
+	/** Significance at or above which drones simulate every frame (approximate screen radius fraction) */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float FullSignificance;
+
+	/** Significance at or above which drones use the Reduced tier instead of rails */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float ReducedSignificance;
+
+	/** Fractional margin a score must clear past a threshold before the tier changes */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float SignificanceHysteresis;
+
+	/** Seconds between significance updates */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float SignificanceInterval;
+
+	/** Score multiplier for drones behind every viewer */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float OffscreenScale;
+
+	/** Score multiplier for drones following or marking a target */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float EngagedScale;
+
+	/** Seconds between Reduced tier steps */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float ReducedUpdateInterval;
+
+	/** Seconds between Rail tier steps */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float RailUpdateInterval;
+
+	/** Distance between the presented and resolved location that resyncs an async drone's physics state */
+	UPROPERTY(Config, EditAnywhere, Category = "Async Physics")
+	float AsyncCorrectionTolerance;
+
+private:
+	/** Automation tests drive the significance update and batch passes directly */
+	friend struct FDroneMovementTestAccess;
+
+	void RemoveAtSwap(int32 Index);
+	void UpdateSignificance();
+	EDroneMovementLOD SelectLOD(EDroneMovementLOD Current, float Score) const;
+	float GetUpdateInterval(EDroneMovementLOD LOD) const;
+	void GatherState(float DeltaTime);
+	void Integrate(float DeltaTime);
+	void WriteBack();
+
+	// Async physics simulation
+	bool EnsureAsyncCallback();
+	void ReleaseAsyncCallback();
+	void ReleaseAsyncSlot(int32 Index);
+	void PushAsyncInputs();
+	void ReceiveAsyncResults(float DeltaTime);
+	void WriteBackAsync(float Timestamp);
+
+	// Structure-of-arrays state, index aligned with Components
+	UPROPERTY()
+	TArray<TObjectPtr<UDroneMovementComponent>> Components;
+
+	UPROPERTY()
+	TArray<TObjectPtr<USceneComponent>> UpdatedComponents;
+
+	TArray<FDroneFlightConfig> Configs;
+	TArray<EDroneMovementLOD> LODs;
+	TArray<float> Significance;
+
+	/** Time since the drone was last stepped */
+	TArray<float> PendingTime;
+
+	/** Full tier drones due this frame, in Batch lane order */
+	TArray<int32> FullDrones;
+	FDroneFlightBatch Batch;
+
+	/** Substepping shared by the whole batch: finest step and most substeps of any drone */
+	float BatchMaxSubstepDeltaTime = 1.0f / 60.0f;
+	int32 BatchMaxSubsteps = 8;
+
+	/** Reduced and Rail drones due this frame, each with its own accumulated delta */
+	TArray<int32> CoarseDrones;
+	TArray<FDroneFlightState> CoarseStates;
+	TArray<FDroneFlightInput> CoarseInputs;
+	TArray<float> CoarseDeltaTimes;
+
+	float NextSignificanceTime = 0.0f;
+	int32 LODCounts[3] = { 0, 0, 0 };
+
+	/** Registered with the Chaos solver on first use, index aligned with Components */
+	FDroneAsyncFlightCallback* AsyncCallback = nullptr;
+	TArray<FDroneAsyncFlightSlot> AsyncSlots;
+
+	/** Async drones simulated this frame */
+	TArray<int32> AsyncDrones;
+
+	/** Drones the physics thread should forget on the next input */
+	TArray<uint32> AsyncRemovedDrones;
+
+	float AsyncFixedDeltaTime = 1.0f / 60.0f;
+	float TimeSinceAsyncResult = 0.0f;
+	bool bWarnedAsyncUnavailable = false;
+};
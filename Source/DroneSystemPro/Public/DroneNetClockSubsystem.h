@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DroneNetClockSubsystem.generated.h"
+
+/**
+ * Smoothed round-trip time and server clock offset from ping samples
+ * Round-trip time tracks every sample; the offset ignores samples whose round trip
+ * is well above the smoothed value, since queueing delay makes their paths asymmetric.
+ */
+struct DRONESYSTEMPRO_API FDroneClockEstimator
+{
+	/** Exponential smoothing weight once warmed up */
+	float Smoothing = 0.1f;
+
+	/** Samples averaged evenly before switching to exponential smoothing */
+	int32 WarmupSamples = 4;
+
+	/** Offset samples with a round trip above this multiple of the smoothed value are skipped */
+	float OutlierScale = 1.5f;
+
+	/** Absolute slack added to the outlier threshold, in seconds */
+	float OutlierSlack = 0.01f;
+
+	void Reset();
+
+	/**
+	 * @param RoundTrip	Measured round trip minus server hold time, clamped to zero by the caller
+	 * @param Offset	Server time minus local time, assuming symmetric paths
+	 * @return False if the offset was rejected as an outlier
+	 */
+	bool AddSample(float RoundTrip, float Offset);
+
+	int32 GetNumSamples() const { return NumSamples; }
+	float GetRoundTripTime() const { return RoundTripTime; }
+	float GetOffset() const { return ClockOffset; }
+
+private:
+	int32 NumSamples = 0;
+	int32 NumOffsetSamples = 0;
+	float RoundTripTime = 0.0f;
+	float ClockOffset = 0.0f;
+};
+
+/**
+ * Shared server clock for a world
+ * On the server this is simply the world time. Clients estimate the offset to it
+ * from ping samples that ride on the locally controlled drone's input packets and
+ * come back on its owner-only replication, falling back to the game state's coarse
+ * server time until enough samples have arrived, then blending to the estimate over SyncBlendTime.
+ *
+ * Snapshot, input and rewind timestamps are all in this time base.
+ */
+UCLASS(Config = Game)
+class DRONESYSTEMPRO_API UDroneNetClockSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UDroneNetClockSubsystem();
+
+	/** Current server time as best known on this machine */
+	UFUNCTION(BlueprintPure, Category = "Network Clock")
+	float GetServerTime() const;
+
+	/** GetServerTime for World, or its world time if the subsystem is missing */
+	static float GetServerTime(const UWorld* World);
+
+	/** Smoothed round trip to the server; zero on the server */
+	UFUNCTION(BlueprintPure, Category = "Network Clock")
+	float GetRoundTripTime() const { return Estimator.GetRoundTripTime(); }
+
+	/** True once the server time comes from ping samples rather than the game state */
+	UFUNCTION(BlueprintPure, Category = "Network Clock")
+	bool IsSynchronized() const;
+
+	/** Local clock that ping samples are measured against */
+	float GetLocalTime() const;
+
+	/** Client: returns true at most once per PingInterval; the caller attaches a ping to its next packet */
+	bool ConsumePingSlot();
+
+	/**
+	 * Client: feed back an echoed ping
+	 * @param ClientSendTime	Local time the ping left, widened from its wire ticks
+	 * @param ServerSendTime	Server time the echo left
+	 * @param ServerHoldTime	Time the server held the ping before echoing it
+	 */
+	void AddPingSample(float ClientSendTime, float ServerSendTime, float ServerHoldTime);
+
+	/** Seconds between ping samples */
+	UPROPERTY(Config, EditAnywhere, Category = "Network Clock")
+	float PingInterval;
+
+	/** Exponential smoothing weight for round trip and offset */
+	UPROPERTY(Config, EditAnywhere, Category = "Network Clock")
+	float Smoothing;
+
+	/** Samples needed before the estimate replaces the game state's server time */
+	UPROPERTY(Config, EditAnywhere, Category = "Network Clock")
+	int32 MinSamplesForSync;
+
+	/** Seconds over which the server time moves from the game state's to the estimate once synchronized */
+	UPROPERTY(Config, EditAnywhere, Category = "Network Clock")
+	float SyncBlendTime;
+
+private:
+	FDroneClockEstimator Estimator;
+	float NextPingTime;
+
+	/** Local time the estimate took over */
+	float SyncTime;
+};
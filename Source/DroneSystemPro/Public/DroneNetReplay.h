@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DroneInputRecording.h"
+
+class AActor;
+class UDroneConfig;
+
+/**
+ * How FDroneNetReplay simulates the network
+ */
+struct DRONESYSTEMPRO_API FDroneReplaySettings
+{
+	/** Use the recording's round trip and loss; otherwise Conditions applies throughout */
+	bool bUseRecordedConditions = true;
+
+	FDroneNetConditions Conditions;
+
+	/** Extra one-way delay per packet, uniform in [0, Jitter] seconds; packets may reorder */
+	float Jitter = 0.0f;
+
+	/** Server frame rate; snapshots go out at the drone's NetUpdateFrequency */
+	float ServerTickRate = 60.0f;
+
+	/** Seeds packet loss and jitter so runs are repeatable */
+	int32 Seed = 0;
+
+	/** Drone spawned on both sides; ADroneBase when unset */
+	TSubclassOf<AActor> DroneClass;
+
+	/** Applied to both drones when set; a default UDroneConfig is used if the class has none */
+	UDroneConfig* DroneConfig = nullptr;
+};
+
+/**
+ * Prediction quality and cost of one replay
+ */
+struct DRONESYSTEMPRO_API FDroneReplayReport
+{
+	static constexpr int32 NumCorrectionBuckets = 7;
+
+	/** Upper edge of a correction histogram bucket in units; the last bucket is unbounded */
+	static float GetBucketUpperEdge(int32 Bucket);
+
+	float SimulatedTime = 0.0f;
+	int32 NumFrames = 0;
+
+	/** Reconciliations that rewound and replayed the client, including mode rollbacks */
+	int32 NumCorrections = 0;
+
+	/** Client position error at each correction */
+	int32 CorrectionHistogram[NumCorrectionBuckets] = {};
+	float MaxCorrectionError = 0.0f;
+
+	/** Client moves the server refused for exceeding the time budget */
+	int32 NumRejectedMoves = 0;
+
+	/** Client to server input packets; serialized payload only, packet and bunch headers are not counted */
+	int64 BytesSent = 0;
+	int32 InputPacketsSent = 0;
+	int32 InputPacketsLost = 0;
+
+	/** Server to client snapshots, counted the same way */
+	int64 BytesReceived = 0;
+	int32 SnapshotsSent = 0;
+	int32 SnapshotsLost = 0;
+
+	/** Wall time the replay took */
+	double ReplaySeconds = 0.0;
+
+	float GetCorrectionsPerMinute() const;
+	FString ToString() const;
+};
+
+/**
+ * Headless replay of a recorded client session through UDroneMovementComponent
+ * A client and a server drone are spawned into two private game worlds and ticked
+ * in lockstep: the client at the recorded frame deltas, the server at ServerTickRate.
+ * Input packets and snapshots are net serialized, delayed, dropped and delivered
+ * straight into the components, so everything from prediction to reconciliation runs
+ * the shipping code. Runs are deterministic for a given recording and settings.
+ */
+class DRONESYSTEMPRO_API FDroneNetReplay
+{
+public:
+	/** Requires GEngine; returns an empty report for an empty recording */
+	static FDroneReplayReport Run(const FDroneInputRecording& Recording, const FDroneReplaySettings& Settings = FDroneReplaySettings());
+};
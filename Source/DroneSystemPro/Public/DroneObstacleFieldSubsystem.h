@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DroneObstacleFieldSubsystem.generated.h"
+
+class ADroneObstacleFieldVolume;
+
+/**
+ * Sparse signed distance field stored as 8x8x8 bricks of 8-bit distances
+ * Distances are clamped to MaxDistance and are negative inside geometry. Bricks that
+ * are entirely beyond MaxDistance (or deeper than it inside) are not stored, so open
+ * air costs one table entry per brick. Lookups are O(1) with no traces.
+ */
+USTRUCT()
+struct DRONESYSTEMPRO_API FDroneDistanceField
+{
+	GENERATED_BODY()
+
+	static constexpr int32 BrickSize = 8;
+	static constexpr int32 BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+	/** Brick table entries for bricks without stored voxels */
+	static constexpr int32 EmptyBrick = -1;
+	static constexpr int32 SolidBrick = -2;
+
+	/**
+	 * Bake from a voxel occupancy grid
+	 * @param InOrigin		World location of the center of voxel (0, 0, 0)
+	 * @param InResolution	Voxels per axis
+	 * @param InVoxelSize	Voxel edge length
+	 * @param InMaxDistance	Distances are clamped to +/- this
+	 * @param Solid			Occupancy, indexed X + Y * ResX + Z * ResX * ResY
+	 */
+	void Build(const FVector& InOrigin, const FIntVector& InResolution, float InVoxelSize, float InMaxDistance, const TBitArray<>& Solid);
+
+	void Reset();
+
+	/**
+	 * Trilinear distance at Location, MaxDistance outside the baked bounds
+	 * @param OutGradient	Optional; points away from the nearest surface, zero outside the bounds
+	 */
+	float Sample(const FVector& Location, FVector* OutGradient = nullptr) const;
+
+	bool IsValid() const { return BrickTable.Num() > 0; }
+
+	/** World space box covered by voxel centers */
+	FBox GetBounds() const;
+
+	float GetMaxDistance() const { return MaxDistance; }
+	int32 GetNumBricks() const { return BrickTable.Num(); }
+	int32 GetNumStoredBricks() const { return BrickData.Num() / BrickVoxels; }
+	SIZE_T GetAllocatedSize() const { return BrickTable.GetAllocatedSize() + BrickData.GetAllocatedSize(); }
+
+private:
+	/** Dequantized distance of a voxel; coordinates must be inside Resolution */
+	float GetVoxel(int32 X, int32 Y, int32 Z) const;
+
+	UPROPERTY()
+	FVector Origin = FVector::ZeroVector;
+
+	UPROPERTY()
+	FIntVector Resolution = FIntVector::ZeroValue;
+
+	UPROPERTY()
+	FIntVector BrickCounts = FIntVector::ZeroValue;
+
+	UPROPERTY()
+	float VoxelSize = 100.0f;
+
+	UPROPERTY()
+	float MaxDistance = 500.0f;
+
+	/** Index into BrickData in bricks, or EmptyBrick / SolidBrick */
+	UPROPERTY()
+	TArray<int32> BrickTable;
+
+	/** Stored bricks, X fastest; 0 = -MaxDistance, 255 = +MaxDistance */
+	UPROPERTY()
+	TArray<uint8> BrickData;
+};
+
+/**
+ * Obstacle distance lookups for a world
+ * Obstacle field volumes carry their baked field with the level and register at
+ * BeginPlay; drones query the nearest surface distance and direction here.
+ */
+UCLASS()
+class DRONESYSTEMPRO_API UDroneObstacleFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterVolume(ADroneObstacleFieldVolume* Volume);
+	void UnregisterVolume(ADroneObstacleFieldVolume* Volume);
+
+	/**
+	 * Distance to the nearest baked obstacle
+	 * @param OutNormal	Unit direction away from that obstacle, zero when none is near
+	 * @return MAX_flt outside every volume
+	 */
+	float SampleDistance(const FVector& Location, FVector& OutNormal) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Obstacle Field")
+	float GetObstacleDistance(FVector Location) const;
+
+	bool HasVolumes() const { return Volumes.Num() > 0; }
+
+private:
+	TArray<TWeakObjectPtr<ADroneObstacleFieldVolume>> Volumes;
+};
@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "DroneObstacleFieldSubsystem.h"
+#include "DroneObstacleFieldVolume.generated.h"
+
+class UBoxComponent;
+
+/**
+ * Placeable box whose static geometry is baked into a sparse signed distance field
+ * Bake in the editor with Bake Field; the field is saved with the level and registered
+ * with UDroneObstacleFieldSubsystem at BeginPlay, so drones steer around geometry
+ * without tracing. The box is axis aligned; actor rotation is ignored.
+ */
+UCLASS(Blueprintable)
+class DRONESYSTEMPRO_API ADroneObstacleFieldVolume : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADroneObstacleFieldVolume();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	/** Voxelize WorldStatic geometry inside the box and rebuild the field */
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Obstacle Field")
+	void BakeField();
+
+	const FDroneDistanceField& GetField() const { return Field; }
+
+protected:
+	// Components
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UBoxComponent* FieldBounds;
+
+	// Configuration
+	/** Voxel edge length; thin geometry below this may be missed */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Obstacle Field", meta = (ClampMin = "10.0"))
+	float VoxelSize;
+
+	/** Distances are stored up to this far from surfaces; keep it above the drones' avoidance distance */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Obstacle Field", meta = (ClampMin = "10.0"))
+	float MaxDistance;
+
+	/** Bakes needing more voxels than this are refused; raise VoxelSize instead */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Obstacle Field")
+	int32 MaxVoxels;
+
+	/** Baked field, serialized with the level */
+	UPROPERTY()
+	FDroneDistanceField Field;
+};
@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+/**
+ * Push model marks on dormant actors are not sent until the actor wakes
+ * DRONE_MARK_PROPERTY_DIRTY reports every mark here so the change goes out.
+ */
+struct DRONESYSTEMPRO_API FDroneNetDormancy
+{
+	/** Wake a drone through its UDroneReplicationComponent, or flush any other dormant owner of Object */
+	static void NotifyPropertyDirty(const UObject* Object);
+};
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Dirty marks made through DRONE_MARK_PROPERTY_DIRTY, kept while a test has recording on
+ * Lets tests catch push model properties that change without being marked.
+ */
+struct DRONESYSTEMPRO_API FDronePushModelTracker
+{
+	static void SetEnabled(bool bEnabled);
+	static void Reset();
+	static void NotifyMarked(const UObject* Object, FName PropertyName);
+	static bool WasMarked(const UObject* Object, FName PropertyName);
+};
+
+/** Mark without waking a dormant owner, for values that change continuously; the latest is sent when it next wakes */
+#define DRONE_MARK_PROPERTY_DIRTY_NO_WAKE(ClassName, PropertyName, Object) \
+	do \
+	{ \
+		MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object); \
+		FDronePushModelTracker::NotifyMarked(Object, GET_MEMBER_NAME_CHECKED(ClassName, PropertyName)); \
+	} while (0)
+
+#else
+
+#define DRONE_MARK_PROPERTY_DIRTY_NO_WAKE(ClassName, PropertyName, Object) MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object)
+
+#endif
+
+#define DRONE_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object) \
+	do \
+	{ \
+		DRONE_MARK_PROPERTY_DIRTY_NO_WAKE(ClassName, PropertyName, Object); \
+		FDroneNetDormancy::NotifyPropertyDirty(Object); \
+	} while (0)
@@ -7,9 +7,64 @@
 #include "DroneTypes.h"
 #include "DroneReplicationComponent.generated.h"
 
+class UNetConnection;
+
+/**
+ * Bytes per second, smoothed over SmoothingTime
+ * Bytes are added as they are sent and folded into the rate on Update.
+ */
+struct DRONESYSTEMPRO_API FDroneBandwidthMeter
+{
+	void AddBytes(int32 Bytes);
+	void Update(float DeltaTime, float SmoothingTime);
+
+	float GetBytesPerSecond() const { return BytesPerSecond; }
+	int64 GetTotalBytes() const { return TotalBytes; }
+
+private:
+	int64 PendingBytes = 0;
+	int64 TotalBytes = 0;
+	float BytesPerSecond = 0.0f;
+};
+
+/**
+ * Replication detail scale in [MinScale, 1] that keeps usage under a byte rate limit
+ * Over the limit the scale drops in proportion at once, then holds while the smoothed
+ * rate catches up; a saturated connection halves it. Below Headroom of the limit it
+ * recovers linearly.
+ */
+struct DRONESYSTEMPRO_API FDroneBandwidthController
+{
+	float MinScale = 0.1f;
+
+	/** Scale regained per second with headroom */
+	float RecoveryRate = 0.2f;
+
+	/** Usage below this fraction of the limit counts as headroom */
+	float Headroom = 0.85f;
+
+	/** Seconds after a decrease before the next proportional decrease */
+	float HoldTime = 1.0f;
+
+	/**
+	 * @param Limit Bytes per second; 0 is unlimited
+	 * @return The new scale
+	 */
+	float Update(float BytesPerSecond, float Limit, float DeltaTime, bool bSaturated);
+
+	float GetScale() const { return Scale; }
+
+private:
+	float Scale = 1.0f;
+	float HoldRemaining = 0.0f;
+};
+
 /**
  * Handles relevancy, prioritization, delta compression, and bandwidth caps
- * Optimizes network traffic for drone systems
+ * Optimizes network traffic for drone systems. Bytes sent for the drone are metered per
+ * connection by UDroneActorChannel; a controller per connection then scales the drone's
+ * update rate, snapshot rate and thermal detail to stay under BandwidthLimit, and under
+ * BadLinkBandwidthCap on slow or lossy connections.
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class DRONESYSTEMPRO_API UDroneReplicationComponent : public UActorComponent
@@ -21,6 +76,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 public:
@@ -31,21 +87,62 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Replication")
 	bool IsRelevantTo(AActor* ViewingActor) const;
 
+	/** Distance and team relevancy for a viewer DistanceSquared away; ownership is left to the caller */
+	bool IsRelevantAtDistance(float DistanceSquared, const AActor* Viewer) const;
+
 	// Priority control
 	UFUNCTION(BlueprintPure, Category = "Replication")
 	float GetReplicationPriority(AActor* ViewingActor) const;
 
+	/**
+	 * Priority multiplier for a viewer at ViewLocation looking along ViewDirection (unit length)
+	 * Up to 1 + DistancePriorityScale close by, falling off with squared distance, then
+	 * weighted by the view cone and team. Without the owner bonus.
+	 */
+	float GetViewerPriorityScale(const FVector& ViewLocation, const FVector& ViewDirection, const AActor* Viewer) const;
+
+	/** Viewer, its pawn or its controller is on the drone's team; actors without a team never are */
+	bool IsTeammate(const AActor* Viewer) const;
+
 	// Bandwidth optimization
+	/** Bytes per second this drone may send each connection; 0 is unlimited */
 	UFUNCTION(BlueprintCallable, Category = "Replication")
 	void SetBandwidthLimit(float Limit);
 
+	/** Bytes per second sent for this drone, all connections together */
 	UFUNCTION(BlueprintPure, Category = "Replication")
 	float GetCurrentBandwidthUsage() const { return CurrentBandwidthUsage; }
 
+	/** Detail the drone replicates at for its best served connection, 1 is unthrottled */
+	UFUNCTION(BlueprintPure, Category = "Replication")
+	float GetReplicationScale() const { return ReplicationScale; }
+
+	/** Called from the send path with the payload of each bunch sent for the drone */
+	void RecordBytesSent(UNetConnection* Connection, int32 Bytes);
+
+	float GetConnectionBandwidthUsage(const UNetConnection* Connection) const;
+	float GetConnectionScale(const UNetConnection* Connection) const;
+	int64 GetTotalBytesSent() const { return TotalMeter.GetTotalBytes(); }
+
+	// Dormancy
+	/** Whether this component has put the drone to sleep */
+	UFUNCTION(BlueprintPure, Category = "Replication")
+	bool IsNetDormant() const { return bNetDormant; }
+
+	/** Wake the drone so a replicated change is sent; it may sleep again after the dormancy delay */
+	void WakeFromDormancy();
+
+	/** Drones put to sleep by their replication component in World */
+	static int32 GetNumDormantDrones(const UWorld* World);
+
 	// Configuration
 	UFUNCTION(BlueprintCallable, Category = "Replication")
 	void SetDroneConfig(UDroneConfig* NewConfig);
 
+	float GetBasePriority() const { return BasePriority; }
+	float GetDistancePriorityScale() const { return DistancePriorityScale; }
+	float GetMaxRelevancyDistance() const { return MaxRelevancyDistance; }
+
 protected:
 	// Configuration
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Configuration")
@@ -60,6 +157,70 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Configuration")
 	float MaxRelevancyDistance;
 
+	/** Half angle in degrees of the view cone drones are favored in */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Priority", meta = (ClampMin = "1", ClampMax = "90"))
+	float ViewConeHalfAngle;
+
+	/** Priority multiplier inside the viewer's view cone */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Priority")
+	float InViewPriorityScale;
+
+	/** Priority multiplier behind the viewer */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Priority")
+	float BehindViewerPriorityScale;
+
+	/** Within this distance the view direction is ignored */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Priority")
+	float ViewIndependentDistance;
+
+	/** Priority multiplier for viewers on the drone's team */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Priority")
+	float TeammatePriorityScale;
+
+	/** Teammates keep the drone relevant out to this multiple of MaxRelevancyDistance */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Priority", meta = (ClampMin = "1"))
+	float TeammateRelevancyScale;
+
+	/** Per-connection byte rate limit on slow or lossy links; 0 disables the cap */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bandwidth")
+	float BadLinkBandwidthCap;
+
+	/** Connections with a lower net speed (bytes per second) are bad links */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bandwidth")
+	int32 BadLinkNetSpeed;
+
+	/** Connections losing more of their outgoing packets (0-1) are bad links */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bandwidth")
+	float BadLinkPacketLoss;
+
+	/** Floor for the adapted NetUpdateFrequency, so throttled drones still move */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bandwidth")
+	float MinNetUpdateFrequency;
+
+	/** Seconds between controller updates */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bandwidth")
+	float BandwidthControlInterval;
+
+	/** Seconds the usage rate is smoothed over */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bandwidth")
+	float BandwidthSmoothingTime;
+
+	/** Put docked, inactive and idle AI drones to sleep and wake them when replicated state changes */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dormancy")
+	bool bAutoDormancy;
+
+	/** Seconds a docked or inactive drone stays awake after its last change */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dormancy")
+	float ParkedDormancyDelay;
+
+	/** Seconds a drone without a player must hover still before it sleeps */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dormancy")
+	float IdleDormancyDelay;
+
+	/** Speed below which a hovering drone counts as still */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dormancy")
+	float IdleSpeedThreshold;
+
 	// State
 	UPROPERTY()
 	float BandwidthLimit;
@@ -70,7 +231,45 @@ protected:
 	UPROPERTY()
 	float LastRelevancyUpdate;
 
+	UPROPERTY()
+	float ReplicationScale;
+
 private:
 	void OptimizeNetworkSettings();
 	void ApplyRelevancySettings();
+
+	/** Squared thresholds for the per-viewer checks, refreshed with the relevancy settings */
+	void CacheViewerThresholds();
+
+	/** Count down to dormancy while the drone is parked or idle, wake it otherwise */
+	void UpdateDormancy(float DeltaTime);
+	bool CanBeDormant(bool& bOutParked) const;
+	void SetNetDormant(bool bDormant);
+
+	/** Step every connection's controller and apply the resulting detail */
+	void UpdateBandwidthControl(float DeltaTime);
+	void ApplyReplicationScale(float Scale);
+	float GetUpdateRateForScale(float Scale) const;
+	float GetConnectionLimit(UNetConnection* Connection) const;
+
+	struct FConnectionBandwidth
+	{
+		FDroneBandwidthMeter Meter;
+		FDroneBandwidthController Controller;
+	};
+
+	TMap<TWeakObjectPtr<UNetConnection>, FConnectionBandwidth> Connections;
+	FDroneBandwidthMeter TotalMeter;
+	float BaseNetUpdateFrequency;
+	float TimeSinceControlUpdate;
+
+	bool bNetDormant;
+
+	/** Seconds the drone has been eligible for dormancy without a replicated change */
+	float DormancyTimer;
+
+	float MaxRelevancyDistanceSquared;
+	float TeammateRelevancyDistanceSquared;
+	float ViewIndependentDistanceSquared;
+	float ViewConeCosSquared;
 };
@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "DroneReplicationGraph.generated.h"
+
+class ADroneBase;
+class UDroneReplicationComponent;
+
+/**
+ * Actors owned by a connection, gathered for that connection only
+ * Holds player drones and bOnlyRelevantToOwner actors. Lists are rebuilt once per
+ * frame from each actor's net connection, so possession changes need no events.
+ */
+UCLASS()
+class DRONESYSTEMPRO_API UDroneReplicationGraphNode_OwnerRelevant : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UDroneReplicationGraphNode_OwnerRelevant();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	TArray<AActor*> Actors;
+	TMap<UNetConnection*, FActorRepListRefView> ConnectionLists;
+};
+
+/**
+ * Docked and inactive drones in a coarse static spatial hash
+ * Parked drones barely move, so they are binned once instead of being re-sorted by the
+ * grid every frame. Each cell is a dormancy node: once a drone is dormant on a connection
+ * it drops out of that connection's lists until it is flushed.
+ */
+UCLASS()
+class DRONESYSTEMPRO_API UDroneReplicationGraphNode_ParkedDrones : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UDroneReplicationGraphNode_ParkedDrones();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	/** Dormancy cells follow the actor's flush events, so actors come in with their global info */
+	void AddActor_Dormancy(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo);
+	void RemoveActor_Dormancy(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo);
+
+	int32 Num() const { return ActorCells.Num(); }
+
+	float CellSize;
+
+	/** Cells within this distance of a viewer are gathered; per-actor cull distances still apply */
+	float GatherDistance;
+
+private:
+	FIntPoint GetCell(const FVector& Location) const;
+
+	UPROPERTY()
+	TMap<FIntPoint, UReplicationGraphNode_DormancyNode*> Cells;
+
+	TMap<AActor*, FIntPoint> ActorCells;
+};
+
+/**
+ * Replication graph for drone-heavy servers
+ * Active drones and other spatial actors go in a 2D grid; each connection's own drone and
+ * owner-only actors go in an owner node; docked and inactive drones move to the parked
+ * node. Per drone cull distance, distance priority and update period come from its
+ * UDroneReplicationComponent. Enable it with
+ * [/Script/OnlineSubsystemUtils.IpNetDriver] ReplicationDriverClassName="/Script/DroneSystemPro.DroneReplicationGraph"
+ */
+UCLASS(Transient, Config = Engine)
+class DRONESYSTEMPRO_API UDroneReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UDroneReplicationGraph();
+
+	/** The graph driving World's net driver, if it is this class */
+	static UDroneReplicationGraph* Get(const UWorld* World);
+
+	// UReplicationGraph
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+	/** Re-read a drone's replication settings after its config or NetUpdateFrequency changed */
+	void RefreshDroneSettings(ADroneBase* Drone);
+
+	/** Replicate a drone to one connection at its own rate, e.g. to throttle a bad link */
+	void SetConnectionUpdateRate(ADroneBase* Drone, UNetConnection* Connection, float UpdateRate);
+
+	int32 GetNumParkedDrones() const { return ParkedNode ? ParkedNode->Num() : 0; }
+
+	UPROPERTY(Config)
+	float GridCellSize;
+
+	/** Lowest world X and Y covered by grid cells */
+	UPROPERTY(Config)
+	float SpatialBias;
+
+	/** Parked drone hash cell size; larger than the grid since parked drones never move between cells */
+	UPROPERTY(Config)
+	float ParkedCellSize;
+
+private:
+	/** Automation tests drive the graph without a net driver */
+	friend struct FDroneReplicationGraphTestAccess;
+
+	struct FTrackedDrone
+	{
+		ADroneBase* Drone;
+		bool bParked;
+	};
+
+	static bool IsParked(const ADroneBase* Drone);
+	void ApplyDroneSettings(const ADroneBase* Drone, const UDroneReplicationComponent* Replication, FGlobalActorReplicationInfo& GlobalInfo) const;
+	void UpdateParkedDrones();
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	UPROPERTY()
+	UDroneReplicationGraphNode_OwnerRelevant* OwnerNode;
+
+	UPROPERTY()
+	UDroneReplicationGraphNode_ParkedDrones* ParkedNode;
+
+	TArray<FTrackedDrone> Drones;
+};
@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DroneTypes.h"
+#include "DroneFlightModel.h"
+
+/**
+ * Tuning for simulated proxy interpolation
+ */
+struct DRONESYSTEMPRO_API FDroneInterpolationSettings
+{
+	/** Render delay bounds, in seconds */
+	float MinDelay = 0.05f;
+	float MaxDelay = 0.3f;
+
+	/** Extra delay per second of measured jitter */
+	float JitterMultiplier = 2.0f;
+
+	/** How fast the delay may change, in seconds per second, to avoid visible time warps */
+	float DelayAdjustRate = 0.1f;
+
+	/** How far past the newest snapshot we will extrapolate before holding */
+	float MaxExtrapolationTime = 0.25f;
+};
+
+/**
+ * Jitter buffer for a simulated proxy
+ * Buffers server snapshots, renders them a small adaptive delay in the past and
+ * blends between them with Hermite curves using the replicated velocity. All times
+ * are in the shared server time base (UDroneNetClockSubsystem), so render times can
+ * be compared with every other server timestamp on this machine.
+ */
+class DRONESYSTEMPRO_API FDroneSnapshotInterpolator
+{
+public:
+	static constexpr int32 Capacity = 16;
+
+	FDroneSnapshotInterpolator();
+
+	void Reset();
+
+	/**
+	 * Buffer a snapshot received from the server
+	 * @param Snapshot		Replicated snapshot; Timestamp is server time
+	 * @param ReceiveTime	Estimated server time when it arrived
+	 */
+	void AddSnapshot(const FDroneMovementSnapshot& Snapshot, float ReceiveTime);
+
+	/**
+	 * Evaluate the proxy state at an estimated server time
+	 * @return False until at least one snapshot has been received
+	 */
+	bool Sample(float ServerTime, float DeltaTime, FDroneFlightState& OutState);
+
+	const FDroneInterpolationStats& GetStats() const { return Stats; }
+
+	FDroneInterpolationSettings Settings;
+
+private:
+	const FDroneMovementSnapshot& GetSnapshot(int32 Index) const { return Snapshots[(Head + Index) % Capacity]; }
+
+	static FDroneFlightState Hermite(const FDroneMovementSnapshot& From, const FDroneMovementSnapshot& To, float Alpha);
+
+	FDroneMovementSnapshot Snapshots[Capacity];
+	int32 Head;
+	int32 Count;
+
+	/** Expected spacing of snapshots, from recent arrivals */
+	float AverageInterval;
+
+	float LastReceiveTime;
+	float CurrentDelay;
+
+	FDroneInterpolationStats Stats;
+};
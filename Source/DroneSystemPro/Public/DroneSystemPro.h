@@ -4,6 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
+
+DRONESYSTEMPRO_API DECLARE_LOG_CATEGORY_EXTERN(LogDroneSystem, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("DroneSystem"), STATGROUP_DroneSystem, STATCAT_Advanced);
 
 /**
  * DroneSystemPro Runtime Module
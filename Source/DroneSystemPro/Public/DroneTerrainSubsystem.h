@@ -0,0 +1,120 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DroneTerrainSubsystem.generated.h"
+
+/**
+ * Downsampled ground heights in square tiles, built on first use
+ * Samples sit on a global grid SampleSpacing apart; heights between them are
+ * bilinear. Least recently used tiles are dropped past MaxTiles.
+ */
+class DRONESYSTEMPRO_API FDroneHeightfieldCache
+{
+public:
+	/** Returns the ground height at a world XY, or NoGround */
+	using FGroundSampler = TFunctionRef<float(const FVector2D&)>;
+
+	/** Stored where a sample found nothing to stand on */
+	static constexpr float NoGround = -MAX_flt;
+
+	explicit FDroneHeightfieldCache(float InSampleSpacing = 400.0f, int32 InTileResolution = 16, int32 InMaxTiles = 512);
+
+	/** Drop every tile and change the layout */
+	void Reset(float InSampleSpacing, int32 InTileResolution, int32 InMaxTiles);
+
+	/**
+	 * Ground height below Location, building missing tiles through Sampler
+	 * Where some surrounding samples have no ground the highest valid one is used.
+	 * @return False if there is no ground around Location
+	 */
+	bool GetHeight(const FVector2D& Location, FGroundSampler Sampler, float& OutHeight);
+
+	/** Tile containing a world XY */
+	FIntPoint GetTileCoord(const FVector2D& Location) const;
+
+	int32 GetNumTiles() const { return Tiles.Num(); }
+	float GetTileSize() const { return SampleSpacing * TileResolution; }
+
+private:
+	struct FTile
+	{
+		TArray<float> Heights;
+		uint64 LastUsed = 0;
+	};
+
+	/** Height of one grid sample, building its tile if needed */
+	float GetSample(int32 SampleX, int32 SampleY, FGroundSampler Sampler);
+	FTile& FindOrBuildTile(const FIntPoint& Coord, FGroundSampler Sampler);
+	void EvictLeastRecentlyUsed();
+
+	TMap<FIntPoint, FTile> Tiles;
+	float SampleSpacing;
+	int32 TileResolution;
+	int32 MaxTiles;
+	uint64 UseCounter;
+};
+
+/**
+ * Shared terrain height cache for a world
+ * Drones ask for ground height here instead of tracing down every frame; each tile
+ * costs TileResolution^2 downward traces once and is reused by every drone over it.
+ * Traces hit WorldStatic geometry, which includes landscape collision. Streaming a
+ * level in or out invalidates the cache.
+ */
+UCLASS(Config = Game)
+class DRONESYSTEMPRO_API UDroneTerrainSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UDroneTerrainSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Highest static surface below Location
+	 * @return False over empty space
+	 */
+	bool GetGroundHeight(const FVector& Location, float& OutHeight);
+
+	/** Height above the ground below Location; world Z over empty space */
+	UFUNCTION(BlueprintCallable, Category = "Terrain")
+	float GetHeightAboveGround(FVector Location);
+
+	/** Drop all cached tiles, e.g. after moving static geometry */
+	UFUNCTION(BlueprintCallable, Category = "Terrain")
+	void Invalidate();
+
+	const FDroneHeightfieldCache& GetCache() const { return Cache; }
+
+	/** Distance between height samples; features smaller than this are smoothed over */
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain")
+	float SampleSpacing;
+
+	/** Samples per tile edge */
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain", meta = (ClampMin = "2", ClampMax = "64"))
+	int32 TileResolution;
+
+	/** Tiles kept before the least recently used is dropped */
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain")
+	int32 MaxCachedTiles;
+
+	/** World Z range covered by the downward traces */
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain")
+	float TraceMaxZ;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain")
+	float TraceMinZ;
+
+private:
+	float TraceGround(const FVector2D& Location) const;
+	void HandleLevelChanged(ULevel* Level, UWorld* World);
+
+	FDroneHeightfieldCache Cache;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
@@ -40,6 +40,17 @@ enum class EDroneBehaviorType : uint8
 	AttackMark	UMETA(DisplayName = "Attack Mark")
 };
 
+/**
+ * Movement simulation detail, chosen from a drone's significance to players
+ */
+UENUM(BlueprintType)
+enum class EDroneMovementLOD : uint8
+{
+	Full		UMETA(DisplayName = "Full"),		// Every frame, swept collision
+	Reduced		UMETA(DisplayName = "Reduced"),	// Flight model at a lower rate, no sweeps
+	Rail		UMETA(DisplayName = "Rail")			// Coarse kinematic steps, no acceleration or collision
+};
+
 /**
  * Marked target information
  */
@@ -91,11 +102,37 @@ struct FThermalDetection
 	{}
 };
 
+/**
+ * Times on the wire are 16-bit wrapping millisecond ticks of server time
+ * The wrap period is 65.536s; receivers widen against a reference time they know to
+ * within half of that, e.g. UDroneNetClockSubsystem::GetServerTime.
+ */
+struct DRONESYSTEMPRO_API FDroneNetTime
+{
+	static constexpr double TicksPerSecond = 1000.0;
+
+	static uint16 ToTicks(float Time)
+	{
+		return static_cast<uint16>(FMath::RoundToInt64(Time * TicksPerSecond));
+	}
+
+	/** Time nearest Reference whose low tick bits are Ticks */
+	static float Expand(uint16 Ticks, float Reference)
+	{
+		const int64 ReferenceTicks = FMath::RoundToInt64(Reference * TicksPerSecond);
+		const int16 Delta = static_cast<int16>(static_cast<uint16>(Ticks - static_cast<uint16>(ReferenceTicks)));
+		return static_cast<float>((ReferenceTicks + Delta) / TicksPerSecond);
+	}
+};
+
 /**
  * Movement snapshot for client prediction
+ * Custom NetSerialize quantizes location/velocity to 0.1 units, angles to uint16
+ * and sends InputID and Timestamp as 16-bit wrapping values (see ExpandInputID
+ * and ExpandTimestamp)
  */
 USTRUCT()
-struct FDroneMovementSnapshot
+struct DRONESYSTEMPRO_API FDroneMovementSnapshot
 {
 	GENERATED_BODY()
 
@@ -114,11 +151,95 @@ struct FDroneMovementSnapshot
 	UPROPERTY()
 	uint32 InputID = 0;
 
+	/** Authoritative speed mode after InputID; the owning client reconciles its prediction against it */
+	UPROPERTY()
+	EDroneSpeedMode SpeedMode = EDroneSpeedMode::Low;
+
+	/** Authoritative vision mode after InputID */
+	UPROPERTY()
+	EDroneVisionMode VisionMode = EDroneVisionMode::Normal;
+
 	FDroneMovementSnapshot() {}
 
 	FDroneMovementSnapshot(FVector InLoc, FRotator InRot, FVector InVel, float InTime, uint32 InID)
 		: Location(InLoc), Rotation(InRot), Velocity(InVel), Timestamp(InTime), InputID(InID)
 	{}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** Bits this snapshot costs on the wire */
+	int32 GetSerializedBits() const;
+
+	/**
+	 * Recover a full server timestamp from its wrapped wire form
+	 * @param WireTimestamp	Timestamp as received
+	 * @param Reference		Current server time estimate
+	 */
+	static float ExpandTimestamp(float WireTimestamp, float Reference)
+	{
+		return FDroneNetTime::Expand(FDroneNetTime::ToTicks(WireTimestamp), Reference);
+	}
+
+	/**
+	 * Recover a full InputID from its 16-bit wire form
+	 * @param WireID	Low 16 bits received from the server
+	 * @param Reference	A nearby full ID, e.g. the next ID the client will send
+	 */
+	static uint32 ExpandInputID(uint32 WireID, uint32 Reference)
+	{
+		const int16 Delta = static_cast<int16>(static_cast<uint16>(WireID) - static_cast<uint16>(Reference));
+		return Reference + static_cast<int32>(Delta);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FDroneMovementSnapshot> : public TStructOpsTypeTraitsBase2<FDroneMovementSnapshot>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ * Health of a simulated proxy's snapshot interpolation buffer
+ */
+USTRUCT(BlueprintType)
+struct FDroneInterpolationStats
+{
+	GENERATED_BODY()
+
+	/** Snapshots currently buffered */
+	UPROPERTY(BlueprintReadOnly, Category = "Interpolation")
+	int32 BufferedSnapshots = 0;
+
+	/** Current jitter buffer delay on top of the transit time, in seconds */
+	UPROPERTY(BlueprintReadOnly, Category = "Interpolation")
+	float InterpolationDelay = 0.0f;
+
+	/** Smoothed age of snapshots on arrival by the shared server clock, in seconds */
+	UPROPERTY(BlueprintReadOnly, Category = "Interpolation")
+	float TransitTime = 0.0f;
+
+	/** Server time of the state the last sample presented */
+	UPROPERTY(BlueprintReadOnly, Category = "Interpolation")
+	float RenderTime = 0.0f;
+
+	/** Smoothed arrival jitter, in seconds */
+	UPROPERTY(BlueprintReadOnly, Category = "Interpolation")
+	float Jitter = 0.0f;
+
+	/** Samples that had to extrapolate past the newest snapshot */
+	UPROPERTY(BlueprintReadOnly, Category = "Interpolation")
+	int32 ExtrapolatedSamples = 0;
+
+	/** Samples that ran past the extrapolation limit and held position */
+	UPROPERTY(BlueprintReadOnly, Category = "Interpolation")
+	int32 StarvedSamples = 0;
+
+	/** Snapshots dropped because they arrived out of order */
+	UPROPERTY(BlueprintReadOnly, Category = "Interpolation")
+	int32 LateSnapshots = 0;
 };
 
 /**
@@ -141,10 +262,92 @@ struct FDroneInputState
 	UPROPERTY()
 	uint32 InputID = 0;
 
+	/** Server time (UDroneNetClockSubsystem) the input was sampled at */
 	UPROPERTY()
 	float Timestamp = 0.0f;
 
+	/** Speed mode the client predicted for this input */
+	UPROPERTY()
+	EDroneSpeedMode SpeedMode = EDroneSpeedMode::Low;
+
+	/** Vision mode the client predicted for this input */
+	UPROPERTY()
+	EDroneVisionMode VisionMode = EDroneVisionMode::Normal;
+
 	FDroneInputState() {}
+
+	/**
+	 * Write/read the quantized wire form (InputID and Timestamp are not included)
+	 * Movement axes use int8, look axes int16 at 1/256, DeltaTime uint16 at 0.1ms,
+	 * speed and vision mode 3 bits together
+	 */
+	void SerializeQuantized(FArchive& Ar);
+
+	/** Round values to their wire precision so client prediction matches the server */
+	void Quantize();
+};
+
+/**
+ * Unreliable, redundant batch of the most recent client inputs
+ * Inputs are consecutive and end at the newest InputID; the server dedupes by ID,
+ * so losing any single packet costs nothing while redundancy covers the gap
+ */
+USTRUCT()
+struct DRONESYSTEMPRO_API FDroneInputPacket
+{
+	GENERATED_BODY()
+
+	static constexpr int32 MaxInputs = 16;
+
+	/** Oldest first */
+	UPROPERTY()
+	TArray<FDroneInputState> Inputs;
+
+	/** Clock sync ping: the client's local time in wire ticks, echoed back in FDroneClockPong */
+	UPROPERTY()
+	bool bHasClockPing = false;
+
+	UPROPERTY()
+	uint16 ClockPingTicks = 0;
+
+	/**
+	 * Only the newest input's timestamp travels, as wire ticks; older ones are derived
+	 * from the inputs' delta times. Until widened, timestamps hold the wrapped value.
+	 */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** Amount to add to every received timestamp to widen it against the receiver's server time */
+	float GetTimestampCorrection(float Reference) const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FDroneInputPacket> : public TStructOpsTypeTraitsBase2<FDroneInputPacket>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ * Server echo of a clock sync ping, replicated to the owning client only
+ */
+USTRUCT()
+struct DRONESYSTEMPRO_API FDroneClockPong
+{
+	GENERATED_BODY()
+
+	/** Client local time of the ping, as sent */
+	UPROPERTY()
+	uint16 ClientTicks = 0;
+
+	/** Server time when the echo was replicated */
+	UPROPERTY()
+	float ServerSendTime = 0.0f;
+
+	/** Time between the ping arriving and the echo leaving, in wire ticks */
+	UPROPERTY()
+	uint16 ServerHoldTicks = 0;
 };
 
 /**
@@ -208,6 +411,18 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement")
 	float MaxRollAngle = 45.0f;
 
+	/** Acceleration per unit of wind velocity (1/s); 0 ignores wind */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement")
+	float WindResponse = 1.0f;
+
+	/** Drones with obstacle avoidance steer away from baked geometry closer than this; 0 disables */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (ClampMin = "0.0"))
+	float ObstacleAvoidanceDistance = 300.0f;
+
+	/** Outward acceleration at contact, easing to zero at ObstacleAvoidanceDistance */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (ClampMin = "0.0"))
+	float ObstacleAvoidanceAcceleration = 1500.0f;
+
 	// Battery
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battery")
 	float MaxBattery = 100.0f;
@@ -275,6 +490,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior")
 	float PatrolRadius = 1000.0f;
 
+	/** Height above terrain held while patrolling; 0 flies at the patrol points' own heights */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior", meta = (ClampMin = "0.0"))
+	float PatrolAltitude = 0.0f;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior")
 	float FollowDistance = 500.0f;
 
@@ -52,6 +52,7 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Utility")
 	FVector GetVelocity() const;
 
+	/** Height above the ground from the shared terrain cache; world Z over empty space */
 	UFUNCTION(BlueprintPure, Category = "Utility")
 	float GetAltitude() const;
 
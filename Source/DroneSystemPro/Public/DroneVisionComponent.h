@@ -29,9 +29,13 @@ protected:
 
 public:
 	// Vision mode control
+	/** On a predicting owner the change applies at once and rides in the drone's input stream */
 	UFUNCTION(BlueprintCallable, Category = "Vision")
 	void SetVisionMode(EDroneVisionMode NewMode);
 
+	/** Apply a mode locally without a server request; used by client prediction and its rollback */
+	void SetPredictedVisionMode(EDroneVisionMode NewMode);
+
 	UFUNCTION(BlueprintCallable, Category = "Vision")
 	void CycleVisionMode();
 
@@ -56,6 +60,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Vision")
 	void SetJammingIntensity(float Intensity);
 
+	/** Scale thermal scan rate and detection count (0-1), set by UDroneReplicationComponent under a bandwidth budget */
+	void SetThermalDetail(float Detail);
+
+	float GetThermalDetail() const { return ThermalDetail; }
+
 	// Events
 	UPROPERTY(BlueprintAssignable, Category = "Vision")
 	FOnVisionModeChanged OnVisionModeChanged;
@@ -72,6 +81,7 @@ protected:
 	void Multicast_SetVisionMode(EDroneVisionMode NewMode);
 
 	// Replication
+	/** Skips the owner, which predicts it; see IsPredictedLocally */
 	UPROPERTY(ReplicatedUsing=OnRep_VisionMode)
 	EDroneVisionMode CurrentVisionMode;
 
@@ -95,10 +105,20 @@ protected:
 	UPROPERTY()
 	float ScanInterval;
 
+	/** Detections kept at the lowest thermal detail, hottest first; full detail keeps all */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Configuration", meta = (ClampMin = "1"))
+	int32 MaxThermalDetections;
+
+	UPROPERTY()
+	float ThermalDetail;
+
 private:
 	void PerformThermalDetection();
 	float CalculateHeatSignature(AActor* Actor) const;
 	bool IsActorInRange(AActor* Actor, float Range) const;
 	void NotifyBatteryComponent(EDroneVisionMode Mode);
 	void ApplyVisionPostProcess();
+
+	/** True on the owning client of a drone whose movement component sends this mode with its inputs */
+	bool IsPredictedLocally() const;
 };
@@ -0,0 +1,102 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DroneWindSubsystem.generated.h"
+
+class ADroneWindVolume;
+
+/**
+ * Per-drone copy of the eight grid nodes around its current cell
+ * Sampling inside the same cell is a trilinear blend with no map lookups.
+ */
+struct DRONESYSTEMPRO_API FDroneWindSampleCache
+{
+	FIntVector Cell = FIntVector(MAX_int32);
+	uint32 Version = 0;
+	FVector3f Corners[8];
+	bool bCalm = true;
+
+	void Invalidate() { Version = 0; }
+};
+
+/**
+ * Sparse grid of wind velocities at node positions spaced CellSize apart
+ * Only nodes touched by a wind volume are stored; everything else is calm.
+ */
+class DRONESYSTEMPRO_API FDroneWindGrid
+{
+public:
+	explicit FDroneWindGrid(float InCellSize = 1000.0f);
+
+	/** Clear all nodes; existing sample caches become stale */
+	void Reset(float InCellSize);
+
+	/** Accumulate wind at a node */
+	void AddWind(const FIntVector& Node, const FVector& Wind);
+
+	/** Trilinear wind at Location, refreshing Cache only when the cell changes */
+	FVector Sample(const FVector& Location, FDroneWindSampleCache& Cache) const;
+
+	FVector GetNodeLocation(const FIntVector& Node) const { return FVector(Node) * CellSize; }
+	FIntVector GetCell(const FVector& Location) const;
+
+	int32 GetNumNodes() const { return Nodes.Num(); }
+	float GetCellSize() const { return CellSize; }
+	uint32 GetVersion() const { return Version; }
+
+private:
+	TMap<FIntVector, FVector3f> Nodes;
+	float CellSize;
+
+	/** Bumped on every change so caches can detect a rebake */
+	uint32 Version;
+};
+
+/**
+ * Owns the baked wind field for a world
+ * Wind volumes register at BeginPlay; the grid is rebaked lazily on the next sample
+ * after any volume changes, so drones never run per-frame volume overlap queries.
+ */
+UCLASS(Config = Game)
+class DRONESYSTEMPRO_API UDroneWindSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UDroneWindSubsystem();
+
+	virtual void Deinitialize() override;
+
+	void RegisterVolume(ADroneWindVolume* Volume);
+	void UnregisterVolume(ADroneWindVolume* Volume);
+
+	/** Request a rebake before the next sample */
+	void MarkDirty() { bDirty = true; }
+
+	/** Wind velocity at Location using the caller's cell cache */
+	FVector SampleWind(const FVector& Location, FDroneWindSampleCache& Cache);
+
+	/** Uncached convenience query */
+	UFUNCTION(BlueprintCallable, Category = "Wind")
+	FVector GetWindAt(FVector Location);
+
+	const FDroneWindGrid& GetGrid() const { return Grid; }
+
+	/** Node spacing of the baked grid; wind varies linearly between nodes */
+	UPROPERTY(Config, EditAnywhere, Category = "Wind")
+	float CellSize;
+
+	/** Volumes needing more nodes than this are skipped with a warning; raise CellSize instead */
+	UPROPERTY(Config, EditAnywhere, Category = "Wind")
+	int32 MaxNodesPerVolume;
+
+private:
+	void Rebake();
+
+	TArray<TWeakObjectPtr<ADroneWindVolume>> Volumes;
+	FDroneWindGrid Grid;
+	bool bDirty;
+};
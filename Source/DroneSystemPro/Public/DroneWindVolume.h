@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "DroneWindVolume.generated.h"
+
+class UBoxComponent;
+class UArrowComponent;
+
+/**
+ * Placeable box of wind blowing along the actor's forward axis
+ * Volumes are baked into the UDroneWindSubsystem grid at BeginPlay; overlapping
+ * volumes add up. Drones never query volumes directly.
+ */
+UCLASS(Blueprintable)
+class DRONESYSTEMPRO_API ADroneWindVolume : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADroneWindVolume();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	/** Wind velocity this volume contributes at Location, including edge falloff */
+	FVector GetWindAt(const FVector& Location) const;
+
+	/** World space box the volume influences */
+	FBox GetInfluenceBounds() const;
+
+	UFUNCTION(BlueprintPure, Category = "Wind")
+	FVector GetWindVelocity() const { return GetActorForwardVector() * WindSpeed; }
+
+	/** Change strength at runtime; the wind grid is rebaked */
+	UFUNCTION(BlueprintCallable, Category = "Wind")
+	void SetWindSpeed(float NewWindSpeed);
+
+protected:
+	// Components
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UBoxComponent* WindBounds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UArrowComponent* WindDirection;
+
+	// Configuration
+	/** Air speed along the forward axis, in units per second */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind")
+	float WindSpeed;
+
+	/** Distance inside the box over which wind fades in from its edges */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind", meta = (ClampMin = "0.0"))
+	float FalloffDistance;
+};
@@ -68,8 +68,9 @@ public:
 
 protected:
 	// Network RPCs
+	/** Range is checked with both actors rewound to the client's view time */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_StartHack(AActor* Target, float Duration);
+	void Server_StartHack(AActor* Target, float Duration, float ClientTime);
 
 	UFUNCTION(Server, Reliable, WithValidation)
 	void Server_CancelHack();
@@ -99,7 +100,8 @@ protected:
 
 private:
 	void ProcessHacking(float DeltaTime);
-	bool ValidateHackTarget(AActor* Target) const;
+	bool ValidateHackTarget(AActor* Target, float Time) const;
+	void BeginSession(AActor* Target, float Duration);
 	void CompleteHack();
 	void FailHack();
 };